@@ -11,6 +11,7 @@
 #include <vector>
 
 #include "commander/commander.h"
+#include "config/commandLine.h"
 #include "config/commandLineOptions.h"
 #include "config/config.h"
 #include "config/configFileSearcher.h"
@@ -19,12 +20,17 @@
 #include "config/optionDescriptions.h"
 #include "config/pathManipulation.h"
 #include "config/pattern.h"
+#include "config/settingsCache.h"
 #include "config/settingsNode.h"
 #include "config/variablesMap.h"
+#include "core/durations.h"
 #include "core/executorInterface.h"
 #include "core/immediateExecutor.h"
+#include "core/parallelExecutor.h"
 #include "core/posixShell.h"
 #include "core/reportingExecutor.h"
+#include "core/sharding.h"
+#include "core/spawnShell.h"
 #include "core/task.h"
 #include "log/assertions.h"
 #include "log/log.h"
@@ -57,6 +63,7 @@ using execHelper::config::Args;
 using execHelper::config::AUTO_COMPLETE_KEY;
 using execHelper::config::AutoCompleteOption_t;
 using execHelper::config::COMMAND_KEY;
+using execHelper::config::CommandLine;
 using execHelper::config::CommandCollection;
 using execHelper::config::ConfigFileSearcher;
 using execHelper::config::DRY_RUN_KEY;
@@ -65,17 +72,24 @@ using execHelper::config::EnvironmentCollection;
 using execHelper::config::FleetingOptions;
 using execHelper::config::FleetingOptionsInterface;
 using execHelper::config::getAllParentDirectories;
+using execHelper::config::getCacheDirectory;
+using execHelper::config::getCompletionIndexFile;
 using execHelper::config::getHomeDirectory;
+using execHelper::config::getSettingsCacheFile;
 using execHelper::config::HELP_OPTION_KEY;
 using execHelper::config::HelpOption_t;
 using execHelper::config::JOBS_KEY;
 using execHelper::config::JobsOption_t;
 using execHelper::config::KEEP_GOING_KEY;
 using execHelper::config::KeepGoingOption_t;
+using execHelper::config::POSIX_SPAWN_KEY;
+using execHelper::config::PosixSpawnOption_t;
 using execHelper::config::LIST_PLUGINS_KEY;
 using execHelper::config::ListPluginsOption_t;
 using execHelper::config::LOG_LEVEL_KEY;
 using execHelper::config::LogLevelOption_t;
+using execHelper::config::NO_SETTINGS_CACHE_KEY;
+using execHelper::config::NoSettingsCacheOption_t;
 using execHelper::config::Option;
 using execHelper::config::OptionDescriptions;
 using execHelper::config::parseSettingsFile;
@@ -84,7 +98,14 @@ using execHelper::config::Paths;
 using execHelper::config::Patterns;
 using execHelper::config::PatternSettingsPair;
 using execHelper::config::PatternValues;
+using execHelper::config::readCompletionIndex;
 using execHelper::config::SETTINGS_FILE_KEY;
+using execHelper::config::SHARD_DURATIONS_KEY;
+using execHelper::config::SHARD_DURATIONS_OUT_KEY;
+using execHelper::config::SHARD_KEY;
+using execHelper::config::ShardDurationsOption_t;
+using execHelper::config::ShardDurationsOutOption_t;
+using execHelper::config::ShardOption_t;
 using execHelper::config::SettingsFileOption_t;
 using execHelper::config::SettingsNode;
 using execHelper::config::SettingsValues;
@@ -93,19 +114,28 @@ using execHelper::config::VERBOSE_KEY;
 using execHelper::config::VerboseOption_t;
 using execHelper::config::VERSION_KEY;
 using execHelper::config::VersionOption_t;
+using execHelper::config::writeCompletionIndex;
+using execHelper::core::DurationRecordingShell;
+using execHelper::core::Durations;
 using execHelper::core::ExecutorInterface;
 using execHelper::core::ImmediateExecutor;
+using execHelper::core::ParallelExecutor;
 using execHelper::core::PosixShell;
+using execHelper::core::InvalidShardError;
+using execHelper::core::parseShard;
+using execHelper::core::readDurations;
 using execHelper::core::ReportingExecutor;
+using execHelper::core::Shard;
+using execHelper::core::ShardedExecutor;
 using execHelper::core::Shell;
+using execHelper::core::SpawnShell;
 using execHelper::core::Task;
+using execHelper::core::writeDurations;
 using execHelper::log::LogLevel;
 using execHelper::plugins::discoverPlugins;
 using execHelper::plugins::discoverPluginSummaries;
 using execHelper::plugins::Plugins;
 using execHelper::plugins::PluginSummaries;
-using execHelper::plugins::makePatternPermutator;
-using execHelper::plugins::replacePatternCombinations;
 
 namespace filesystem = std::filesystem;
 
@@ -194,23 +224,35 @@ getAdditionalSearchPaths(const FleetingOptionsInterface& fleetingOptions,
                          const Path& basePath) noexcept {
     constexpr std::string_view configKey{"additional-search-paths"};
     Paths pluginSearchPath{PLUGINS_INSTALL_PATH};
-    if(settings.contains(string(configKey))) {
+    if(settings.contains(configKey)) {
         pluginSearchPath = addAdditionalSearchPaths(
-            pluginSearchPath,
-            settings.get<vector<string>>(string(configKey), {}), basePath);
+            pluginSearchPath, settings.get<vector<string>>(configKey, {}),
+            basePath);
     }
     return addAdditionalSearchPaths(
         pluginSearchPath, fleetingOptions.appendedSearchPaths(), basePath);
 }
 
-inline auto printAutoComplete(const std::string& /*word*/,
-                              const OptionDescriptions& options,
-                              const vector<string>& commands) noexcept -> void {
-    for(const auto& key : options.getOptionKeys()) {
-        user_feedback(key);
+inline auto getCompletions(const OptionDescriptions& options,
+                           const SettingsNode& settings,
+                           const Patterns& patterns) noexcept
+    -> vector<string> {
+    vector<string> completions(options.getOptionKeys());
+    for(const auto& command :
+        settings.get<vector<string>>("commands", vector<string>())) {
+        completions.push_back(command);
     }
-    for(const auto& command : commands) {
-        user_feedback(command);
+    for(const auto& pattern : patterns) {
+        const auto& values = pattern.getValues();
+        completions.insert(completions.end(), values.begin(), values.end());
+    }
+    return completions;
+}
+
+inline auto printAutoComplete(const vector<string>& completions) noexcept
+    -> void {
+    for(const auto& completion : completions) {
+        user_feedback(completion);
     }
 }
 
@@ -221,7 +263,7 @@ inline void printHelp(const std::string& binaryName,
     user_feedback("");
 
     user_feedback("Optional arguments:");
-    user_feedback(options.getOptionDescriptions());
+    user_feedback(options.getHelp());
 
     static const string COMMANDS_KEY("commands");
     if(settings.contains(COMMANDS_KEY)) {
@@ -263,6 +305,24 @@ inline bool verifyOptions(const FleetingOptions& options) noexcept {
     return true;
 }
 
+/**
+ * Identifies a task across runs on different machines: the root directory is
+ * usually checked out at a different location on every machine.
+ */
+inline auto getTaskKey(const Task& task, const string& rootDirectory)
+    -> string {
+    auto key = task.toString();
+    if(rootDirectory.empty()) {
+        return key;
+    }
+    const string rootPattern("{EH_ROOT_DIR}");
+    for(auto position = key.find(rootDirectory); position != string::npos;
+        position = key.find(rootDirectory, position + rootPattern.size())) {
+        key.replace(position, rootDirectory.size(), rootPattern);
+    }
+    return key;
+}
+
 inline auto getSettingsFile(const std::string& settingsFilename,
                             const EnvironmentCollection& env) -> Path {
     ConfigFileSearcher configFileSearcher(getSearchPaths(env));
@@ -274,9 +334,13 @@ inline auto getSettingsFile(const std::string& settingsFilename,
     return *settingsFile;
 }
 
-PatternSettingsPair addPatternsFromSettingsFile(const Path& settingsFile,
-                                                OptionDescriptions& options) {
-    auto patternSettingsPair = parseSettingsFile(settingsFile);
+PatternSettingsPair
+addPatternsFromSettingsFile(const Path& settingsFile,
+                            const std::optional<Path>& settingsCacheFile,
+                            OptionDescriptions& options,
+                            Paths* settingsFiles) {
+    auto patternSettingsPair = parseSettingsFile(
+        settingsFile, settingsCacheFile, VERSION, settingsFiles);
     if(!patternSettingsPair) {
         throw std::invalid_argument("Could not parse settings file '" +
                                     settingsFile.string() + "'");
@@ -315,6 +379,17 @@ inline OptionDescriptions getDefaultOptions() noexcept {
         Option<DryRunOption_t>(DRY_RUN_KEY, {"n"}, "Dry run exec-helper"));
     options.addOption(
         Option<KeepGoingOption_t>(KEEP_GOING_KEY, {"k"}, "Keep going, even when commands fail"));
+    options.addOption(Option<PosixSpawnOption_t>(
+        POSIX_SPAWN_KEY, {}, "Launch commands using posix_spawn"));
+    options.addOption(Option<ShardOption_t>(
+        SHARD_KEY, {},
+        "Only execute the tasks of shard INDEX/COUNT of this run"));
+    options.addOption(Option<ShardDurationsOption_t>(
+        SHARD_DURATIONS_KEY, {},
+        "Weigh the shards with the task durations in this file"));
+    options.addOption(Option<ShardDurationsOutOption_t>(
+        SHARD_DURATIONS_OUT_KEY, {},
+        "Record the task durations of this run in this file"));
     options.addOption(
         Option<ListPluginsOption_t>(LIST_PLUGINS_KEY, {}, "List all plugins"));
     options.addOption(Option<AppendSearchPathOption_t>(
@@ -322,6 +397,10 @@ inline OptionDescriptions getDefaultOptions() noexcept {
         "Append to plugin search path. Plugins discovered earlier in the list "
         "overwrite plugins with the same name in later ones."));
     options.addOption(settingsFileOption);
+    options.addOption(Option<NoSettingsCacheOption_t>(
+        NO_SETTINGS_CACHE_KEY, {},
+        "Do not use or update the settings cache, the completion index, the "
+        "compiled lua plugin cache or the plugin indices"));
     options.addOption(
         Option<LogLevelOption_t>(LOG_LEVEL_KEY, {"d"}, "Set the log level"));
     options.addOption(Option<AutoCompleteOption_t>(
@@ -332,12 +411,12 @@ inline OptionDescriptions getDefaultOptions() noexcept {
     return options;
 }
 
-inline VariablesMap handleConfiguration(const Args& args,
+inline VariablesMap handleConfiguration(const CommandLine& commandLine,
                                         const EnvironmentCollection& /*env*/,
                                         OptionDescriptions& options) {
     options.setPositionalArgument(commandOption);
     VariablesMap optionsMap = FleetingOptions::getDefault();
-    if(!options.getOptionsMap(optionsMap, args, false)) {
+    if(!options.getOptionsMap(optionsMap, commandLine, false)) {
         throw std::invalid_argument(
             "Could not properly parse the command line options");
     }
@@ -349,17 +428,26 @@ int execHelperMain(int argc, char** argv, char** envp) {
     const Args args(argv, argc);
     const EnvironmentCollection env = toEnvCollection(envp);
 
-    auto firstPassOptions = getDefaultOptions();
+    // The arguments are tokenized once: they are interpreted a second time
+    // after the options of the patterns in the settings file are added
+    const CommandLine commandLine(args);
+    auto optionDescriptions = getDefaultOptions();
 
     VariablesMap firstPassOptionsMap = FleetingOptions::getDefault();
-    if(!firstPassOptions.getOptionsMap(firstPassOptionsMap, args, true)) {
+    if(!optionDescriptions.getOptionsMap(firstPassOptionsMap, commandLine,
+                                         true)) {
         user_feedback_error(
             "Could not properly parse the command line options");
-        printHelp(args[0], firstPassOptions, SettingsNode("Options"));
+        printHelp(args[0], optionDescriptions, SettingsNode("Options"));
         return EXIT_FAILURE;
     }
     FleetingOptions firstPassFleetingOptions(firstPassOptionsMap);
 
+    const auto useCache = !firstPassOptionsMap.get<NoSettingsCacheOption_t>(
+        NO_SETTINGS_CACHE_KEY, false);
+    const auto cacheDirectory =
+        useCache ? getCacheDirectory(env) : std::nullopt;
+
     Path settingsFile;
     try {
 #ifdef _WIN32
@@ -375,7 +463,7 @@ int execHelperMain(int argc, char** argv, char** envp) {
         settingsFile = getSettingsFile(settingsFileValue, env);
     } catch(const runtime_error&) {
         if(firstPassFleetingOptions.getHelp()) {
-            printHelp(args[0], firstPassOptions, SettingsNode("Options"));
+            printHelp(args[0], optionDescriptions, SettingsNode("Options"));
             return EXIT_SUCCESS;
         }
 
@@ -388,25 +476,45 @@ int execHelperMain(int argc, char** argv, char** envp) {
             auto pluginSearchPath = getAdditionalSearchPaths(
                 firstPassFleetingOptions, SettingsNode("error"),
                 filesystem::current_path());
-            auto summaries = discoverPluginSummaries(pluginSearchPath);
+            auto summaries = discoverPluginSummaries(pluginSearchPath,
+                                                     cacheDirectory, VERSION);
             printPlugins(summaries);
             return EXIT_SUCCESS;
         }
 
         if(firstPassFleetingOptions.getAutoComplete()) {
-            printAutoComplete(*(firstPassFleetingOptions.getAutoComplete()),
-                              firstPassOptions, {});
+            printAutoComplete(optionDescriptions.getOptionKeys());
             return EXIT_SUCCESS;
         }
 
         user_feedback_error("Could not find an exec-helper settings file");
-        printHelp(args[0], firstPassOptions, SettingsNode("Options"));
+        printHelp(args[0], optionDescriptions, SettingsNode("Options"));
         return EXIT_FAILURE;
     }
 
-    auto optionDescriptions = getDefaultOptions();
-    auto patternSettingsPair =
-        addPatternsFromSettingsFile(settingsFile, optionDescriptions);
+    const auto settingsCacheFile =
+        useCache ? getSettingsCacheFile(settingsFile, env) : std::nullopt;
+
+    // Answer completion requests without parsing any settings or discovering
+    // any plugins if the settings files did not change since the last one
+    const auto completionIndexFile =
+        useCache && firstPassFleetingOptions.getAutoComplete() &&
+                !firstPassFleetingOptions.getHelp() &&
+                !firstPassFleetingOptions.getVersion() &&
+                !firstPassFleetingOptions.listPlugins()
+            ? getCompletionIndexFile(settingsFile, env)
+            : std::nullopt;
+    if(completionIndexFile) {
+        if(auto completions =
+               readCompletionIndex(*completionIndexFile, VERSION)) {
+            printAutoComplete(*completions);
+            return EXIT_SUCCESS;
+        }
+    }
+
+    Paths settingsFiles;
+    auto patternSettingsPair = addPatternsFromSettingsFile(
+        settingsFile, settingsCacheFile, optionDescriptions, &settingsFiles);
 
     auto patterns = patternSettingsPair.first;
     auto settings = patternSettingsPair.second;
@@ -414,7 +522,7 @@ int execHelperMain(int argc, char** argv, char** envp) {
     VariablesMap optionsMap("options");
 
     try {
-        optionsMap = handleConfiguration(args, env, optionDescriptions);
+        optionsMap = handleConfiguration(commandLine, env, optionDescriptions);
     } catch(const std::invalid_argument&) {
         user_feedback_error(
             "Could not properly parse the command line options");
@@ -447,23 +555,40 @@ int execHelperMain(int argc, char** argv, char** envp) {
         getAdditionalSearchPaths(fleetingOptions, settings, basePath);
 
     if(fleetingOptions.listPlugins()) {
-        auto summaries = discoverPluginSummaries(pluginSearchPath);
+        auto summaries =
+            discoverPluginSummaries(pluginSearchPath, cacheDirectory, VERSION);
         printPlugins(summaries);
         return EXIT_SUCCESS;
     }
 
-    auto plugins = discoverPlugins(pluginSearchPath);
-    if(firstPassFleetingOptions.getAutoComplete()) {
-        vector<string> commands = settings.get<vector<string>>("commands", {});
-        printAutoComplete(*(fleetingOptions.getAutoComplete()),
-                          optionDescriptions, move(commands));
+    if(fleetingOptions.getAutoComplete()) {
+        const auto completions =
+            getCompletions(optionDescriptions, settings, patterns);
+        if(completionIndexFile &&
+           !writeCompletionIndex(*completionIndexFile, settingsFiles,
+                                 completions, VERSION)) {
+            LOG(debug) << "Could not write the completion index";
+        }
+        printAutoComplete(completions);
         return EXIT_SUCCESS;
     }
 
+    auto plugins = discoverPlugins(pluginSearchPath, cacheDirectory, VERSION);
+
     if(!verifyOptions(fleetingOptions)) {
         return EXIT_FAILURE;
     }
 
+    optional<Shard> shard;
+    if(fleetingOptions.getShard()) {
+        try {
+            shard = parseShard(*fleetingOptions.getShard());
+        } catch(const InvalidShardError& e) {
+            user_feedback_error(e.what());
+            return EXIT_FAILURE;
+        }
+    }
+
     for(auto& pattern : patterns) {
         const auto longOption = pattern.getLongOption();
         if(longOption && optionsMap.contains(longOption.value())) {
@@ -475,11 +600,40 @@ int execHelperMain(int argc, char** argv, char** envp) {
         }
     }
 
-    PosixShell shell;
+    std::unique_ptr<PosixShell> shellPtr;
+    if(fleetingOptions.getPosixSpawn()) {
+        shellPtr = make_unique<SpawnShell>();
+    } else {
+        shellPtr = make_unique<PosixShell>();
+    }
+    auto taskKey = [rootDirectory = basePath.string()](const Task& task) {
+        return getTaskKey(task, rootDirectory);
+    };
+    // The durations are never recorded to the file they are read from: every
+    // shard of a run must read the same durations
+    Durations durations;
+    if(fleetingOptions.getShardDurations()) {
+        durations = readDurations(*fleetingOptions.getShardDurations());
+    }
+    const auto& durationsOutFile = fleetingOptions.getShardDurationsOut();
+    optional<DurationRecordingShell> recordingShell;
+    if(durationsOutFile && !fleetingOptions.getDryRun()) {
+        recordingShell.emplace(*shellPtr, taskKey);
+    }
+    Shell& shell = recordingShell ? static_cast<Shell&>(*recordingShell)
+                                  : *shellPtr;
     std::unique_ptr<ExecutorInterface> executor;
     auto lastReturnCode = EXIT_SUCCESS;
     if(fleetingOptions.getDryRun()) {
         executor.reset(new ReportingExecutor());
+    } else if(fleetingOptions.getJobs() > 1U) {
+        executor = make_unique<ParallelExecutor>(
+            shell,
+            [&lastReturnCode](Shell::ShellReturnCode returnCode) {
+                lastReturnCode = returnCode;
+                user_feedback_error("Error executing command!");
+            },
+            fleetingOptions.getJobs(), fleetingOptions.getKeepGoing());
     } else if(fleetingOptions.getKeepGoing()) {
         executor = make_unique<ImmediateExecutor>(shell,  [&lastReturnCode](Shell::ShellReturnCode returnCode) {
             lastReturnCode = returnCode;
@@ -493,21 +647,29 @@ int execHelperMain(int argc, char** argv, char** envp) {
         });
     }
 
+    std::unique_ptr<ExecutorInterface> shardedExecutor;
     Commander commander;
     try {
-        auto tasks = commander.run(fleetingOptions, settings, patterns,
-                     settingsFile.parent_path(), move(env), move(plugins), settingsFile.parent_path());
-
-        for(const auto& task : tasks) {
-            for(const auto& combination : makePatternPermutator(task.getPatterns())) {
-                Task newTask = replacePatternCombinations(task, combination);
-                executor->execute(newTask);
-            }
+        if(shard) {
+            LOG(debug) << "Executing shard " << shard->index + 1U << " of "
+                       << shard->count;
+            shardedExecutor = make_unique<ShardedExecutor>(*executor, *shard,
+                                                           durations, taskKey);
         }
+        commander.execute(fleetingOptions, settings, patterns,
+                     settingsFile.parent_path(), move(env), move(plugins), settingsFile.parent_path(), shardedExecutor ? *shardedExecutor : *executor);
     } catch(const exception& e) {
+        executor.reset();
         user_feedback_error("Error executing commands: " << e.what());
         return EXIT_FAILURE;
     }
+    executor.reset(); // Wait for all scheduled tasks to finish
+
+    if(recordingShell &&
+       !writeDurations(*durationsOutFile, recordingShell->getDurations())) {
+        user_feedback_error("Could not write the task durations to '"
+                            << *durationsOutFile << "'");
+    }
     return lastReturnCode;
 }
 
@@ -1,6 +1,7 @@
 #ifndef __COMMANDER_H__
 #define __COMMANDER_H__
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -8,7 +9,7 @@
 #include "config/environment.h"
 #include "config/path.h"
 #include "config/pattern.h"
-#include "core/task.h"
+#include "core/taskGraph.h"
 #include "plugins/plugin.h"
 
 namespace execHelper {
@@ -18,8 +19,9 @@ class SettingsNode;
 } // namespace config
 
 namespace core {
+class ExecutorInterface;
 class Options;
-}
+} // namespace core
 } // namespace execHelper
 
 namespace execHelper {
@@ -40,15 +42,58 @@ class Commander {
      * \param[in] env       The environment to apply the plugins in
      * \param[in] plugins   A map of plugin prototypes where each key is associated with a certain plugin
      * \param[in] rootDirectory     The directory to use as the root of the project
-     * \returns True    If the command was run successfully
-     *          False   Otherwise
+     * \returns The resolved tasks, grouped per command and ordered by the
+     * depends-on relations between the commands
+     * \throws core::CyclicDependencyError The depends-on relations between the
+     * commands form a cycle
      */
     auto run(const config::FleetingOptionsInterface& fleetingOptions,
              config::SettingsNode settings, config::Patterns patterns,
              const config::Path& workingDirectory,
              const config::EnvironmentCollection& env,
              plugins::Plugins&& plugins, const config::Path& rootDirectory)
-        -> core::Tasks;
+        -> core::TaskGraph;
+
+    /**
+     * Resolves the commands and executes the resulting tasks. Every resolved
+     * task is expanded for all its pattern combinations and handed over to
+     * the executor as soon as it is resolved, so execution starts before all
+     * commands are resolved. The tasks of one command are executed in the
+     * order in which they are resolved. The commands of a stage are only
+     * resolved after the executor finished the tasks of the commands they
+     * depend on.
+     *
+     * \param[in] fleetingOptions    The fleeting options
+     * \param[in] settings           The settings node context to use
+     * \param[in] patterns           The patterns context to use
+     * \param[in] workingDirectory   The working directory for the commander
+     * \param[in] env       The environment to apply the plugins in
+     * \param[in] plugins   A map of plugin prototypes where each key is associated with a certain plugin
+     * \param[in] rootDirectory     The directory to use as the root of the project
+     * \param[in] executor  The executor to execute the resolved tasks with
+     * \throws core::CyclicDependencyError The depends-on relations between the
+     * commands form a cycle. No task is executed in this case.
+     */
+    void execute(const config::FleetingOptionsInterface& fleetingOptions,
+                 config::SettingsNode settings, config::Patterns patterns,
+                 const config::Path& workingDirectory,
+                 const config::EnvironmentCollection& env,
+                 plugins::Plugins&& plugins, const config::Path& rootDirectory,
+                 core::ExecutorInterface& executor);
+
+  private:
+    static auto resolve(const config::FleetingOptionsInterface& fleetingOptions,
+                        const config::SettingsNode& settings,
+                        config::Patterns patterns,
+                        const config::Path& workingDirectory,
+                        const config::EnvironmentCollection& env,
+                        const plugins::Plugins& plugins,
+                        const config::Path& rootDirectory,
+                        const plugins::TaskSink& sink,
+                        const std::function<void(core::TaskGraph::Node)>&
+                            resolving,
+                        const std::function<void()>& stageResolved)
+        -> core::TaskGraph;
 };
 } // namespace commander
 } // namespace execHelper
@@ -2,18 +2,27 @@
 
 #include <filesystem>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string_view>
 
 #include "config/fleetingOptionsInterface.h"
 #include "config/pattern.h"
 #include "config/patternsHandler.h"
 #include "config/settingsNode.h"
 #include "config/variablesMap.h"
+#include "core/executorInterface.h"
 #include "core/task.h"
+#include "core/taskGraph.h"
 #include "plugins/executePlugin.h"
 #include "plugins/executionContext.h"
+#include "plugins/pluginUtils.h"
 
 #include "logger.h"
 
+using execHelper::config::Command;
+using execHelper::config::CommandCollection;
 using execHelper::config::EnvironmentCollection;
 using execHelper::config::FleetingOptionsInterface;
 using execHelper::config::Path;
@@ -22,14 +31,69 @@ using execHelper::config::Patterns;
 using execHelper::config::PatternsHandler;
 using execHelper::config::SettingsNode;
 using execHelper::config::VariablesMap;
+using execHelper::core::ExecutorInterface;
 using execHelper::core::Task;
-using execHelper::core::Tasks;
+using execHelper::core::TaskGraph;
 using execHelper::plugins::ExecutionContext;
+using execHelper::plugins::makePatternPermutator;
 using execHelper::plugins::Plugins;
+using execHelper::plugins::replacePatternCombinations;
+using execHelper::plugins::TaskSink;
 
 namespace filesystem = std::filesystem;
 
 namespace {
+using namespace std::literals;
+constexpr auto dependsOnKey = "depends-on"sv;
+
+using CommandNodes = std::map<Command, TaskGraph::Node>;
+
+auto addCommand(const Command& command, const SettingsNode& settings,
+                TaskGraph* graph, CommandNodes* nodes) -> TaskGraph::Node {
+    auto existing = nodes->find(command);
+    if(existing != nodes->end()) {
+        return existing->second;
+    }
+
+    // Register the node before visiting its dependencies, so cycles terminate
+    auto node = graph->addNode(command);
+    nodes->emplace(command, node);
+    for(const auto& dependency :
+        settings.get<CommandCollection>({dependsOnKey, command}, {})) {
+        graph->addDependency(node,
+                             addCommand(dependency, settings, graph, nodes));
+    }
+    return node;
+}
+
+/**
+ * Builds the graph of the given commands and all the commands they depend on
+ * (in)directly. Without any depends-on relations, every given command depends
+ * on the one given before it, so the commands are executed one after the other
+ * in the given order.
+ */
+auto getCommandGraph(const CommandCollection& commands,
+                     const SettingsNode& settings) -> TaskGraph {
+    TaskGraph graph;
+    if(!settings.contains(dependsOnKey)) {
+        std::optional<TaskGraph::Node> previous;
+        for(const auto& command : commands) {
+            auto node = graph.addNode(command);
+            if(previous) {
+                graph.addDependency(node, *previous);
+            }
+            previous = node;
+        }
+        return graph;
+    }
+
+    CommandNodes nodes;
+    for(const auto& command : commands) {
+        addCommand(command, settings, &graph, &nodes);
+    }
+    return graph;
+}
+
 inline auto addPredefinedPatterns(Patterns patterns, const Path& rootDirectory)
     -> Patterns {
     using namespace std::string_literals;
@@ -50,18 +114,70 @@ auto Commander::run(const FleetingOptionsInterface& fleetingOptions,
                     SettingsNode settings, Patterns patterns,
                     const Path& workingDirectory,
                     const EnvironmentCollection& env, Plugins&& plugins,
-                    const Path& rootDirectory) -> Tasks {
+                    const Path& rootDirectory) -> TaskGraph {
+    return resolve(fleetingOptions, settings, move(patterns), workingDirectory,
+                   env, plugins, rootDirectory, TaskSink(),
+                   [](TaskGraph::Node /*node*/) {}, []() {});
+}
+
+void Commander::execute(const FleetingOptionsInterface& fleetingOptions,
+                        SettingsNode settings, Patterns patterns,
+                        const Path& workingDirectory,
+                        const EnvironmentCollection& env, Plugins&& plugins,
+                        const Path& rootDirectory, ExecutorInterface& executor) {
+    // The tasks of a command are executed in the order they are resolved in
+    TaskGraph::Node command = 0U;
+    auto sink = [&executor, &command](const Task& task) {
+        for(const auto& combination :
+            makePatternPermutator(task.getPatterns())) {
+            executor.executeInSequence(
+                replacePatternCombinations(task, combination), command);
+        }
+    };
+    auto graph = resolve(fleetingOptions, settings, move(patterns),
+                         workingDirectory, env, plugins, rootDirectory, sink,
+                         [&command](TaskGraph::Node node) { command = node; },
+                         [&executor]() {
+                             executor.wait(); // Commands of later stages
+                                              // depend on this stage
+                         });
+    LOG(debug) << "Executed the tasks of " << graph.size() << " commands";
+}
+
+auto Commander::resolve(const FleetingOptionsInterface& fleetingOptions,
+                        const SettingsNode& settings, Patterns patterns,
+                        const Path& workingDirectory,
+                        const EnvironmentCollection& env,
+                        const Plugins& plugins, const Path& rootDirectory,
+                        const TaskSink& sink,
+                        const std::function<void(TaskGraph::Node)>& resolving,
+                        const std::function<void()>& stageResolved)
+    -> TaskGraph {
     patterns = addPredefinedPatterns(patterns, rootDirectory);
     PatternsHandler handler(move(patterns));
 
-    ExecutionContext context(fleetingOptions, settings, handler, plugins);
+    ExecutionContext context(fleetingOptions, settings, handler, plugins,
+                             sink);
 
-    Task task({}, env, workingDirectory);
+    Task task({}, EnvironmentCollection(), workingDirectory);
+    task.setInheritedEnvironment(std::make_shared<const EnvironmentCollection>(
+        env)); // Shared by all derived tasks rather than copied into each of them
 
     auto commands = fleetingOptions.getCommands();
     if(commands.empty()) {
         throw std::runtime_error("You must define at least one command");
     }
-    return executeCommands(commands, task, context);
+
+    auto graph = getCommandGraph(commands, settings);
+    for(const auto& stage :
+        graph.getStages()) { // Detects cycles before resolving any command
+        for(const auto node : stage) {
+            resolving(node);
+            graph.setTasks(node, executeCommands({graph.getName(node)}, task,
+                                                 context));
+        }
+        stageResolved();
+    }
+    return graph;
 }
 } // namespace execHelper::commander
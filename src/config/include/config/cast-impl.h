@@ -1,7 +1,13 @@
 #ifndef CAST_IMPL_INCLUDE
 #define CAST_IMPL_INCLUDE
 
+#include <charconv>
 #include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <boost/lexical_cast.hpp>
@@ -12,6 +18,43 @@
 namespace execHelper {
 namespace config {
 namespace detail {
+/**
+ * Parse the given value as type T
+ *
+ * \param[in] value The value to parse. Integers may have a leading plus sign.
+ * \returns The parsed value if the complete value represents a T
+ *          std::nullopt otherwise
+ */
+template <typename T>
+inline auto parse(std::string_view value) noexcept -> std::optional<T> {
+    if constexpr(std::is_same_v<T, std::string>) {
+        return std::string(value);
+    } else if constexpr(std::is_same_v<T, char>) {
+        if(value.size() != 1U) {
+            return std::nullopt;
+        }
+        return value.front();
+    } else if constexpr(std::is_integral_v<T>) {
+        // std::from_chars only accepts a leading minus sign
+        if(value.size() > 1U && value.front() == '+' && value[1] != '-') {
+            value.remove_prefix(1U);
+        }
+        T result{};
+        const auto* end = value.data() + value.size();
+        auto [last, error] = std::from_chars(value.data(), end, result);
+        if(error != std::errc() || last != end) {
+            return std::nullopt;
+        }
+        return result;
+    } else {
+        try {
+            return boost::lexical_cast<T>(value);
+        } catch(boost::bad_lexical_cast&) {
+            return std::nullopt;
+        }
+    }
+}
+
 /**
  * \brief Partial specialization for casting the given type U to an optional of
  * type bool
@@ -45,16 +88,23 @@ template <typename U> class Cast<Path, U> {
     static std::optional<Path> cast(const U& values) noexcept;
 };
 
+/**
+ * \brief Partial specialization for casting the given type U to an optional of
+ * type string_view. The view refers to the last of the given values.
+ */
+template <typename U> class Cast<std::string_view, U> {
+  public:
+    /*! \copydoc Cast<T,U>::cast(const U& values)
+     */
+    static std::optional<std::string_view> cast(const U& values) noexcept;
+};
+
 template <typename T, typename U>
 inline std::optional<T> Cast<T, U>::cast(const U& values) noexcept {
     if(values.size() == 0U) {
         return std::nullopt;
     }
-    try {
-        return std::make_optional(boost::lexical_cast<T>(values.back()));
-    } catch(boost::bad_lexical_cast&) {
-        return std::nullopt;
-    }
+    return parse<T>(values.back());
 }
 
 template <typename U>
@@ -72,11 +122,24 @@ Cast<std::vector<T>, U>::cast(const U& values) noexcept {
     std::vector<T> result;
     result.reserve(values.size());
     for(const auto& value : values) {
-        result.push_back(boost::lexical_cast<T>(value));
+        auto element = parse<T>(value);
+        if(!element) {
+            return std::nullopt;
+        }
+        result.push_back(std::move(*element));
     }
     return result;
 }
 
+template <typename U>
+inline std::optional<std::string_view>
+Cast<std::string_view, U>::cast(const U& values) noexcept {
+    if(values.size() == 0U) {
+        return std::nullopt;
+    }
+    return std::string_view(values.back());
+}
+
 template <typename U>
 inline std::optional<Path> Cast<Path, U>::cast(const U& values) noexcept {
     auto stringValue = Cast<std::string, U>::cast(values);
@@ -0,0 +1,72 @@
+#ifndef COMMAND_LINE_INCLUDE
+#define COMMAND_LINE_INCLUDE
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace execHelper::config {
+using Args = std::span<const char* const>;
+
+/**
+ * \brief A command line argument, classified without knowing which options
+ * exist
+ */
+struct Token {
+    /**
+     * \brief The kinds of command line arguments
+     */
+    enum class Kind : uint8_t {
+        Long,       //!< brief A long option, e.g. --jobs or --jobs=4
+        Short,      //!< brief One or more short options, e.g. -j or -nvj4
+        Value,      //!< brief A value, belonging to an option or positional
+        Positional, //!< brief A value following the -- separator
+    };
+
+    Kind kind; //!< brief The kind of the argument
+
+    /**
+     * \brief The name of the long option, the characters of the short options
+     * or the value, without the leading dashes
+     */
+    std::string_view text;
+
+    /**
+     * \brief The value that is attached to a long option using '='
+     */
+    std::optional<std::string_view> value;
+};
+
+using Tokens = std::vector<Token>;
+
+/**
+ * \brief The command line arguments, split in tokens once so they can be
+ * interpreted multiple times as more options become known
+ */
+class CommandLine {
+  public:
+    /**
+     * Constructor
+     *
+     * \param[in] args  The command line arguments, starting with the name of
+     * the binary. The arguments must outlive this object.
+     */
+    explicit CommandLine(const Args& args) noexcept;
+
+    /**
+     * Returns the tokens of the arguments, excluding the name of the binary
+     *
+     * \returns The tokens in the order of the arguments
+     */
+    [[nodiscard]] auto getTokens() const noexcept -> const Tokens& {
+        return m_tokens;
+    }
+
+  private:
+    Tokens m_tokens;
+};
+} // namespace execHelper::config
+
+#endif /* COMMAND_LINE_INCLUDE */
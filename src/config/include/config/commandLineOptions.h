@@ -21,6 +21,18 @@ using DryRunOption_t = bool;
 const std::string KEEP_GOING_KEY{"keep-going"};
 using KeepGoingOption_t = bool;
 
+const std::string POSIX_SPAWN_KEY{"posix-spawn"};
+using PosixSpawnOption_t = bool;
+
+const std::string SHARD_KEY{"shard"};
+using ShardOption_t = std::string;
+
+const std::string SHARD_DURATIONS_KEY{"shard-durations"};
+using ShardDurationsOption_t = std::string;
+
+const std::string SHARD_DURATIONS_OUT_KEY{"shard-durations-out"};
+using ShardDurationsOutOption_t = std::string;
+
 const std::string JOBS_KEY{"jobs"};
 using JobsOption_t =
     std::string; // Must be string, since the 'auto' keyword is also supported
@@ -29,6 +41,9 @@ using Jobs_t = uint32_t;
 const std::string SETTINGS_FILE_KEY{"settings-file"};
 using SettingsFileOption_t = std::string;
 
+const std::string NO_SETTINGS_CACHE_KEY{"no-settings-cache"};
+using NoSettingsCacheOption_t = bool;
+
 const std::string COMMAND_KEY{"command"};
 using Command = std::string;
 using CommandCollection = std::vector<Command>;
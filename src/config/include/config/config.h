@@ -3,6 +3,7 @@
 
 #include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
 
 #include "path.h"
@@ -19,8 +20,54 @@ namespace execHelper {
 namespace config {
 using PatternSettingsPair = std::pair<Patterns, config::SettingsNode>;
 
+/**
+ * Parses the given settings file. The settings files listed under its include
+ * key are parsed in parallel and merged first, in the order they are listed.
+ * Relative includes are relative to the directory of the including file.
+ *
+ * \param[in] file  The settings file to parse
+ * \returns The merged patterns and settings of the settings file
+ *          std::nullopt if the settings file or any of its includes could not
+ *          be parsed
+ */
 auto parseSettingsFile(const Path& file) noexcept
     -> std::optional<PatternSettingsPair>;
+
+/**
+ * Parses the given settings file, using the given cache file to skip parsing
+ * it again if it did not change since the previous time. The cache file is
+ * (re)written if it is missing or stale. Included settings files are cached
+ * separately in the directory of the cache file, so only the files that
+ * changed are parsed again.
+ *
+ * \param[in] file  The settings file to parse
+ * \param[in] cacheFile The cache file to use. std::nullopt disables the cache.
+ * \param[in] version   The version of the binary. Caches written by another
+ * version are not used.
+ * \returns The patterns and settings of the settings file
+ *          std::nullopt if the settings file could not be parsed
+ */
+auto parseSettingsFile(const Path& file, const std::optional<Path>& cacheFile,
+                       std::string_view version) noexcept
+    -> std::optional<PatternSettingsPair>;
+
+/**
+ * Parses the given settings file like
+ * \ref parseSettingsFile(const Path&, const std::optional<Path>&,
+ * std::string_view) and returns which settings files were parsed
+ *
+ * \param[in] file  The settings file to parse
+ * \param[in] cacheFile The cache file to use. std::nullopt disables the cache.
+ * \param[in] version   The version of the binary. Caches written by another
+ * version are not used.
+ * \param[out] files    The given settings file and every settings file it
+ * (indirectly) includes are added to this
+ * \returns The patterns and settings of the settings file
+ *          std::nullopt if the settings file could not be parsed
+ */
+auto parseSettingsFile(const Path& file, const std::optional<Path>& cacheFile,
+                       std::string_view version, Paths* files) noexcept
+    -> std::optional<PatternSettingsPair>;
 } // namespace config
 } // namespace execHelper
 
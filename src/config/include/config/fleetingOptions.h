@@ -64,6 +64,8 @@ class FleetingOptions : public FleetingOptionsInterface {
     auto getVerbosity() const noexcept -> VerboseOption_t override;
     auto getDryRun() const noexcept -> DryRunOption_t override;
     auto getKeepGoing() const noexcept -> KeepGoingOption_t override;
+    [[nodiscard]] auto getPosixSpawn() const noexcept
+        -> PosixSpawnOption_t override;
     auto getJobs() const noexcept -> Jobs_t override;
     auto listPlugins() const noexcept -> ListPluginsOption_t override;
     [[nodiscard]] auto appendedSearchPaths() const noexcept
@@ -81,6 +83,15 @@ class FleetingOptions : public FleetingOptionsInterface {
     auto getAutoComplete() const noexcept
         -> const std::optional<AutoCompleteOption_t>& override;
 
+    [[nodiscard]] auto getShard() const noexcept
+        -> const std::optional<ShardOption_t>& override;
+
+    [[nodiscard]] auto getShardDurations() const noexcept
+        -> const std::optional<ShardDurationsOption_t>& override;
+
+    [[nodiscard]] auto getShardDurationsOut() const noexcept
+        -> const std::optional<ShardDurationsOutOption_t>& override;
+
     /**
      * Returns the default variables for the fleeting options
      *
@@ -94,12 +105,16 @@ class FleetingOptions : public FleetingOptionsInterface {
     const VerboseOption_t m_verbose;
     const DryRunOption_t m_dryRun;
     const KeepGoingOption_t m_keepGoing;
+    const PosixSpawnOption_t m_posixSpawn;
     Jobs_t m_jobs;
     const LogLevelOption_t m_logLevel;
     const ListPluginsOption_t m_listPlugins;
     const Paths m_appendSearchPaths;
     CommandCollection m_commands;
     const std::optional<config::AutoCompleteOption_t> m_autocomplete;
+    const std::optional<ShardOption_t> m_shard;
+    const std::optional<ShardDurationsOption_t> m_shardDurations;
+    const std::optional<ShardDurationsOutOption_t> m_shardDurationsOut;
 };
 } // namespace execHelper::config
 
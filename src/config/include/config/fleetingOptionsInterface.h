@@ -66,6 +66,15 @@ class FleetingOptionsInterface {
      */
     virtual auto getKeepGoing() const noexcept -> KeepGoingOption_t = 0;
 
+    /**
+     * Returns whether commands must be launched using posix_spawn
+     *
+     * \returns True    If posix_spawn must be used
+     *          False   Otherwise
+     */
+    [[nodiscard]] virtual auto getPosixSpawn() const noexcept
+        -> PosixSpawnOption_t = 0;
+
     /**
      * Returns the maximum number of jobs to use for a task
      *
@@ -105,6 +114,33 @@ class FleetingOptionsInterface {
     virtual auto getAutoComplete() const noexcept
         -> const std::optional<AutoCompleteOption_t>& = 0;
 
+    /**
+     * Returns the shard option value
+     *
+     * \returns string  The shard to execute, formatted as INDEX/COUNT
+     *          none    If the option is not set
+     */
+    [[nodiscard]] virtual auto getShard() const noexcept
+        -> const std::optional<ShardOption_t>& = 0;
+
+    /**
+     * Returns the shard durations option value
+     *
+     * \returns string  The file to read the task durations from
+     *          none    If the option is not set
+     */
+    [[nodiscard]] virtual auto getShardDurations() const noexcept
+        -> const std::optional<ShardDurationsOption_t>& = 0;
+
+    /**
+     * Returns the shard durations output option value
+     *
+     * \returns string  The file to record the task durations of this run to
+     *          none    If the option is not set
+     */
+    [[nodiscard]] virtual auto getShardDurationsOut() const noexcept
+        -> const std::optional<ShardDurationsOutOption_t>& = 0;
+
   protected:
     FleetingOptionsInterface() = default;
 
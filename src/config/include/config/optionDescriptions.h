@@ -1,17 +1,19 @@
 #ifndef __OPTION_DESCRIPTIONS_H__
 #define __OPTION_DESCRIPTIONS_H__
 
+#include <cstdint>
+#include <map>
 #include <memory>
 #include <optional>
-#include <span>
+#include <stdexcept>
+#include <string>
 #include <string_view>
 #include <type_traits>
 #include <vector>
 
-#include <boost/program_options.hpp>
-
 #include "log/assertions.h"
 
+#include "commandLine.h"
 #include "log/log.h"
 #include "settingsNode.h"
 #include "variablesMap.h"
@@ -19,77 +21,40 @@
 namespace execHelper::config {
 using ArgumentOption = std::string;
 using ArgumentOptions = std::vector<ArgumentOption>;
-using Args = std::span<const char* const>;
+using OptionValues = std::vector<std::string_view>;
 
 namespace detail {
 /**
- * Converts the given value to the associated settings value
- *
- * \param[in] value     The value to convert
- * \returns The converted value
- */
-template <typename T> inline auto toSetting([[maybe_unused]] T value) noexcept {
-    static_assert(std::is_void_v<T>,
-                  "T was not specialized for the correct type");
-    return SettingsValue();
-}
-
-/*! \overload toSetting<T>(T)
- */
-inline auto toSetting(bool value) noexcept {
-    if(value) {
-        return "1";
-    }
-    return "0";
-}
-
-/*! \overload toSetting<T>(T)
- */
-inline auto toSetting(const std::string& value) noexcept { return value; }
-
-/*! \overload toSetting<T>(T)
+ * \brief The number of command line values an option takes
  */
-inline auto toSetting(const std::vector<std::string>& value) noexcept {
-    return value;
-}
+enum class Arity : uint8_t {
+    None, //!< brief The option is a switch that takes no values
+    One,  //!< brief The option takes exactly one value
+    Many, //!< brief The option takes one or more values
+};
 
 /**
- * \brief Construction for getting a command line argument that fits the expected type
+ * \brief Construction for getting the number of command line values that fit
+ * the expected type
  */
 template <typename T> struct TypeValue {
-    /**
-     * Returns a program_options value that converts to the given type
-     *
-     * \returns A boost::program_options value that can contain and convert a command line argument to the given type
-     */
-    [[nodiscard]] static inline auto value() noexcept
-        -> const boost::program_options::value_semantic* {
-        return boost::program_options::value<T>();
-    }
+    static constexpr Arity arity = Arity::One; //!< brief The number of values
 };
 
 /**
- * \brief Construction for getting a command line argument that fits the expected type. Specialization for bool.
+ * \brief Construction for getting the number of command line values that fit
+ * the expected type. Specialization for bool.
  */
 template <> struct TypeValue<bool> {
-    /*! @copydoc TypeValue<T>::value()
-     */
-    [[nodiscard]] static inline auto value() noexcept
-        -> const boost::program_options::value_semantic* {
-        return boost::program_options::bool_switch();
-    }
+    static constexpr Arity arity = Arity::None; //!< brief The number of values
 };
 
 /**
- * \brief Construction for getting a command line argument that fits the expected type. Specialization for std::vector<T>.
+ * \brief Construction for getting the number of command line values that fit
+ * the expected type. Specialization for std::vector<T>.
  */
 template <typename T> struct TypeValue<std::vector<T>> {
-    /*! @copydoc TypeValue<T>()::value()
-     */
-    [[nodiscard]] static inline auto value() noexcept
-        -> boost::program_options::value_semantic* {
-        return boost::program_options::value<std::vector<T>>()->multitoken();
-    }
+    static constexpr Arity arity = Arity::Many; //!< brief The number of values
 };
 } // namespace detail
 
@@ -127,25 +92,23 @@ class OptionInterface {
         -> const std::string& = 0;
 
     /**
-     * Extract the value(s) associated with this option from the optionsMap
+     * Write the given command line values of this option to the variables map
      *
      * \param[out] variablesMap The variables map to write to
-     * \param[in] optionsMap    The options map to take the value(s) from
-     * \throws boost::bad_any_cast  If the given option value can not be parsed to the given option type
+     * \param[in] values    The values given for this option on the command
+     * line, in the order they were given
+     * \throws std::invalid_argument    If the values can not be written
      */
-    virtual void
-    toMap(config::VariablesMap& variablesMap,
-          const boost::program_options::variables_map& optionsMap) const = 0;
+    virtual void toMap(config::VariablesMap& variablesMap,
+                       const OptionValues& values) const = 0;
 
     /**
-     * Return the associated type value of this options in order to be able to
-     * properly parse it
+     * Return the number of command line values this option takes in order to
+     * be able to properly parse it
      *
-     * \returns The implementation-specific semantic to be used by the
-     * optionparser.
+     * \returns The number of values this option takes
      */
-    [[nodiscard]] virtual auto getTypeValue() const noexcept
-        -> const boost::program_options::value_semantic* = 0;
+    [[nodiscard]] virtual auto getArity() const noexcept -> detail::Arity = 0;
 
   protected:
     OptionInterface() = default;
@@ -249,19 +212,28 @@ template <typename T> class Option : public OptionInterface {
     }
 
     auto toMap(config::VariablesMap& variablesMap,
-               const boost::program_options::variables_map& optionsMap) const
-        -> void override {
-        auto value = optionsMap[m_identifyingOption].template as<T>();
-        auto settings = detail::toSetting(value);
-        if(!variablesMap.replace(m_identifyingOption, settings)) {
+               const OptionValues& values) const -> void override {
+        bool replaced = false;
+        if constexpr(detail::TypeValue<T>::arity == detail::Arity::None) {
+            replaced = variablesMap.replace(m_identifyingOption, "1");
+        } else if constexpr(detail::TypeValue<T>::arity ==
+                            detail::Arity::One) {
+            expectsMessage(!values.empty(), "An option value must be given");
+            replaced = variablesMap.replace(m_identifyingOption,
+                                            SettingsValue(values.back()));
+        } else {
+            replaced = variablesMap.replace(
+                m_identifyingOption,
+                SettingsValues(values.begin(), values.end()));
+        }
+        if(!replaced) {
             throw(std::invalid_argument(
                 std::string("Could not set ").append(m_identifyingOption)));
         }
     }
 
-    [[nodiscard]] auto getTypeValue() const noexcept
-        -> const boost::program_options::value_semantic* override {
-        return detail::TypeValue<T>::value();
+    [[nodiscard]] auto getArity() const noexcept -> detail::Arity override {
+        return detail::TypeValue<T>::arity;
     }
 
   private:
@@ -281,12 +253,12 @@ class OptionDescriptions {
     OptionDescriptions() noexcept;
 
     /**
-     * Returns the currently registered option descriptions
+     * Returns the help text that describes the currently registered options
      *
-     * \returns A collection of the registered option descriptions
+     * \returns The description of every registered option, one per line, in
+     * the order they were added
      */
-    [[nodiscard]] auto getOptionDescriptions() const noexcept
-        -> boost::program_options::options_description;
+    [[nodiscard]] auto getHelp() const noexcept -> std::string;
 
     /**
      * Add an option description
@@ -294,25 +266,7 @@ class OptionDescriptions {
      * \param[in] option        The option do add
      */
     template <typename T> void addOption(const Option<T>& option) noexcept {
-        auto id = option.getId();
-
-        m_optionKeys.emplace_back("--" + id);
-        std::string option_code(id);
-        for(const auto& argumentOption : option.getArgumentOptions()) {
-            option_code.append(",");
-            option_code.append(argumentOption);
-            if(argumentOption.size() == 1U) {
-                m_optionKeys.emplace_back("-" + argumentOption);
-            } else {
-                m_optionKeys.emplace_back("--" + argumentOption);
-            }
-        }
-
-        m_optionDescription.add_options()(option_code.c_str(),
-                                          option.getTypeValue(),
-                                          option.getExplanation().c_str());
-        m_options.emplace(std::pair<std::string, std::unique_ptr<Option<T>>>(
-            id, std::make_unique<Option<T>>(option)));
+        addOption(std::make_unique<Option<T>>(option));
     }
 
     /**
@@ -331,13 +285,31 @@ class OptionDescriptions {
      * \param[out] variablesMap  The variables map to add the values to
      * \param[in] args  A collection of input arguments
      * \param[in] allowUnregistered Whether to allow options in args that are
-     * not described in this option description \returns True    if the options
-     * map was successfully constructed False   otherwise
+     * not described in this option description
+     * \returns True    if the options map was successfully constructed
+     *          False   otherwise
      */
     [[nodiscard]] auto
     getOptionsMap(config::VariablesMap& variablesMap, const Args& args,
                   bool allowUnregistered = false) const noexcept -> bool;
 
+    /**
+     * Returns a map containing the parsed option descriptions for the given
+     * tokenized command line. The same command line can be interpreted again
+     * after more options were added.
+     *
+     * \param[out] variablesMap  The variables map to add the values to
+     * \param[in] commandLine   The tokenized command line arguments
+     * \param[in] allowUnregistered Whether to allow options in the command line
+     * that are not described in this option description
+     * \returns True    if the options map was successfully constructed
+     *          False   otherwise
+     */
+    [[nodiscard]] auto getOptionsMap(config::VariablesMap& variablesMap,
+                                     const CommandLine& commandLine,
+                                     bool allowUnregistered = false) const
+        noexcept -> bool;
+
     /**
      * Returns all the option keys
      *
@@ -349,20 +321,59 @@ class OptionDescriptions {
     }
 
   private:
+    using CollectedValues = std::map<const OptionInterface*, OptionValues>;
+
+    /**
+     * Registers the given option and its argument options
+     *
+     * \param[in] option    The option to add
+     */
+    void addOption(std::unique_ptr<OptionInterface> option) noexcept;
+
+    /**
+     * Returns the option with the given long name. Unambiguous abbreviations
+     * of the long name are accepted as well.
+     *
+     * \param[in] name  The long name to look up
+     * \returns The option associated with the name
+     *          nullptr if there is no such option
+     * \throws std::invalid_argument    If the name abbreviates multiple
+     * options
+     */
+    [[nodiscard]] auto findLongOption(std::string_view name) const
+        -> const OptionInterface*;
+
+    /**
+     * Collects the values of the options in the given command line
+     *
+     * \param[in] tokens    The tokenized command line arguments
+     * \param[in] allowUnregistered Whether to skip options that are not
+     * described in this option description
+     * \returns The values of every option that was given
+     * \throws std::invalid_argument    If the command line does not match the
+     * described options
+     */
+    [[nodiscard]] auto collect(const Tokens& tokens,
+                               bool allowUnregistered) const
+        -> CollectedValues;
+
     /**
      * Maps option values to settings
      *
      * \param[out] variablesMap     The variables map to add the settings to
-     * \param[in] optionsMap        The options mapping
-     * \throws std::invalid_argument    If an option value can not be mapped to the corresponding setting
+     * \param[in] values    The values of the options that were given
+     * \throws std::invalid_argument    If an option value can not be mapped to
+     * the corresponding setting
      */
     void toMap(config::VariablesMap& variablesMap,
-               const boost::program_options::variables_map& optionsMap) const;
-
-    boost::program_options::options_description m_optionDescription;
+               const CollectedValues& values) const;
 
     std::vector<std::string> m_optionKeys;
-    std::map<std::string, std::unique_ptr<OptionInterface>> m_options;
+    std::vector<const OptionInterface*> m_ordered;
+    std::map<std::string, std::unique_ptr<OptionInterface>, std::less<>>
+        m_options;
+    std::map<std::string, const OptionInterface*, std::less<>> m_longOptions;
+    std::map<char, const OptionInterface*> m_shortOptions;
     std::optional<std::string> m_positional;
 };
 } // namespace execHelper::config
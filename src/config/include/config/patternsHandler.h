@@ -1,8 +1,10 @@
 #ifndef __PATTERNS_HANDLER_H__
 #define __PATTERNS_HANDLER_H__
 
+#include <functional>
 #include <map>
 #include <optional>
+#include <string_view>
 
 #include "config/variablesMap.h"
 
@@ -14,7 +16,7 @@ namespace execHelper::config {
  */
 class PatternsHandler {
   private:
-    using PatternCollection = std::map<PatternKey, Pattern>;
+    using PatternCollection = std::map<PatternKey, Pattern, std::less<>>;
 
   public:
     PatternsHandler() = default;
@@ -57,7 +59,7 @@ class PatternsHandler {
      * \returns True    If the handler handles the pattern
      *          False   Otherwise
      */
-    [[nodiscard]] auto contains(const PatternKey& key) const noexcept -> bool;
+    [[nodiscard]] auto contains(std::string_view key) const noexcept -> bool;
 
     /**
      * Registers a pattern with the handler
@@ -69,11 +71,11 @@ class PatternsHandler {
     /**
      * Returns the pattern associated with the given key
      *
-     * \pre \ref contains(const PatternKey&) const for the given key returns true
+     * \pre \ref contains(std::string_view) const for the given key returns true
      *
      * \param[in] key   The key of the pattern \returns The found pattern
      */
-    [[nodiscard]] auto getPattern(const PatternKey& key) const noexcept
+    [[nodiscard]] auto getPattern(std::string_view key) const noexcept
         -> const Pattern&;
 
     /**
@@ -0,0 +1,159 @@
+#ifndef SETTINGS_CACHE_INCLUDE
+#define SETTINGS_CACHE_INCLUDE
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "config.h"
+#include "environment.h"
+#include "path.h"
+
+namespace execHelper::config {
+/**
+ * Returns the directory in which exec-helper caches the results of expensive
+ * operations: the exec-helper directory of XDG_CACHE_HOME or, if it is not
+ * set, of $HOME/.cache.
+ *
+ * \param[in] env   The environment to look up the cache directory in
+ * \returns The cache directory
+ *          std::nullopt if neither XDG_CACHE_HOME nor HOME is set
+ */
+[[nodiscard]] auto getCacheDirectory(const EnvironmentCollection& env) noexcept
+    -> std::optional<Path>;
+
+/**
+ * Returns the file in which the parsed content of the given settings file is
+ * cached. The cache files are stored in the exec-helper directory of
+ * XDG_CACHE_HOME or, if it is not set, of $HOME/.cache.
+ *
+ * \param[in] settingsFile  The settings file to cache
+ * \param[in] env   The environment to look up the cache directory in
+ * \returns The cache file for the settings file
+ *          std::nullopt if there is no cache directory
+ */
+[[nodiscard]] auto
+getSettingsCacheFile(const Path& settingsFile,
+                     const EnvironmentCollection& env) noexcept
+    -> std::optional<Path>;
+
+/**
+ * Returns the file in the given cache directory in which the parsed content of
+ * the given settings file is cached. The name is derived from the resolved
+ * path of the settings file. The other caches that belong to a single path,
+ * like the completion index, the compiled lua plugins and the plugin indices,
+ * use the same name with another extension.
+ *
+ * \param[in] settingsFile  The settings file to cache
+ * \param[in] cacheDirectory    The directory to store the cache file in
+ * \returns The cache file for the settings file
+ *          std::nullopt if the path of the settings file can not be resolved
+ */
+[[nodiscard]] auto getSettingsCacheFileIn(const Path& settingsFile,
+                                          const Path& cacheDirectory) noexcept
+    -> std::optional<Path>;
+
+/**
+ * Reads the parsed settings from the given cache file. The cache is only used
+ * if it was written for the same settings file path, modification time, size
+ * and content by the same version of the binary.
+ *
+ * \param[in] cacheFile The cache file to read
+ * \param[in] settingsFile  The settings file the cache must belong to
+ * \param[in] content   The current content of the settings file
+ * \param[in] version   The version of the binary that reads the cache
+ * \returns The cached patterns and settings
+ *          std::nullopt if the cache does not exist, is stale, is corrupt or
+ *          was written by another version
+ */
+[[nodiscard]] auto readSettingsCache(const Path& cacheFile,
+                                     const Path& settingsFile,
+                                     std::string_view content,
+                                     std::string_view version) noexcept
+    -> std::optional<PatternSettingsPair>;
+
+/**
+ * Writes the parsed settings to the given cache file. The file is replaced
+ * atomically, so concurrent runs never read a partially written cache.
+ *
+ * \param[in] cacheFile The cache file to write
+ * \param[in] settingsFile  The settings file the settings were parsed from
+ * \param[in] content   The content of the settings file they were parsed from
+ * \param[in] settings  The parsed patterns and settings
+ * \param[in] version   The version of the binary that writes the cache
+ * \returns True    If the cache was written
+ *          False   Otherwise
+ */
+auto writeSettingsCache(const Path& cacheFile, const Path& settingsFile,
+                        std::string_view content,
+                        const PatternSettingsPair& settings,
+                        std::string_view version) noexcept -> bool;
+/**
+ * Returns the file in which the completion index of the given settings file is
+ * stored. It is stored next to the cache file of the settings file.
+ *
+ * \param[in] settingsFile  The settings file to complete the commands of
+ * \param[in] env   The environment to look up the cache directory in
+ * \returns The completion index file for the settings file
+ *          std::nullopt if there is no cache directory
+ */
+[[nodiscard]] auto
+getCompletionIndexFile(const Path& settingsFile,
+                       const EnvironmentCollection& env) noexcept
+    -> std::optional<Path>;
+
+/**
+ * Reads the completion words from the given completion index. The index is
+ * only used if none of the files and directories it was written for changed
+ * their modification time or size since, so no settings file needs to be
+ * parsed.
+ *
+ * \param[in] indexFile The completion index to read
+ * \param[in] version   The version of the binary that reads the index
+ * \returns The completion words, in the order they were written
+ *          std::nullopt if the index does not exist, is stale, is corrupt or
+ *          was written by another version
+ */
+[[nodiscard]] auto readCompletionIndex(const Path& indexFile,
+                                       std::string_view version) noexcept
+    -> std::optional<std::vector<std::string>>;
+
+/**
+ * Writes the given completion words to the given completion index. The file
+ * is replaced atomically.
+ *
+ * \param[in] indexFile The completion index to write
+ * \param[in] paths The files and directories the words were derived from
+ * \param[in] words The completion words
+ * \param[in] version   The version of the binary that writes the index
+ * \returns True    If the index was written
+ *          False   Otherwise
+ */
+auto writeCompletionIndex(const Path& indexFile, const Paths& paths,
+                          const std::vector<std::string>& words,
+                          std::string_view version) noexcept -> bool;
+
+/**
+ * Computes the 64 bit FNV-1a hash of the given data. The hash is stable
+ * across runs, so it can identify content in cache files.
+ *
+ * \param[in] data  The data to hash
+ * \returns The hash of the data
+ */
+[[nodiscard]] auto fnv1a(std::string_view data) noexcept -> uint64_t;
+
+/**
+ * Replaces the given file with the given content. A unique temporary file is
+ * written first, so other runs either see the previous or the new content.
+ *
+ * \param[in] file  The file to write
+ * \param[in] content   The content to write
+ * \returns True    If the file was written
+ *          False   Otherwise
+ */
+auto writeAtomically(const Path& file, std::string_view content) -> bool;
+} // namespace execHelper::config
+
+#endif /* SETTINGS_CACHE_INCLUDE */
@@ -1,6 +1,10 @@
 #ifndef __SETTINGS_NODE_H__
 #define __SETTINGS_NODE_H__
 
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
 #include <memory>
 #include <optional>
 #include <string>
@@ -8,11 +12,15 @@
 #include <vector>
 
 #include "cast.h"
+#include "path.h"
+#include "typedValues.h"
 
 namespace execHelper {
 namespace config {
 using SettingsKey = std::string;               //!< The settings key type
 using SettingsKeys = std::vector<SettingsKey>; //!< A SettingsKey collection
+using SettingsKeysView = std::initializer_list<
+    std::string_view>; //!< A non-owning SettingsKey collection
 
 using SettingsValue = SettingsKey; //!< The settings value type
 using SettingsValues =
@@ -20,9 +28,21 @@ using SettingsValues =
 
 /**
  * \brief A class containing a configuration hierarchy
+ *
+ * Copies of a node share their values and subtrees until one of them is
+ * modified: only the path to the modified node is copied at that point, so
+ * copying a node is cheap regardless of the size of the hierarchy. Children
+ * that were handed out as a modifiable reference are not shared: copying
+ * their parent copies them.
+ *
+ * Keys can be looked up as string views: looking up existing keys does not
+ * allocate. The values of a node are converted once for every type they are
+ * requested as.
  */
 class SettingsNode {
   public:
+    class ValuesView;
+
     /**
      * Create a new node with the given key
      *
@@ -31,7 +51,7 @@ class SettingsNode {
     explicit SettingsNode(SettingsKey key) noexcept;
 
     /**
-     * Create a new node by making a deep copy of the given other node
+     * Create a new node with the content of the given other node
      *
      * \param[in] other The other node to copy
      */
@@ -47,7 +67,7 @@ class SettingsNode {
     ~SettingsNode() noexcept;
 
     /**
-     * Assign a deep copy of the content of the given node to this node
+     * Assign the content of the given node to this node
      *
      * \param[in] other The other node to copy from
      * \returns A reference to this
@@ -82,7 +102,18 @@ class SettingsNode {
      * \param[in] key   The key
      * \return  The node associated with the given key
      */
-    auto operator[](const SettingsKey& key) noexcept -> SettingsNode&;
+    auto operator[](std::string_view key) noexcept -> SettingsNode&;
+
+    /**
+     * Get the node associated with the given key for building a hierarchy from
+     * the top down. If the key does not exist, it is created.
+     *
+     * \warning Unlike #operator[], the returned node stays shared with the
+     * copies of this node: it must not be modified once this node was copied
+     * \param[in] key   The key
+     * \return  The node associated with the given key
+     */
+    auto child(std::string_view key) noexcept -> SettingsNode&;
 
     /**
      * Get the node associated with the given key
@@ -92,7 +123,7 @@ class SettingsNode {
      * \param[in] key   The key
      * \return  The node associated with the given key
      */
-    auto operator[](const SettingsKey& key) const noexcept
+    auto operator[](std::string_view key) const noexcept
         -> const SettingsNode&;
 
     /**
@@ -109,12 +140,16 @@ class SettingsNode {
      * \returns True if the key is a value of this node
      *          False otherwise
      */
-    [[nodiscard]] auto contains(const SettingsKey& key) const noexcept -> bool;
+    [[nodiscard]] auto contains(std::string_view key) const noexcept -> bool;
 
-    /*! @copydoc contains(const SettingsKey&) const
+    /*! @copydoc contains(std::string_view) const
      */
     [[nodiscard]] auto contains(const SettingsKeys& key) const noexcept -> bool;
 
+    /*! @copydoc contains(std::string_view) const
+     */
+    [[nodiscard]] auto contains(SettingsKeysView key) const noexcept -> bool;
+
     /**
      * Get the direct values associated with the given key path
      *
@@ -123,32 +158,56 @@ class SettingsNode {
      *              boost::none otherwise
      */
     template <typename T>
-    [[nodiscard]] auto get(const SettingsKeys& key) const noexcept
+    [[nodiscard]] inline auto get(const SettingsKeys& key) const noexcept
         -> std::optional<T> {
-        if(!contains(key)) {
-            return std::nullopt;
-        }
-        auto valuesOpt = at(key)->values();
-        if(!valuesOpt) {
-            return std::nullopt;
-        }
-        return detail::Cast<T, SettingsValues>::cast(valuesOpt.value());
+        return cast<T>(find(key));
     }
 
     /*! @copydoc get(const SettingsKeys&) const
      */
     template <typename T>
-    [[nodiscard]] inline auto get(const SettingsKey& key) const noexcept
+    [[nodiscard]] inline auto get(SettingsKeysView key) const noexcept
         -> std::optional<T> {
-        return get<T>(SettingsKeys({key}));
+        return cast<T>(find(key));
     }
 
     /*! @copydoc get(const SettingsKeys&) const
      */
     template <typename T>
-    [[nodiscard]] inline auto get(const std::string_view& key) const noexcept
+    [[nodiscard]] inline auto get(std::string_view key) const noexcept
         -> std::optional<T> {
-        return get<T>(std::string(key));
+        return cast<T>(find(key));
+    }
+
+    /**
+     * Get the direct values associated with the given key path without copying
+     * them
+     *
+     * \param[in] key   A hierarchy key path
+     * \returns     The associated values if the given hierarchy key path
+     * exists. They are invalidated by any modification of this node.
+     *              nullptr otherwise
+     */
+    template <typename T>
+    [[nodiscard]] inline auto getRef(const SettingsKeys& key) const noexcept
+        -> const T* {
+        return castRef<T>(find(key));
+    }
+
+    /*! @copydoc getRef(const SettingsKeys&) const
+     */
+    template <typename T>
+    [[nodiscard]] inline auto getRef(SettingsKeysView key) const noexcept
+        -> const T* {
+        return castRef<T>(find(key));
+    }
+
+    /*! @copydoc getRef(const SettingsKeys&) const
+     */
+    template <typename T>
+    [[nodiscard]] inline auto getRef(std::string_view key) const noexcept
+        -> const T* {
+        return castRef<T>(find(key));
     }
 
     /**
@@ -169,9 +228,17 @@ class SettingsNode {
     /*! @copydoc get(const SettingsKeys&, const T& defaultValue) const
      */
     template <typename T>
-    [[nodiscard]] inline auto get(const SettingsKey& key,
+    [[nodiscard]] inline auto get(SettingsKeysView key,
+                                  const T& defaultValue) const noexcept -> T {
+        return get<T>(key).value_or(defaultValue);
+    }
+
+    /*! @copydoc get(const SettingsKeys&, const T& defaultValue) const
+     */
+    template <typename T>
+    [[nodiscard]] inline auto get(std::string_view key,
                                   const T& defaultValue) const noexcept -> T {
-        return get<T>(SettingsKeys({key}), defaultValue);
+        return get<T>(key).value_or(defaultValue);
     }
 
     /**
@@ -275,13 +342,7 @@ class SettingsNode {
      * \returns True if the key was successfully removed. Note: if the key does
      * not exist, it is considered to be removed successfully False otherwise
      */
-    auto clear(const SettingsKey& key) noexcept -> bool;
-
-    /*! @copydoc clear(const SettingsKey&)
-     */
-    inline auto clear(const std::string_view& key) noexcept -> bool {
-        return clear(SettingsKey(key));
-    }
+    auto clear(std::string_view key) noexcept -> bool;
 
     /**
      * Remove the child at the end of the given hierarchy key path
@@ -310,43 +371,429 @@ class SettingsNode {
     /**
      * Get the values associated with the root of this node
      *
-     * \returns The associated values if there are values associated with the root of this node
+     * \returns A view on the associated values, in the order they were added,
+     * if there are values associated with the root of this node. The view is
+     * invalidated by any modification of this node.
      *          boost::none otherwise
      */
-    [[nodiscard]] auto values() const noexcept -> std::optional<SettingsValues>;
+    [[nodiscard]] auto values() const noexcept -> std::optional<ValuesView>;
 
   private:
     using SettingsNodeCollection =
         std::vector<SettingsNode>; //!< A collection of nodes
 
     /**
-     * Make a deep copy of the content of other to this node
+     * \brief The children of a node
+     */
+    struct Children {
+        SettingsNodeCollection nodes; //!< The children in the order they were added
+        std::vector<std::size_t>
+            index; //!< The positions of the children, stably sorted by key
+        detail::TypedValues<bool, char, std::uint32_t, std::string,
+                            std::string_view, Path, SettingsValues>
+            typed; //!< The children converted to the requested types
+        bool shareable{
+            true}; //!< Whether no reference to a child was handed out
+    };
+
+    /**
+     * Get the children to share with a copy of a node
+     *
+     * \param[in] values   The children of the copied node. May be nullptr.
+     * \returns The given children if they are shareable
+     *          A copy of the given children otherwise
+     */
+    static auto share(const std::shared_ptr<Children>& values) noexcept
+        -> std::shared_ptr<Children>;
+
+    /**
+     * Find the direct child associated with the given key
+     *
+     * \param[in] key   The key
+     * \returns The first added child associated with the given key if it exists
+     *          nullptr otherwise
+     */
+    [[nodiscard]] auto find(std::string_view key) const noexcept
+        -> const SettingsNode*;
+
+    /*! @copydoc find(std::string_view) const
+     */
+    auto find(std::string_view key) noexcept -> SettingsNode*;
+
+    /*! @copydoc find(std::string_view) const
+     */
+    [[nodiscard]] auto find(const SettingsKeys& key) const noexcept
+        -> const SettingsNode*;
+
+    /*! @copydoc find(std::string_view) const
+     */
+    [[nodiscard]] auto find(SettingsKeysView key) const noexcept
+        -> const SettingsNode*;
+
+    /*! @copydoc find(std::string_view) const
+     */
+    template <typename Keys>
+    [[nodiscard]] auto findPath(const Keys& key) const noexcept
+        -> const SettingsNode*;
+
+    /**
+     * Cast the values of the given node to the given type. The cast is done
+     * once per node and type: later casts return the stored result.
+     *
+     * \param[in] node  The node. May be nullptr.
+     * \returns The casted values if the node exists and has values
+     *          std::nullopt otherwise
+     */
+    template <typename T>
+    [[nodiscard]] static auto cast(const SettingsNode* node) noexcept
+        -> std::optional<T>;
+
+    /**
+     * Cast the values of the given node to the given type, like cast(), without
+     * copying the stored result
+     *
+     * \param[in] node  The node. May be nullptr.
+     * \returns The stored casted values if the node exists and has values
+     *          nullptr otherwise
+     */
+    template <typename T>
+    [[nodiscard]] static auto castRef(const SettingsNode* node) noexcept
+        -> const T*;
+
+    /**
+     * Add a direct child with the given key
+     *
+     * \param[in] key   The key of the child
+     * \returns The added child
+     */
+    auto addChild(SettingsKey key) noexcept -> SettingsNode&;
+
+    /**
+     * Share the values of other with this node. Nothing is done if other has
+     * no values.
      *
      * \param[in] other The other node to copy
      */
-    void deepCopy(const SettingsNode& other) noexcept;
+    void copyValues(const SettingsNode& other) noexcept;
 
-    /*! @copydoc operator[](const SettingsKey&) const
+    /**
+     * Make sure the values of this node are not shared with any other node, so
+     * they can be modified. Removes the stored conversions of the values.
+     */
+    void detach() noexcept;
+
+    /*! @copydoc operator[](std::string_view) const
      */
-    auto at(const SettingsKey& key) noexcept -> SettingsNode*;
+    auto at(std::string_view key) noexcept -> SettingsNode*;
 
-    /*! @copydoc operator[](const SettingsKey&) const
+    /*! @copydoc operator[](std::string_view) const
      */
-    auto at(const SettingsKey& key) const noexcept -> const SettingsNode*;
+    auto at(std::string_view key) const noexcept -> const SettingsNode*;
 
-    /*! @copydoc operator[](const SettingsKey&) const
+    /*! @copydoc operator[](std::string_view) const
      */
     auto at(const SettingsKeys& key) noexcept -> SettingsNode*;
 
-    /*! @copydoc operator[](const SettingsKey&) const
+    /*! @copydoc operator[](std::string_view) const
      */
     auto at(const SettingsKeys& key) const noexcept -> const SettingsNode*;
 
     SettingsKey m_key; //!< The root key associated with this node
-    std::unique_ptr<SettingsNodeCollection>
+    std::shared_ptr<Children>
         m_values; //!< The value hierarchy associated with this node
 };
 
+/**
+ * \brief A non-owning view on the values associated with a settings node
+ */
+class SettingsNode::ValuesView {
+  public:
+    /**
+     * \brief Iterates over the values of a view
+     */
+    class const_iterator {
+      public:
+        using iterator_category =
+            std::random_access_iterator_tag;    //!< brief iterator category
+        using value_type = SettingsValue;       //!< brief value type
+        using difference_type = std::ptrdiff_t; //!< brief difference type
+        using pointer = const SettingsValue*;   //!< brief pointer type
+        using reference = const SettingsValue&; //!< brief reference type
+
+        const_iterator() = default;
+
+        /**
+         * Create an iterator
+         *
+         * \param[in] node  The node to point to
+         */
+        explicit const_iterator(
+            SettingsNodeCollection::const_iterator node) noexcept
+            : m_node(node) {}
+
+        /**
+         * Dereference operator
+         *
+         * \returns The value the iterator points to
+         */
+        auto operator*() const noexcept -> reference { return m_node->m_key; }
+
+        /**
+         * Member access operator
+         *
+         * \returns The value the iterator points to
+         */
+        auto operator->() const noexcept -> pointer { return &m_node->m_key; }
+
+        /**
+         * Subscript operator
+         *
+         * \param[in] offset    The offset from this iterator
+         * \returns The value at the given offset
+         */
+        auto operator[](difference_type offset) const noexcept -> reference {
+            return m_node[offset].m_key;
+        }
+
+        /**
+         * Advance to the next value
+         *
+         * \returns This iterator
+         */
+        auto operator++() noexcept -> const_iterator& {
+            ++m_node;
+            return *this;
+        }
+
+        /*! @copydoc operator++()
+         */
+        auto operator++(int) noexcept -> const_iterator {
+            return const_iterator(m_node++);
+        }
+
+        /**
+         * Move back to the previous value
+         *
+         * \returns This iterator
+         */
+        auto operator--() noexcept -> const_iterator& {
+            --m_node;
+            return *this;
+        }
+
+        /*! @copydoc operator--()
+         */
+        auto operator--(int) noexcept -> const_iterator {
+            return const_iterator(m_node--);
+        }
+
+        /**
+         * Advance the iterator by the given offset
+         *
+         * \param[in] offset    The offset
+         * \returns This iterator
+         */
+        auto operator+=(difference_type offset) noexcept -> const_iterator& {
+            m_node += offset;
+            return *this;
+        }
+
+        /*! @copydoc operator+=(difference_type)
+         */
+        auto operator-=(difference_type offset) noexcept -> const_iterator& {
+            m_node -= offset;
+            return *this;
+        }
+
+        /**
+         * Returns an iterator at the given offset of this iterator
+         *
+         * \param[in] offset    The offset
+         * \returns The iterator
+         */
+        auto operator+(difference_type offset) const noexcept
+            -> const_iterator {
+            return const_iterator(m_node + offset);
+        }
+
+        /*! @copydoc operator+(difference_type) const
+         */
+        auto operator-(difference_type offset) const noexcept
+            -> const_iterator {
+            return const_iterator(m_node - offset);
+        }
+
+        /**
+         * Returns the distance between two iterators
+         *
+         * \param[in] other The other iterator
+         * \returns The distance
+         */
+        auto operator-(const const_iterator& other) const noexcept
+            -> difference_type {
+            return m_node - other.m_node;
+        }
+
+        /**
+         * Comparison operators
+         *
+         * \param[in] other The other iterator
+         * \returns The result of comparing the positions of both iterators
+         */
+        auto operator==(const const_iterator& other) const noexcept -> bool {
+            return m_node == other.m_node;
+        }
+
+        /*! @copydoc operator==(const const_iterator&) const
+         */
+        auto operator!=(const const_iterator& other) const noexcept -> bool {
+            return m_node != other.m_node;
+        }
+
+        /*! @copydoc operator==(const const_iterator&) const
+         */
+        auto operator<(const const_iterator& other) const noexcept -> bool {
+            return m_node < other.m_node;
+        }
+
+        /*! @copydoc operator==(const const_iterator&) const
+         */
+        auto operator>(const const_iterator& other) const noexcept -> bool {
+            return m_node > other.m_node;
+        }
+
+        /*! @copydoc operator==(const const_iterator&) const
+         */
+        auto operator<=(const const_iterator& other) const noexcept -> bool {
+            return m_node <= other.m_node;
+        }
+
+        /*! @copydoc operator==(const const_iterator&) const
+         */
+        auto operator>=(const const_iterator& other) const noexcept -> bool {
+            return m_node >= other.m_node;
+        }
+
+      private:
+        SettingsNodeCollection::const_iterator m_node;
+    };
+
+    using iterator = const_iterator;      //!< brief iterator type
+    using value_type = SettingsValue;     //!< brief value type
+    using size_type = std::size_t;        //!< brief size type
+    using reference = const SettingsValue&; //!< brief reference type
+    using const_reference = reference;    //!< brief const reference type
+
+    /**
+     * Create a view
+     *
+     * \param[in] nodes The nodes whose keys are the values
+     */
+    explicit ValuesView(const SettingsNodeCollection& nodes) noexcept
+        : m_nodes(&nodes) {}
+
+    /**
+     * Return iterator to beginning
+     *
+     * \returns A begin iterator
+     */
+    [[nodiscard]] auto begin() const noexcept -> const_iterator {
+        return const_iterator(m_nodes->begin());
+    }
+
+    /**
+     * Return iterator to end
+     *
+     * \returns An end iterator
+     */
+    [[nodiscard]] auto end() const noexcept -> const_iterator {
+        return const_iterator(m_nodes->end());
+    }
+
+    /**
+     * Returns the number of values
+     *
+     * \returns The number of values
+     */
+    [[nodiscard]] auto size() const noexcept -> size_type {
+        return m_nodes->size();
+    }
+
+    /**
+     * Returns whether there are no values
+     *
+     * \returns True    If there are no values
+     *          False   Otherwise
+     */
+    [[nodiscard]] auto empty() const noexcept -> bool {
+        return m_nodes->empty();
+    }
+
+    /**
+     * Returns the value at the given position
+     *
+     * \param[in] position  The position. Must be less than \ref size().
+     * \returns The value
+     */
+    [[nodiscard]] auto operator[](size_type position) const noexcept
+        -> reference {
+        return (*m_nodes)[position].m_key;
+    }
+
+    /**
+     * Returns the first value
+     *
+     * \pre \ref empty() == false
+     * \returns The first value
+     */
+    [[nodiscard]] auto front() const noexcept -> reference {
+        return m_nodes->front().m_key;
+    }
+
+    /**
+     * Returns the last value
+     *
+     * \pre \ref empty() == false
+     * \returns The last value
+     */
+    [[nodiscard]] auto back() const noexcept -> reference {
+        return m_nodes->back().m_key;
+    }
+
+    /**
+     * Copies the values
+     *
+     * \returns The values
+     */
+    explicit operator SettingsValues() const {
+        return SettingsValues(begin(), end());
+    }
+
+  private:
+    const SettingsNodeCollection* m_nodes;
+};
+
+template <typename T>
+auto SettingsNode::cast(const SettingsNode* node) noexcept -> std::optional<T> {
+    const auto* values = castRef<T>(node);
+    if(values == nullptr) {
+        return std::nullopt;
+    }
+    return *values;
+}
+
+template <typename T>
+auto SettingsNode::castRef(const SettingsNode* node) noexcept -> const T* {
+    if(node == nullptr || !node->m_values) {
+        return nullptr;
+    }
+    const auto& children = *node->m_values;
+    const auto& values = children.typed.template get<T>([&children]() {
+        return detail::Cast<T, ValuesView>::cast(ValuesView(children.nodes));
+    });
+    return values ? &(*values) : nullptr;
+}
+
 /**
  * Streaming operator for settings nodes
  *
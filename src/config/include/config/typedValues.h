@@ -0,0 +1,102 @@
+#ifndef TYPED_VALUES_INCLUDE
+#define TYPED_VALUES_INCLUDE
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace execHelper {
+namespace config {
+namespace detail {
+/**
+ * \brief Memoizes the conversions of the values of a settings node to each of
+ * the given types
+ *
+ * Every conversion is done once: later requests for the same type read the
+ * stored result. Concurrent readers may convert at the same time, in which
+ * case only the first stored result is kept. Copies start without any stored
+ * conversions.
+ */
+template <typename... Types> class TypedValues {
+  public:
+    TypedValues() noexcept = default;
+
+    /**
+     * Copy constructor. The conversions are not copied.
+     */
+    TypedValues(const TypedValues& /*other*/) noexcept { ; }
+
+    ~TypedValues() noexcept { clear(); }
+
+    /**
+     * Assignment operator. Removes the stored conversions.
+     *
+     * \returns A reference to this
+     */
+    auto operator=(const TypedValues& /*other*/) noexcept -> TypedValues& {
+        clear();
+        return *this;
+    }
+
+    /**
+     * Returns the stored conversion to type T, converting it first if there
+     * is none
+     *
+     * \param[in] convert   The conversion to use if there is no stored one
+     * \returns The stored conversion
+     */
+    template <typename T, typename Convert>
+    auto get(const Convert& convert) const noexcept
+        -> const std::optional<T>& {
+        auto& slot = m_values[indexOf<T, Types...>()];
+        auto* stored = slot.load(std::memory_order_acquire);
+        if(stored == nullptr) {
+            auto* converted = new std::optional<T>(convert());
+            if(slot.compare_exchange_strong(stored, converted,
+                                            std::memory_order_acq_rel,
+                                            std::memory_order_acquire)) {
+                return *converted;
+            }
+            delete converted;
+        }
+        return *static_cast<const std::optional<T>*>(stored);
+    }
+
+    /**
+     * Removes the stored conversions. Must not be called while the
+     * conversions are read.
+     */
+    void clear() noexcept { clear(std::index_sequence_for<Types...>()); }
+
+  private:
+    template <typename T, typename First, typename... Rest>
+    static constexpr auto indexOf() noexcept -> std::size_t {
+        if constexpr(std::is_same_v<T, First>) {
+            return 0U;
+        } else {
+            static_assert(sizeof...(Rest) > 0U,
+                          "The type does not support conversions");
+            return 1U + indexOf<T, Rest...>();
+        }
+    }
+
+    template <std::size_t... Indices>
+    void clear(std::index_sequence<Indices...> /*indices*/) noexcept {
+        (reset<Types>(Indices), ...);
+    }
+
+    template <typename T> void reset(std::size_t index) noexcept {
+        delete static_cast<std::optional<T>*>(m_values[index].exchange(
+            nullptr, std::memory_order_acq_rel));
+    }
+
+    mutable std::array<std::atomic<void*>, sizeof...(Types)> m_values{};
+};
+} // namespace detail
+} // namespace config
+} // namespace execHelper
+
+#endif /* TYPED_VALUES_INCLUDE */
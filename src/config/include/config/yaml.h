@@ -15,6 +15,10 @@ namespace execHelper {
 namespace yaml {
 /**
  * \brief   Interface to reading YAML files
+ *
+ * Trees are read using the \ref YamlParser if it supports the document. The
+ * document is only parsed by \ref YamlWrapper if it is not supported or when
+ * it is queried in other ways.
  */
 class Yaml : public config::ConfigInputFile {
   public:
@@ -22,6 +26,8 @@ class Yaml : public config::ConfigInputFile {
      * Constructor
      *
      * \param[in] file  Path to the file to parse
+     * \throws YAML::BadFile    If the given file can not be read
+     * \throws YAML::ParserException    If the file is not a valid YAML document
      */
     explicit Yaml(const config::Path& file);
 
@@ -29,6 +35,8 @@ class Yaml : public config::ConfigInputFile {
      * Constructor
      *
      * \param[in] yamlConfig    The content to parse
+     * \throws YAML::ParserException    If the content is not a valid YAML
+     * document
      */
     explicit Yaml(const std::string& yamlConfig);
 
@@ -61,7 +69,17 @@ class Yaml : public config::ConfigInputFile {
                  config::SettingsNode* settings) const noexcept override;
 
   private:
-    YamlWrapper m_yaml;
+    /**
+     * Returns the content parsed by yaml-cpp. The content is parsed on the
+     * first call.
+     *
+     * \returns The parsed content
+     */
+    [[nodiscard]] auto wrapper() const -> const YamlWrapper&;
+
+    std::string m_content;
+    bool m_supported{false};
+    mutable std::unique_ptr<YamlWrapper> m_yaml;
 };
 } // namespace yaml
 } // namespace execHelper
@@ -0,0 +1,56 @@
+#ifndef __YAML_PARSER_H__
+#define __YAML_PARSER_H__
+
+#include <string_view>
+
+#include "config/settingsNode.h"
+
+namespace execHelper::yaml {
+/**
+ * \brief Converts YAML documents to settings without building an intermediate
+ * document
+ *
+ * The document is parsed in place: scalars are only copied when they are added
+ * to the settings. Only the subset of YAML that is used by exec-helper
+ * configurations is supported: block and flow mappings and sequences, single
+ * line plain and quoted scalars, comments, anchors and aliases. Documents that
+ * use anything else are rejected, so they can be handed to \ref YamlWrapper.
+ * Supported documents result in exactly the same settings as
+ * \ref YamlWrapper::getTree(const YAML::Node&, config::SettingsNode*).
+ */
+class YamlParser {
+  public:
+    /**
+     * Constructor
+     *
+     * \param[in] yamlConfig    The content to parse. Must outlive this object.
+     */
+    explicit YamlParser(std::string_view yamlConfig) noexcept;
+
+    /**
+     * Returns whether the document is valid and only uses the supported
+     * subset of YAML
+     *
+     * \returns True    If the document can be parsed by this parser
+     *          False   Otherwise
+     */
+    [[nodiscard]] auto isSupported() const noexcept -> bool;
+
+    /**
+     * Parses the document and adds it to the given settings
+     *
+     * \param[out] settings  The settings to add the parsed structure to. Left
+     * untouched if the parsing is not successful.
+     * \returns True    If the document is supported and its root is a
+     * non-empty mapping or sequence
+     *          False   Otherwise
+     */
+    [[nodiscard]] auto getTree(config::SettingsNode* settings) const noexcept
+        -> bool;
+
+  private:
+    std::string_view m_content;
+};
+} // namespace execHelper::yaml
+
+#endif /* __YAML_PARSER_H__ */
@@ -3,7 +3,6 @@
 
 #include <algorithm>
 #include <iostream>
-#include <numeric>
 #include <string>
 
 #include <yaml-cpp/node/node.h>
@@ -80,17 +79,16 @@ class YamlWrapper {
      */
     template <typename T>
     T get(const std::initializer_list<config::SettingsKey>& keys) const {
-        YAML::Node node = std::accumulate(
-            keys.begin(), keys.end(), Clone(m_node),
-            [](const auto& node, const auto& key) { return node[key]; });
-        return node.as<T>();
+        return getSubNode(keys).as<T>();
     }
 
     /**
-     * Returns the node below the given key structure
+     * Returns the node below the given key structure. The document is not
+     * modified nor copied.
      *
      * \param[in] keys  A collection of keys to follow
-     * \returns The node associated with the given key structure
+     * \returns The node associated with the given key structure. The returned
+     * node is not defined if the key structure does not exist.
      */
     YAML::Node getSubNode(const std::initializer_list<std::string>& keys) const;
 
@@ -119,18 +117,15 @@ class YamlWrapper {
 
   private:
     /**
-     * Parse the given node and add it to the given settings under the given key
-     * structure
+     * Parse the given node and add it to the given settings
      *
      * \param[in] node  The node to parse
-     * \param[out] yamlNode  The root settings
-     * \param[in] keys  The key structure of the root settings under which to
-     * write the parsed structure \returns True    If the subtree was
-     * successfully constructed and added False   Otherwise
+     * \param[out] yamlNode  The settings to add the parsed structure to
+     * \returns True    If the subtree was successfully constructed and added
+     *          False   Otherwise
      */
     static bool getSubTree(const YAML::Node& node,
-                           config::SettingsNode* yamlNode,
-                           const config::SettingsKeys& keys) noexcept;
+                           config::SettingsNode* yamlNode) noexcept;
 
     YAML::Node m_node;
 };
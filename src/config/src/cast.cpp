@@ -1,6 +1,9 @@
 #include "cast-impl.h"
 
+#include "settingsNode.h"
+
 using std::string;
+using std::string_view;
 using std::vector;
 
 namespace execHelper::config::detail {
@@ -10,4 +13,12 @@ template class Cast<bool, vector<string>>;
 template class Cast<Path, vector<string>>;
 template class Cast<char, vector<string>>;
 template class Cast<uint32_t, vector<string>>;
+
+template class Cast<string, SettingsNode::ValuesView>;
+template class Cast<string_view, SettingsNode::ValuesView>;
+template class Cast<vector<string>, SettingsNode::ValuesView>;
+template class Cast<bool, SettingsNode::ValuesView>;
+template class Cast<Path, SettingsNode::ValuesView>;
+template class Cast<char, SettingsNode::ValuesView>;
+template class Cast<uint32_t, SettingsNode::ValuesView>;
 } // namespace execHelper::config::detail
@@ -0,0 +1,36 @@
+#include "commandLine.h"
+
+using std::string_view;
+
+namespace execHelper::config {
+CommandLine::CommandLine(const Args& args) noexcept {
+    if(args.empty()) {
+        return;
+    }
+
+    m_tokens.reserve(args.size() - 1U);
+    bool separated = false;
+    for(const auto* arg : args.subspan(1U)) {
+        const string_view argument(arg);
+        if(separated) {
+            m_tokens.push_back({Token::Kind::Positional, argument, {}});
+        } else if(argument == "--") {
+            separated = true;
+        } else if(argument.starts_with("--")) {
+            const auto option = argument.substr(2U);
+            const auto equals = option.find('=');
+            if(equals == string_view::npos) {
+                m_tokens.push_back({Token::Kind::Long, option, {}});
+            } else {
+                m_tokens.push_back({Token::Kind::Long,
+                                    option.substr(0U, equals),
+                                    option.substr(equals + 1U)});
+            }
+        } else if(argument.size() > 1U && argument.front() == '-') {
+            m_tokens.push_back({Token::Kind::Short, argument.substr(1U), {}});
+        } else {
+            m_tokens.push_back({Token::Kind::Value, argument, {}});
+        }
+    }
+}
+} // namespace execHelper::config
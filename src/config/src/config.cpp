@@ -1,38 +1,62 @@
 #include "config.h"
 
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iterator>
 #include <string>
 #include <string_view>
+#include <system_error>
+#include <vector>
 
 #include "commandLineOptions.h"
+#include "configFileSearcher.h"
 #include "logger.h"
 #include "optionDescriptions.h"
 #include "pattern.h"
 #include "patternsHandler.h"
+#include "settingsCache.h"
 #include "variablesMap.h"
 #include "yaml.h"
 
+using std::error_code;
+using std::future;
+using std::ifstream;
+using std::istreambuf_iterator;
 using std::optional;
 using std::string;
 using std::string_view;
+using std::vector;
 
+namespace filesystem = std::filesystem;
+
+using execHelper::config::ConfigFileSearcher;
+using execHelper::config::getSettingsCacheFileIn;
+using execHelper::config::Path;
+using execHelper::config::Paths;
 using execHelper::config::Patterns;
+using execHelper::config::PatternSettingsPair;
 using execHelper::config::PatternsHandler;
+using execHelper::config::readSettingsCache;
 using execHelper::config::SettingsKeys;
 using execHelper::config::SettingsNode;
 using execHelper::config::SettingsValues;
 using execHelper::config::VariablesMap;
+using execHelper::config::writeSettingsCache;
 using execHelper::yaml::Yaml;
 
 namespace {
 using namespace std::literals;
 const string_view patternsKey = "patterns"sv;
+const string_view includeKey = "include"sv;
 
 auto processPatterns(const SettingsNode& settings) noexcept -> Patterns {
     Patterns result;
-    if(settings.contains(string(patternsKey))) {
-        const SettingsNode& patternSettings = settings[string(patternsKey)];
-        for(const auto& patternKey : settings.get<SettingsValues>(
-                string(patternsKey), SettingsValues())) {
+    if(settings.contains(patternsKey)) {
+        const SettingsNode& patternSettings = settings[patternsKey];
+        for(const auto& patternKey :
+            settings.get<SettingsValues>(patternsKey, SettingsValues())) {
             VariablesMap newPatternMap =
                 PatternsHandler::getDefaultPatternMap(patternKey);
             newPatternMap.overwrite(patternSettings[patternKey]);
@@ -46,21 +70,236 @@ auto processPatterns(const SettingsNode& settings) noexcept -> Patterns {
     }
     return result;
 }
-} // namespace
 
-namespace execHelper::config {
-auto parseSettingsFile(const Path& file) noexcept
+auto parseSettings(const Yaml& yaml) noexcept
     -> optional<PatternSettingsPair> {
     SettingsNode configuration("exec-helper");
-
-    Yaml yaml(file);
     if(!yaml.getTree({}, &configuration)) {
         LOG(error) << "Could not get settings tree";
         return std::nullopt;
     }
 
     Patterns patterns = processPatterns(configuration);
-    configuration.clear(string(patternsKey));
+    configuration.clear(patternsKey);
     return make_pair(patterns, configuration);
 }
+
+/**
+ * Parses the given settings file on its own, without resolving its includes
+ *
+ * \param[in] file  The settings file to parse
+ * \param[in] cacheFile The cache file to use. std::nullopt disables the cache.
+ * \param[in] version   The version of the binary that uses the cache
+ * \returns The patterns and settings of the settings file
+ *          std::nullopt if the settings file could not be parsed
+ */
+auto parseFile(const Path& file, const optional<Path>& cacheFile,
+               string_view version) noexcept -> optional<PatternSettingsPair> {
+    if(!cacheFile) {
+        return parseSettings(Yaml(file));
+    }
+
+    ifstream stream(file, std::ios::binary);
+    if(!stream) {
+        LOG(error) << "Could not read settings file " << file;
+        return std::nullopt;
+    }
+    const string content((istreambuf_iterator<char>(stream)),
+                         istreambuf_iterator<char>());
+
+    auto settings = readSettingsCache(*cacheFile, file, content, version);
+    if(settings) {
+        return settings;
+    }
+
+    // Parse the content that was read rather than the file, so the cache is
+    // never written for a file that changed in the meantime
+    settings = parseSettings(Yaml(content));
+    if(settings &&
+       !writeSettingsCache(*cacheFile, file, content, *settings, version)) {
+        LOG(debug) << "Could not cache the settings of " << file;
+    }
+    return settings;
+}
+
+/**
+ * Returns whether the given node maps its keys to values of their own
+ *
+ * \param[in] node  The node to check
+ * \returns True    If at least one child of the node has values
+ *          False   Otherwise
+ */
+auto isMapping(const SettingsNode& node) noexcept -> bool {
+    const auto keys = node.values();
+    return keys && std::any_of(keys->begin(), keys->end(),
+                               [&node](const auto& key) {
+                                   return node[key].values().has_value();
+                               });
+}
+
+/**
+ * Merges the given settings into the existing ones. Mappings that exist in
+ * both are merged key by key, all other values of the new settings replace
+ * the existing ones.
+ *
+ * \param[in] newSettings   The settings to merge
+ * \param[out] settings The settings to merge into
+ */
+void merge(const SettingsNode& newSettings, SettingsNode* settings) noexcept {
+    const auto keys = newSettings.values();
+    if(!keys) {
+        return;
+    }
+    for(const auto& key : *keys) {
+        const auto& newValue = newSettings[key];
+        auto& value = settings->child(key);
+        if(isMapping(value) && isMapping(newValue)) {
+            merge(newValue, &value);
+        } else {
+            SettingsNode copy(newValue);
+            value.swap(copy);
+        }
+    }
+}
+
+/**
+ * Merges the given patterns into the existing ones. New patterns replace the
+ * existing patterns with the same key.
+ *
+ * \param[in] newPatterns   The patterns to merge
+ * \param[out] patterns The patterns to merge into
+ */
+void merge(const Patterns& newPatterns, Patterns* patterns) noexcept {
+    for(const auto& newPattern : newPatterns) {
+        auto pattern = std::find_if(patterns->begin(), patterns->end(),
+                                    [&newPattern](const auto& pattern) {
+                                        return pattern.getKey() ==
+                                               newPattern.getKey();
+                                    });
+        if(pattern != patterns->end()) {
+            *pattern = newPattern;
+        } else {
+            patterns->push_back(newPattern);
+        }
+    }
+}
+
+/**
+ * Parses the given settings file and the settings files it includes. The
+ * included files are loaded in parallel and merged in the order they are
+ * listed, after which the settings of the including file are merged.
+ *
+ * \param[in] file  The settings file to parse
+ * \param[in] cacheFile The cache file to use for the settings file. The
+ * included files are cached in the same directory. std::nullopt disables the
+ * cache.
+ * \param[in] version   The version of the binary that uses the cache
+ * \param[in] ancestors The settings files that (indirectly) include this file
+ * \param[out] files   The settings files that were parsed are added to this
+ * \returns The merged patterns and settings
+ *          std::nullopt if any of the settings files could not be parsed
+ */
+auto loadSettingsFile(const Path& file, const optional<Path>& cacheFile,
+                      string_view version, const Paths& ancestors,
+                      Paths* files) noexcept -> optional<PatternSettingsPair> {
+    files->push_back(file);
+    auto settings = parseFile(file, cacheFile, version);
+    if(!settings) {
+        return std::nullopt;
+    }
+
+    auto& configuration = settings->second;
+    if(!configuration.contains(includeKey)) {
+        return settings;
+    }
+    const auto includes =
+        configuration.get<SettingsValues>(includeKey, SettingsValues());
+    configuration.clear(includeKey);
+
+    error_code error;
+    Paths nested(ancestors);
+    nested.push_back(filesystem::weakly_canonical(file, error));
+    if(error) {
+        LOG(error) << "Could not resolve settings file " << file;
+        return std::nullopt;
+    }
+
+    // Relative includes are relative to the directory of the including file
+    ConfigFileSearcher searcher({file.parent_path()});
+    vector<Paths> includedFiles(includes.size());
+    vector<future<optional<PatternSettingsPair>>> loading;
+    loading.reserve(includes.size());
+    for(const auto& include : includes) {
+        auto includeFile = searcher.find(include);
+        if(!includeFile) {
+            LOG(error) << "Could not find settings file " << include
+                       << " included by " << file;
+            return std::nullopt;
+        }
+        if(std::find(nested.begin(), nested.end(),
+                     filesystem::weakly_canonical(*includeFile, error)) !=
+           nested.end()) {
+            LOG(error) << "Settings file " << *includeFile
+                       << " includes itself";
+            return std::nullopt;
+        }
+
+        optional<Path> includeCacheFile;
+        if(cacheFile) {
+            includeCacheFile =
+                getSettingsCacheFileIn(*includeFile, cacheFile->parent_path());
+        }
+
+        try {
+            loading.emplace_back(std::async(
+                std::launch::async,
+                [file = *includeFile, cache = includeCacheFile, version,
+                 &nested, files = &includedFiles[loading.size()]]() {
+                    return loadSettingsFile(file, cache, version, nested,
+                                            files);
+                }));
+        } catch(const std::system_error& e) {
+            LOG(error) << "Could not load settings file " << *includeFile
+                       << ": " << e.what();
+            return std::nullopt;
+        }
+    }
+
+    PatternSettingsPair result(Patterns(), SettingsNode(configuration.key()));
+    for(size_t i = 0U; i < loading.size(); ++i) {
+        auto includedSettings = loading[i].get();
+        if(!includedSettings) {
+            return std::nullopt;
+        }
+        merge(includedSettings->first, &result.first);
+        merge(includedSettings->second, &result.second);
+        files->insert(files->end(), includedFiles[i].begin(),
+                      includedFiles[i].end());
+    }
+    merge(settings->first, &result.first);
+    merge(configuration, &result.second);
+    return result;
+}
+} // namespace
+
+namespace execHelper::config {
+auto parseSettingsFile(const Path& file) noexcept
+    -> optional<PatternSettingsPair> {
+    Paths files;
+    return loadSettingsFile(file, std::nullopt, string_view(), Paths(),
+                            &files);
+}
+
+auto parseSettingsFile(const Path& file, const optional<Path>& cacheFile,
+                       string_view version) noexcept
+    -> optional<PatternSettingsPair> {
+    Paths files;
+    return loadSettingsFile(file, cacheFile, version, Paths(), &files);
+}
+
+auto parseSettingsFile(const Path& file, const optional<Path>& cacheFile,
+                       string_view version, Paths* files) noexcept
+    -> optional<PatternSettingsPair> {
+    return loadSettingsFile(file, cacheFile, version, Paths(), files);
+}
 } // namespace execHelper::config
@@ -36,6 +36,8 @@ FleetingOptions::FleetingOptions(const VariablesMap& optionsMap) noexcept
       m_dryRun(optionsMap.get<DryRunOption_t>(DRY_RUN_KEY).value_or(false)),
       m_keepGoing(
           optionsMap.get<KeepGoingOption_t>(KEEP_GOING_KEY).value_or(false)),
+      m_posixSpawn(optionsMap.get<PosixSpawnOption_t>(POSIX_SPAWN_KEY)
+                       .value_or(false)),
       m_jobs(1U),
       m_logLevel(
           optionsMap.get<LogLevelOption_t>(LOG_LEVEL_KEY).value_or("warning")),
@@ -47,7 +49,12 @@ FleetingOptions::FleetingOptions(const VariablesMap& optionsMap) noexcept
       m_commands(optionsMap.get<CommandCollection>(COMMAND_KEY)
                      .value_or(CommandCollection())),
       m_autocomplete(
-          optionsMap.get<AutoCompleteOption_t>(string(AUTO_COMPLETE_KEY))) {
+          optionsMap.get<AutoCompleteOption_t>(string(AUTO_COMPLETE_KEY))),
+      m_shard(optionsMap.get<ShardOption_t>(SHARD_KEY)),
+      m_shardDurations(
+          optionsMap.get<ShardDurationsOption_t>(SHARD_DURATIONS_KEY)),
+      m_shardDurationsOut(
+          optionsMap.get<ShardDurationsOutOption_t>(SHARD_DURATIONS_OUT_KEY)) {
     auto jobs = optionsMap.get<JobsOption_t>(JOBS_KEY).value_or("auto");
     if(jobs == "auto") {
         m_jobs = thread::hardware_concurrency();
@@ -91,6 +98,10 @@ auto FleetingOptions::getKeepGoing() const noexcept -> KeepGoingOption_t {
     return m_keepGoing;
 }
 
+auto FleetingOptions::getPosixSpawn() const noexcept -> PosixSpawnOption_t {
+    return m_posixSpawn;
+}
+
 auto FleetingOptions::getJobs() const noexcept -> Jobs_t { return m_jobs; }
 
 auto FleetingOptions::getCommands() const noexcept -> const CommandCollection& {
@@ -131,12 +142,18 @@ auto FleetingOptions::getDefault() noexcept -> VariablesMap {
     if(!defaults.add(KEEP_GOING_KEY, "no")) {
         LOG(error) << "Failed to add keep going default option value";
     }
+    if(!defaults.add(POSIX_SPAWN_KEY, "no")) {
+        LOG(error) << "Failed to add posix spawn default option value";
+    }
     if(!defaults.add(JOBS_KEY, "auto")) {
         LOG(error) << "Failed to add jobs default option value";
     }
     if(!defaults.add(SETTINGS_FILE_KEY)) {
         LOG(error) << "Failed to add settings file default option value";
     }
+    if(!defaults.add(NO_SETTINGS_CACHE_KEY, "no")) {
+        LOG(error) << "Failed to add 'no settings cache' default option value";
+    }
     if(!defaults.add(LOG_LEVEL_KEY, "none")) {
         LOG(error) << "Failed to add log level default option value";
     }
@@ -156,4 +173,19 @@ auto FleetingOptions::getAutoComplete() const noexcept
     -> const std::optional<AutoCompleteOption_t>& {
     return m_autocomplete;
 }
+
+auto FleetingOptions::getShard() const noexcept
+    -> const std::optional<ShardOption_t>& {
+    return m_shard;
+}
+
+auto FleetingOptions::getShardDurations() const noexcept
+    -> const std::optional<ShardDurationsOption_t>& {
+    return m_shardDurations;
+}
+
+auto FleetingOptions::getShardDurationsOut() const noexcept
+    -> const std::optional<ShardDurationsOutOption_t>& {
+    return m_shardDurationsOut;
+}
 } // namespace execHelper::config
@@ -1,27 +1,201 @@
 #include "optionDescriptions.h"
 
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+
 #include "log/log.h"
 #include "logger.h"
-#include <stdexcept>
 
 using std::invalid_argument;
+using std::max;
+using std::min;
+using std::optional;
+using std::size_t;
 using std::string;
+using std::string_view;
 
-using boost::program_options::command_line_parser;
-using boost::program_options::notify;
-using boost::program_options::options_description;
-using boost::program_options::positional_options_description;
-using boost::program_options::store;
-using boost::program_options::variables_map;
-
+using execHelper::config::OptionInterface;
+using execHelper::config::OptionValues;
+using execHelper::config::Token;
+using execHelper::config::Tokens;
 using execHelper::config::VariablesMap;
+using execHelper::config::detail::Arity;
+
+namespace {
+const size_t LINE_LENGTH = 80U;
+const size_t MAX_NAMES_WIDTH = 40U;
+
+/**
+ * \brief Thrown when the command line contains an option that is not
+ * described
+ */
+class UnrecognisedOptionError : public invalid_argument {
+  public:
+    /**
+     * Constructor
+     *
+     * \param[in] option    The option as it was given on the command line
+     */
+    explicit UnrecognisedOptionError(const string& option)
+        : invalid_argument("unrecognised option '" + option + "'") {
+        ;
+    }
+};
+
+/**
+ * Returns the options as they are listed in the help text, e.g.
+ * "-j [ --jobs ] arg"
+ *
+ * \param[in] option    The option to list
+ * \returns The listed options
+ */
+auto getNames(const OptionInterface& option) -> string {
+    string names("--" + option.getId());
+    for(const auto& argumentOption : option.getArgumentOptions()) {
+        const auto prefix = argumentOption.size() == 1U ? "-" : "--";
+        names = prefix + argumentOption + " [ " + names + " ]";
+    }
+    if(option.getArity() != Arity::None) {
+        names.append(" arg");
+    }
+    return names;
+}
+
+/**
+ * Appends the given explanation to the help text, wrapping it at the line
+ * length
+ *
+ * \param[in] explanation   The explanation to append
+ * \param[in] indent    The column at which every line of the explanation starts
+ * \param[out] help The help text to append to
+ */
+void appendExplanation(string_view explanation, size_t indent, string* help) {
+    auto column = indent;
+    bool firstWord = true;
+    while(!explanation.empty()) {
+        const auto end = explanation.find(' ');
+        const auto word = explanation.substr(0U, end);
+        explanation.remove_prefix(
+            end == string_view::npos ? explanation.size() : end + 1U);
+        if(word.empty()) {
+            continue;
+        }
+
+        if(!firstWord && column + 1U + word.size() > LINE_LENGTH) {
+            help->append("\n").append(indent, ' ');
+            column = indent;
+        } else if(!firstWord) {
+            help->push_back(' ');
+            ++column;
+        }
+        help->append(word);
+        column += word.size();
+        firstWord = false;
+    }
+}
+
+/**
+ * Collects the values of the given option, starting with the token at the
+ * given position
+ *
+ * \param[in] option    The option to collect the values of
+ * \param[in] attached  The value that was attached to the option itself
+ * \param[in] tokens    The tokenized command line arguments
+ * \param[in] position  The position of the token of the option
+ * \param[out] values   The values to add the values of the option to
+ * \returns The position of the last token that was consumed
+ * \throws std::invalid_argument    If the values do not fit the option or the
+ * option takes a single value and was already given
+ */
+auto collectValues(const OptionInterface& option,
+                   optional<string_view> attached, const Tokens& tokens,
+                   size_t position,
+                   std::map<const OptionInterface*, OptionValues>* values)
+    -> size_t {
+    auto& optionValues = (*values)[&option];
+    const auto arity = option.getArity();
+    if(arity == Arity::None) {
+        if(attached) {
+            throw invalid_argument("option '--" + option.getId() +
+                                   "' does not take any arguments");
+        }
+        return position;
+    }
+    if(arity == Arity::One && !optionValues.empty()) {
+        throw invalid_argument("option '--" + option.getId() +
+                               "' cannot be specified more than once");
+    }
+
+    auto isValue = [&tokens](size_t next) {
+        return next < tokens.size() && tokens[next].kind == Token::Kind::Value;
+    };
+
+    if(attached) {
+        optionValues.push_back(*attached);
+    } else if(isValue(position + 1U)) {
+        optionValues.push_back(tokens[++position].text);
+    } else {
+        throw invalid_argument("the required argument for option '--" +
+                               option.getId() + "' is missing");
+    }
+
+    while(arity == Arity::Many && isValue(position + 1U)) {
+        optionValues.push_back(tokens[++position].text);
+    }
+    return position;
+}
+} // namespace
 
 namespace execHelper::config {
 OptionDescriptions::OptionDescriptions() noexcept { ; }
 
-auto OptionDescriptions::getOptionDescriptions() const noexcept
-    -> options_description {
-    return m_optionDescription;
+auto OptionDescriptions::getHelp() const noexcept -> string {
+    size_t width = 0U;
+    for(const auto* option : m_ordered) {
+        width = max(width, getNames(*option).size() + 3U);
+    }
+    width = min(width, MAX_NAMES_WIDTH);
+
+    string help;
+    for(const auto* option : m_ordered) {
+        if(!help.empty()) {
+            help.push_back('\n');
+        }
+        const auto names = "  " + getNames(*option);
+        help.append(names);
+        if(names.size() < width) {
+            help.append(width - names.size(), ' ');
+        } else {
+            help.append("\n").append(width, ' ');
+        }
+        appendExplanation(option->getExplanation(), width, &help);
+    }
+    return help;
+}
+
+void OptionDescriptions::addOption(
+    std::unique_ptr<OptionInterface> option) noexcept {
+    auto id = option->getId();
+    if(m_options.contains(id)) {
+        LOG(warning) << "Option '" << id << "' is already registered";
+        return;
+    }
+
+    const auto* registered = option.get();
+    m_optionKeys.emplace_back("--" + id);
+    m_longOptions.emplace(id, registered);
+    for(const auto& argumentOption : option->getArgumentOptions()) {
+        if(argumentOption.size() == 1U) {
+            m_optionKeys.emplace_back("-" + argumentOption);
+            m_shortOptions.emplace(argumentOption.front(), registered);
+        } else {
+            m_optionKeys.emplace_back("--" + argumentOption);
+            m_longOptions.emplace(argumentOption, registered);
+        }
+    }
+    m_ordered.push_back(registered);
+    m_options.emplace(std::move(id), std::move(option));
 }
 
 auto OptionDescriptions::setPositionalArgument(
@@ -33,24 +207,17 @@ auto OptionDescriptions::getOptionsMap(VariablesMap& variablesMap,
                                        const Args& args,
                                        bool allowUnregistered) const noexcept
     -> bool {
-    variables_map optionsMap;
-    auto commandLineParser =
-        command_line_parser(static_cast<int>(args.size()), args.data());
-    commandLineParser.options(m_optionDescription);
-
-    // Assign positional arguments
-    positional_options_description positionalOptionsDesc;
-    if(m_positional) {
-        positionalOptionsDesc.add(m_positional.value().c_str(), -1);
-        commandLineParser.positional(positionalOptionsDesc);
-    }
-    if(allowUnregistered) {
-        commandLineParser.allow_unregistered();
-    }
+    return getOptionsMap(variablesMap, CommandLine(args), allowUnregistered);
+}
 
+auto OptionDescriptions::getOptionsMap(VariablesMap& variablesMap,
+                                       const CommandLine& commandLine,
+                                       bool allowUnregistered) const noexcept
+    -> bool {
+    CollectedValues values;
     try {
-        store(commandLineParser.run(), optionsMap);
-    } catch(const boost::program_options::unknown_option& e) {
+        values = collect(commandLine.getTokens(), allowUnregistered);
+    } catch(const UnrecognisedOptionError& e) {
         user_feedback_error(
             "Could not parse command line arguments: " << e.what());
         return false;
@@ -59,9 +226,8 @@ auto OptionDescriptions::getOptionsMap(VariablesMap& variablesMap,
         return false;
     }
 
-    notify(optionsMap);
     try {
-        toMap(variablesMap, optionsMap);
+        toMap(variablesMap, values);
     } catch(const std::invalid_argument& e) {
         user_feedback_error(e.what());
         return false;
@@ -69,24 +235,104 @@ auto OptionDescriptions::getOptionsMap(VariablesMap& variablesMap,
     return true;
 }
 
-void OptionDescriptions::toMap(VariablesMap& variablesMap,
-                               const variables_map& optionsMap) const {
-    for(const auto& option : optionsMap) {
-        if(m_options.contains(option.first)) {
-            try {
-                m_options.at(option.first)->toMap(variablesMap, optionsMap);
-            } catch(const boost::bad_any_cast& e) {
-                LOG(error) << "Failed to parse '" << option.first
-                           << "': " << e.what();
-                throw invalid_argument(
-                    string("Failed to parse value for option '")
-                        .append(option.first));
-            } catch(const invalid_argument& e) {
-                LOG(error) << e.what();
-                throw invalid_argument(
-                    string("Failed to parse value for option '")
-                        .append(option.first));
+auto OptionDescriptions::findLongOption(string_view name) const
+    -> const OptionInterface* {
+    if(name.empty()) {
+        return nullptr;
+    }
+
+    auto found = m_longOptions.lower_bound(name);
+    if(found == m_longOptions.end() || !found->first.starts_with(name)) {
+        return nullptr;
+    }
+    if(found->first == name) {
+        return found->second;
+    }
+
+    // Accept abbreviations that only match a single option
+    const auto* option = found->second;
+    for(; found != m_longOptions.end() && found->first.starts_with(name);
+        ++found) {
+        if(found->second != option) {
+            throw invalid_argument("option '--" + string(name) +
+                                   "' is ambiguous");
+        }
+    }
+    return option;
+}
+
+auto OptionDescriptions::collect(const Tokens& tokens,
+                                 bool allowUnregistered) const
+    -> CollectedValues {
+    const OptionInterface* positional = nullptr;
+    if(m_positional && m_options.contains(*m_positional)) {
+        positional = m_options.find(*m_positional)->second.get();
+    }
+
+    CollectedValues values;
+    for(size_t position = 0U; position < tokens.size(); ++position) {
+        const auto& token = tokens[position];
+        switch(token.kind) {
+        case Token::Kind::Long: {
+            const auto* option = findLongOption(token.text);
+            if(option != nullptr) {
+                position = collectValues(*option, token.value, tokens,
+                                         position, &values);
+            } else if(!allowUnregistered) {
+                throw UnrecognisedOptionError("--" + string(token.text));
+            }
+            break;
+        }
+        case Token::Kind::Short:
+            for(size_t index = 0U; index < token.text.size(); ++index) {
+                auto option = m_shortOptions.find(token.text[index]);
+                if(option == m_shortOptions.end()) {
+                    if(!allowUnregistered) {
+                        throw UnrecognisedOptionError(
+                            string("-").append(1U, token.text[index]));
+                    }
+                    break;
+                }
+
+                // Everything following an option that takes values is its
+                // value, e.g. -j4
+                const auto rest = token.text.substr(index + 1U);
+                if(option->second->getArity() == Arity::None) {
+                    collectValues(*option->second, std::nullopt, tokens,
+                                  position, &values);
+                    continue;
+                }
+                position = collectValues(
+                    *option->second,
+                    rest.empty() ? std::nullopt : optional<string_view>(rest),
+                    tokens, position, &values);
+                break;
             }
+            break;
+        case Token::Kind::Value:
+        case Token::Kind::Positional:
+            if(positional != nullptr) {
+                values[positional].push_back(token.text);
+            } else if(!allowUnregistered) {
+                throw invalid_argument("too many positional options have "
+                                       "been specified on the command line");
+            }
+            break;
+        }
+    }
+    return values;
+}
+
+void OptionDescriptions::toMap(VariablesMap& variablesMap,
+                               const CollectedValues& values) const {
+    for(const auto& [option, optionValues] : values) {
+        try {
+            option->toMap(variablesMap, optionValues);
+        } catch(const invalid_argument& e) {
+            LOG(error) << e.what();
+            throw invalid_argument(
+                string("Failed to parse value for option '")
+                    .append(option->getId()));
         }
     }
 }
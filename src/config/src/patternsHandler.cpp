@@ -14,6 +14,7 @@ using std::move;
 using std::optional;
 using std::pair;
 using std::string;
+using std::string_view;
 using std::transform;
 
 namespace execHelper::config {
@@ -41,15 +42,15 @@ void PatternsHandler::addPattern(const Pattern& pattern) noexcept {
     m_patterns.emplace(pattern.getKey(), pattern);
 }
 
-auto PatternsHandler::contains(const PatternKey& key) const noexcept -> bool {
+auto PatternsHandler::contains(string_view key) const noexcept -> bool {
     return m_patterns.contains(key);
 }
 
-auto PatternsHandler::getPattern(const PatternKey& key) const noexcept
+auto PatternsHandler::getPattern(string_view key) const noexcept
     -> const Pattern& {
-    const PatternCollection& constPatterns = m_patterns;
-    ensures(constPatterns.contains(key));
-    return constPatterns.at(key);
+    auto pattern = m_patterns.find(key);
+    ensures(pattern != m_patterns.end());
+    return pattern->second;
 }
 
 auto PatternsHandler::getDefaultPatternMap(const PatternKey& key) noexcept
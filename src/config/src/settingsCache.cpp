@@ -0,0 +1,597 @@
+#include "settingsCache.h"
+
+#include <charconv>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "logger.h"
+#include "pathManipulation.h"
+
+using std::error_code;
+using std::ifstream;
+using std::istreambuf_iterator;
+using std::nullopt;
+using std::ofstream;
+using std::optional;
+using std::set;
+using std::string;
+using std::string_view;
+using std::vector;
+
+namespace filesystem = std::filesystem;
+
+using execHelper::config::LongOption;
+using execHelper::config::Path;
+using execHelper::config::Paths;
+using execHelper::config::Pattern;
+using execHelper::config::PatternKey;
+using execHelper::config::PatternSettingsPair;
+using execHelper::config::Patterns;
+using execHelper::config::PatternValues;
+using execHelper::config::SettingsKey;
+using execHelper::config::SettingsNode;
+using execHelper::config::SettingsValues;
+using execHelper::config::ShortOption;
+using execHelper::config::fnv1a;
+using execHelper::config::writeAtomically;
+
+namespace {
+const string_view MAGIC("EHSC");
+const uint32_t FORMAT_VERSION = 1U;
+const string_view COMPLETION_HEADER("EHCI 1");
+
+/**
+ * \brief How the values of a node are stored in the cache
+ */
+enum class NodeKind : uint8_t {
+    NoValues = 0U,  //!< brief The node has no values
+    Values = 1U,    //!< brief The values of the node follow
+    Duplicate = 2U, //!< brief A node with the key of an earlier sibling
+};
+
+/**
+ * \brief Identifies the exact version of a settings file a cache belongs to
+ */
+struct Stamp {
+    string path;          //!< brief The absolute path of the settings file
+    int64_t modified = 0; //!< brief The modification time of the file
+    uint64_t size = 0U;   //!< brief The size of the content
+    uint64_t hash = 0U;   //!< brief The hash of the content
+
+    auto operator==(const Stamp& other) const noexcept -> bool {
+        return path == other.path && modified == other.modified &&
+               size == other.size && hash == other.hash;
+    }
+};
+
+auto getStamp(const Path& settingsFile, string_view content) noexcept
+    -> optional<Stamp> {
+    error_code error;
+    auto path = filesystem::weakly_canonical(settingsFile, error);
+    if(error) {
+        return nullopt;
+    }
+    auto modified = filesystem::last_write_time(path, error);
+    if(error) {
+        return nullopt;
+    }
+    return Stamp{path.string(),
+                 static_cast<int64_t>(modified.time_since_epoch().count()),
+                 content.size(), fnv1a(content)};
+}
+
+/**
+ * \brief Serializes values to a little endian byte buffer
+ */
+class Writer {
+  public:
+    void write(uint64_t value) {
+        for(auto i = 0U; i < sizeof(value); ++i) {
+            m_buffer.push_back(static_cast<char>(value & 0xFFU));
+            value >>= 8U;
+        }
+    }
+
+    void write(uint8_t value) { m_buffer.push_back(static_cast<char>(value)); }
+
+    void write(string_view value) {
+        write(static_cast<uint64_t>(value.size()));
+        m_buffer.append(value);
+    }
+
+    void write(const Stamp& stamp) {
+        write(string_view(stamp.path));
+        write(static_cast<uint64_t>(stamp.modified));
+        write(stamp.size);
+        write(stamp.hash);
+    }
+
+    void write(const Pattern& pattern) {
+        write(string_view(pattern.getKey()));
+        write(static_cast<uint64_t>(pattern.getValues().size()));
+        for(const auto& value : pattern.getValues()) {
+            write(string_view(value));
+        }
+        const auto& shortOption = pattern.getShortOption();
+        write(static_cast<uint8_t>(shortOption ? 1U : 0U));
+        if(shortOption) {
+            write(static_cast<uint8_t>(*shortOption));
+        }
+        const auto& longOption = pattern.getLongOption();
+        write(static_cast<uint8_t>(longOption ? 1U : 0U));
+        if(longOption) {
+            write(string_view(*longOption));
+        }
+    }
+
+    void write(const SettingsNode& node) {
+        write(string_view(node.key()));
+        writeValues(node);
+    }
+
+    [[nodiscard]] auto buffer() const noexcept -> const string& {
+        return m_buffer;
+    }
+
+  private:
+    void writeValues(const SettingsNode& node) {
+        const auto values = node.values();
+        if(!values) {
+            write(static_cast<uint8_t>(NodeKind::NoValues));
+            return;
+        }
+        write(static_cast<uint8_t>(NodeKind::Values));
+        write(static_cast<uint64_t>(values->size()));
+
+        // Only the first child with a given key can be looked up, later ones
+        // are only visible as a value
+        set<string_view> written;
+        for(const auto& key : *values) {
+            write(string_view(key));
+            if(!written.insert(key).second) {
+                write(static_cast<uint8_t>(NodeKind::Duplicate));
+                continue;
+            }
+            writeValues(node[key]);
+        }
+    }
+
+    string m_buffer;
+};
+
+/**
+ * \brief Deserializes the values written by a \ref Writer. Every read is
+ * bounds checked, so a truncated or corrupt buffer is rejected instead of read
+ * past its end.
+ */
+class Reader {
+  public:
+    explicit Reader(string_view buffer) noexcept : m_buffer(buffer) {}
+
+    auto read(uint64_t* value) noexcept -> bool {
+        if(m_buffer.size() < sizeof(*value)) {
+            return false;
+        }
+        *value = 0U;
+        for(auto i = sizeof(*value); i > 0U; --i) {
+            *value <<= 8U;
+            *value |= static_cast<unsigned char>(m_buffer[i - 1U]);
+        }
+        m_buffer.remove_prefix(sizeof(*value));
+        return true;
+    }
+
+    auto read(uint8_t* value) noexcept -> bool {
+        if(m_buffer.empty()) {
+            return false;
+        }
+        *value = static_cast<unsigned char>(m_buffer.front());
+        m_buffer.remove_prefix(1U);
+        return true;
+    }
+
+    auto read(string* value) -> bool {
+        uint64_t size = 0U;
+        if(!read(&size) || m_buffer.size() < size) {
+            return false;
+        }
+        value->assign(m_buffer.substr(0U, size));
+        m_buffer.remove_prefix(size);
+        return true;
+    }
+
+    auto read(Stamp* stamp) -> bool {
+        uint64_t modified = 0U;
+        if(!read(&stamp->path) || !read(&modified) || !read(&stamp->size) ||
+           !read(&stamp->hash)) {
+            return false;
+        }
+        stamp->modified = static_cast<int64_t>(modified);
+        return true;
+    }
+
+    auto read(Patterns* patterns) -> bool {
+        uint64_t nbOfPatterns = 0U;
+        if(!readCount(&nbOfPatterns)) {
+            return false;
+        }
+        patterns->reserve(nbOfPatterns);
+        for(uint64_t i = 0U; i < nbOfPatterns; ++i) {
+            PatternKey key;
+            uint64_t nbOfValues = 0U;
+            if(!read(&key) || !readCount(&nbOfValues)) {
+                return false;
+            }
+            PatternValues values(nbOfValues);
+            for(auto& value : values) {
+                if(!read(&value)) {
+                    return false;
+                }
+            }
+
+            uint8_t hasOption = 0U;
+            ShortOption shortOption;
+            if(!read(&hasOption)) {
+                return false;
+            }
+            if(hasOption != 0U) {
+                uint8_t option = 0U;
+                if(!read(&option)) {
+                    return false;
+                }
+                shortOption = static_cast<char>(option);
+            }
+            LongOption longOption;
+            if(!read(&hasOption)) {
+                return false;
+            }
+            if(hasOption != 0U) {
+                longOption.emplace();
+                if(!read(&*longOption)) {
+                    return false;
+                }
+            }
+            patterns->emplace_back(key, values, shortOption, longOption);
+        }
+        return true;
+    }
+
+    auto read(optional<SettingsNode>* node) -> bool {
+        SettingsKey key;
+        if(!read(&key)) {
+            return false;
+        }
+        node->emplace(key);
+        return readValues(&**node);
+    }
+
+    [[nodiscard]] auto empty() const noexcept -> bool {
+        return m_buffer.empty();
+    }
+
+  private:
+    /**
+     * Reads a number of elements that each take at least one byte, so
+     * corrupt counts are rejected before anything is allocated for them
+     */
+    auto readCount(uint64_t* count) noexcept -> bool {
+        return read(count) && *count <= m_buffer.size();
+    }
+
+    auto readValues(SettingsNode* node) -> bool {
+        uint8_t kind = 0U;
+        if(!read(&kind)) {
+            return false;
+        }
+        switch(static_cast<NodeKind>(kind)) {
+        case NodeKind::NoValues:
+            return true;
+        case NodeKind::Values:
+            break;
+        default:
+            return false;
+        }
+
+        uint64_t nbOfValues = 0U;
+        if(!readCount(&nbOfValues) || !node->add(SettingsValues())) {
+            return false;
+        }
+        for(uint64_t i = 0U; i < nbOfValues; ++i) {
+            SettingsKey key;
+            if(!read(&key) || !readChild(node, key)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    auto readChild(SettingsNode* node, const SettingsKey& key) -> bool {
+        if(!m_buffer.empty() && static_cast<NodeKind>(m_buffer.front()) ==
+                                    NodeKind::Duplicate) {
+            m_buffer.remove_prefix(1U);
+            return node->contains(key) && node->add(key);
+        }
+        if(node->contains(key)) {
+            return false;
+        }
+        return readValues(&node->child(key));
+    }
+
+    string_view m_buffer;
+};
+
+auto toHex(uint64_t value) -> string {
+    std::ostringstream stream;
+    stream << std::hex << std::setw(sizeof(value) * 2U) << std::setfill('0')
+           << value;
+    return stream.str();
+}
+
+/**
+ * Returns the line that identifies the current version of the given path in
+ * a completion index: its modification time, its size and the path itself
+ *
+ * \param[in] path  The file or directory
+ * \returns The line for the path. A path that does not exist is marked as
+ * such.
+ */
+auto getStampLine(const Path& path) -> string {
+    error_code error;
+    const auto modified = filesystem::last_write_time(path, error);
+    if(error) {
+        return "- - " + path.string();
+    }
+    const auto size = filesystem::is_regular_file(path, error)
+                          ? filesystem::file_size(path, error)
+                          : 0U;
+    return std::to_string(modified.time_since_epoch().count()) + " " +
+           std::to_string(error ? 0U : size) + " " + path.string();
+}
+
+/**
+ * Returns the first line of a completion index. It contains the version of
+ * the binary, as the completion words depend on its options and plugins.
+ *
+ * \param[in] version   The version of the binary
+ * \returns The header line
+ */
+auto getCompletionHeader(string_view version) -> string {
+    return string(COMPLETION_HEADER).append(" ").append(version);
+}
+} // namespace
+
+namespace execHelper::config {
+auto getCacheDirectory(const EnvironmentCollection& env) noexcept
+    -> optional<Path> {
+    Path cacheDirectory;
+    if(env.contains("XDG_CACHE_HOME") && !env.at("XDG_CACHE_HOME").empty()) {
+        cacheDirectory = env.at("XDG_CACHE_HOME");
+    } else {
+        auto homeDirectory = getHomeDirectory(env);
+        if(!homeDirectory) {
+            return nullopt;
+        }
+        cacheDirectory = *homeDirectory / ".cache";
+    }
+    return cacheDirectory / "exec-helper";
+}
+
+auto getSettingsCacheFile(const Path& settingsFile,
+                          const EnvironmentCollection& env) noexcept
+    -> optional<Path> {
+    auto cacheDirectory = getCacheDirectory(env);
+    if(!cacheDirectory) {
+        return nullopt;
+    }
+    return getSettingsCacheFileIn(settingsFile, *cacheDirectory);
+}
+
+auto getSettingsCacheFileIn(const Path& settingsFile,
+                            const Path& cacheDirectory) noexcept
+    -> optional<Path> {
+    error_code error;
+    const auto path = filesystem::weakly_canonical(settingsFile, error);
+    if(error) {
+        return nullopt;
+    }
+    return cacheDirectory / (toHex(fnv1a(path.string())) + ".cache");
+}
+
+auto readSettingsCache(const Path& cacheFile, const Path& settingsFile,
+                       string_view content, string_view version) noexcept
+    -> optional<PatternSettingsPair> {
+    try {
+        const auto stamp = getStamp(settingsFile, content);
+        if(!stamp) {
+            return nullopt;
+        }
+
+        ifstream stream(cacheFile, std::ios::binary);
+        if(!stream) {
+            return nullopt;
+        }
+        const string buffer((istreambuf_iterator<char>(stream)),
+                            istreambuf_iterator<char>());
+
+        string_view data(buffer);
+        if(data.substr(0U, MAGIC.size()) != MAGIC) {
+            LOG(debug) << "Ignoring invalid settings cache " << cacheFile;
+            return nullopt;
+        }
+        data.remove_prefix(MAGIC.size());
+
+        Reader reader(data);
+        uint64_t formatVersion = 0U;
+        string cachedVersion;
+        Stamp cachedStamp;
+        if(!reader.read(&formatVersion) || formatVersion != FORMAT_VERSION ||
+           !reader.read(&cachedVersion) || cachedVersion != version ||
+           !reader.read(&cachedStamp) || !(cachedStamp == *stamp)) {
+            LOG(debug) << "Settings cache " << cacheFile << " is out of date";
+            return nullopt;
+        }
+
+        Patterns patterns;
+        optional<SettingsNode> settings;
+        if(!reader.read(&patterns) || !reader.read(&settings) ||
+           !reader.empty()) {
+            LOG(warning) << "Ignoring corrupt settings cache " << cacheFile;
+            return nullopt;
+        }
+        LOG(debug) << "Read settings from cache " << cacheFile;
+        return PatternSettingsPair(std::move(patterns), std::move(*settings));
+    } catch(const std::exception& e) {
+        LOG(warning) << "Could not read settings cache " << cacheFile << ": "
+                     << e.what();
+        return nullopt;
+    }
+}
+
+auto writeSettingsCache(const Path& cacheFile, const Path& settingsFile,
+                        string_view content,
+                        const PatternSettingsPair& settings,
+                        string_view version) noexcept -> bool {
+    try {
+        const auto stamp = getStamp(settingsFile, content);
+        if(!stamp) {
+            return false;
+        }
+
+        Writer writer;
+        writer.write(static_cast<uint64_t>(FORMAT_VERSION));
+        writer.write(version);
+        writer.write(*stamp);
+        writer.write(static_cast<uint64_t>(settings.first.size()));
+        for(const auto& pattern : settings.first) {
+            writer.write(pattern);
+        }
+        writer.write(settings.second);
+
+        if(!writeAtomically(cacheFile, string(MAGIC) + writer.buffer())) {
+            return false;
+        }
+        LOG(debug) << "Wrote settings cache " << cacheFile;
+        return true;
+    } catch(const std::exception& e) {
+        LOG(warning) << "Could not write settings cache " << cacheFile << ": "
+                     << e.what();
+        return false;
+    }
+}
+
+auto getCompletionIndexFile(const Path& settingsFile,
+                            const EnvironmentCollection& env) noexcept
+    -> optional<Path> {
+    auto cacheFile = getSettingsCacheFile(settingsFile, env);
+    if(!cacheFile) {
+        return nullopt;
+    }
+    return cacheFile->replace_extension(".completion");
+}
+
+auto readCompletionIndex(const Path& indexFile, string_view version) noexcept
+    -> optional<vector<string>> {
+    try {
+        ifstream stream(indexFile);
+        string line;
+        if(!getline(stream, line) || line != getCompletionHeader(version) ||
+           !getline(stream, line)) {
+            return nullopt;
+        }
+
+        size_t nbOfStamps = 0U;
+        const auto* end = line.data() + line.size();
+        if(std::from_chars(line.data(), end, nbOfStamps).ptr != end) {
+            return nullopt;
+        }
+        for(size_t i = 0U; i < nbOfStamps; ++i) {
+            if(!getline(stream, line)) {
+                return nullopt;
+            }
+            const auto sizeEnd = line.find(' ', line.find(' ') + 1U);
+            if(sizeEnd == string::npos ||
+               line != getStampLine(line.substr(sizeEnd + 1U))) {
+                return nullopt;
+            }
+        }
+
+        vector<string> words;
+        while(getline(stream, line)) {
+            words.push_back(line);
+        }
+        return words;
+    } catch(const std::exception&) {
+        return nullopt;
+    }
+}
+
+auto writeCompletionIndex(const Path& indexFile, const Paths& paths,
+                          const vector<string>& words,
+                          string_view version) noexcept -> bool {
+    try {
+        auto content = getCompletionHeader(version);
+        content.append("\n").append(std::to_string(paths.size()));
+        for(const auto& path : paths) {
+            content.append("\n").append(getStampLine(path));
+        }
+        for(const auto& word : words) {
+            if(word.find('\n') == string::npos) {
+                content.append("\n").append(word);
+            }
+        }
+        content.push_back('\n');
+        return writeAtomically(indexFile, content);
+    } catch(const std::exception& e) {
+        LOG(warning) << "Could not write completion index " << indexFile
+                     << ": " << e.what();
+        return false;
+    }
+}
+
+auto fnv1a(string_view data) noexcept -> uint64_t {
+    const uint64_t OFFSET_BASIS = 14695981039346656037ULL;
+    const uint64_t PRIME = 1099511628211ULL;
+
+    uint64_t hash = OFFSET_BASIS;
+    for(const auto character : data) {
+        hash ^= static_cast<unsigned char>(character);
+        hash *= PRIME;
+    }
+    return hash;
+}
+
+auto writeAtomically(const Path& file, string_view content) -> bool {
+    error_code error;
+    filesystem::create_directories(file.parent_path(), error);
+    if(error) {
+        LOG(debug) << "Could not create the cache directory "
+                   << file.parent_path() << ": " << error.message();
+        return false;
+    }
+
+    Path tmpFile(file);
+    tmpFile += "." + toHex(std::random_device()()) + ".tmp";
+    ofstream stream(tmpFile, std::ios::binary | std::ios::trunc);
+    stream.write(content.data(), static_cast<std::streamsize>(content.size()));
+    stream.close();
+    if(!stream) {
+        filesystem::remove(tmpFile, error);
+        return false;
+    }
+    filesystem::rename(tmpFile, file, error);
+    if(error) {
+        filesystem::remove(tmpFile, error);
+        return false;
+    }
+    return true;
+}
+} // namespace execHelper::config
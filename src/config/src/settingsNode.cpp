@@ -1,9 +1,11 @@
 #include "settingsNode.h"
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <optional>
 #include <ostream>
+#include <utility>
 
 #include <log/assertions.h>
 
@@ -11,11 +13,16 @@
 
 using std::all_of;
 using std::initializer_list;
-using std::make_unique;
+using std::lower_bound;
+using std::make_shared;
 using std::ostream;
+using std::size_t;
 using std::string;
+using std::string_view;
+using std::upper_bound;
 
 using execHelper::config::SettingsKeys;
+using execHelper::config::SettingsKeysView;
 using execHelper::config::SettingsValues;
 
 namespace {
@@ -44,8 +51,8 @@ SettingsNode::SettingsNode(SettingsKey key) noexcept : m_key(std::move(key)) {
 
 SettingsNode::SettingsNode( // NOLINT(misc-no-recursion)
     const SettingsNode& other) noexcept
-    : m_key(other.m_key) {
-    deepCopy(other); // NOLINT(misc-no-recursion)
+    : m_key(other.m_key), m_values(share(other.m_values)) {
+    ;
 }
 
 SettingsNode::SettingsNode(SettingsNode&& other) noexcept
@@ -59,7 +66,7 @@ auto SettingsNode::operator=(const SettingsNode& other) noexcept
     -> SettingsNode& {
     if(this != &other) {
         m_key = other.m_key;
-        deepCopy(other);
+        copyValues(other);
     }
     return *this;
 }
@@ -77,13 +84,14 @@ auto SettingsNode::operator==( // NOLINT(misc-no-recursion)
     if(!m_values || !other.m_values) {
         return (!m_values && !other.m_values);
     }
-    if(m_values->size() != other.m_values->size()) {
+    if(m_values->nodes.size() != other.m_values->nodes.size()) {
         return false;
     }
-    return all_of(m_values->begin(), m_values->end(),
+    return all_of(m_values->nodes.begin(), m_values->nodes.end(),
                   [&other](const auto& value) { // NOLINT(misc-no-recursion)
-                      return other.contains(value.m_key) &&
-                             other[value.m_key] == // NOLINT(misc-no-recursion)
+                      const auto* otherValue = other.find(value.m_key);
+                      return otherValue != nullptr &&
+                             *otherValue == // NOLINT(misc-no-recursion)
                                  value;
                   });
 }
@@ -94,57 +102,107 @@ auto SettingsNode::operator!=(
     return !(*this == other);
 }
 
-auto SettingsNode::operator[](const SettingsKey& key) noexcept
-    -> SettingsNode& {
-    if(contains(key)) {
-        auto value =
-            find_if(m_values->begin(), m_values->end(),
-                    [&key](const auto& value) { return value.m_key == key; });
-        ensures(value != m_values->end());
+auto SettingsNode::operator[](string_view key) noexcept -> SettingsNode& {
+    auto& value = child(key);
+    // The caller may modify the child after this node was copied
+    m_values->shareable = false;
+    return value;
+}
+
+auto SettingsNode::child(string_view key) noexcept -> SettingsNode& {
+    auto* value = find(key);
+    if(value != nullptr) {
         return *value;
     }
-    if(!add(key)) {
-        LOG(warning) << "Failed to add key '" << key << "'";
-    }
-    return m_values->back();
+    return addChild(SettingsKey(key));
 }
 
-auto SettingsNode::operator[](const SettingsKey& key) const noexcept
+auto SettingsNode::operator[](string_view key) const noexcept
     -> const SettingsNode& {
-    expectsMessage(contains(key), "Key must exist");
-    auto value =
-        find_if(m_values->begin(), m_values->end(),
-                [&key](const auto& value) { return value.m_key == key; });
-    ensures(value != m_values->end());
+    const auto* value = find(key);
+    expectsMessage(value != nullptr, "Key must exist");
     return *value;
 }
 
-auto SettingsNode::contains(const SettingsKey& key) const noexcept -> bool {
+auto SettingsNode::contains(string_view key) const noexcept -> bool {
+    return find(key) != nullptr;
+}
+
+auto SettingsNode::contains(const SettingsKeys& key) const noexcept -> bool {
+    return find(key) != nullptr;
+}
+
+auto SettingsNode::contains(SettingsKeysView key) const noexcept -> bool {
+    return find(key) != nullptr;
+}
+
+auto SettingsNode::find(string_view key) const noexcept
+    -> const SettingsNode* {
     if(!m_values) {
-        return false;
+        return nullptr;
+    }
+    const auto& nodes = m_values->nodes;
+    auto position =
+        lower_bound(m_values->index.begin(), m_values->index.end(), key,
+                    [&nodes](size_t position, string_view key) {
+                        return nodes[position].m_key < key;
+                    });
+    if(position == m_values->index.end() || nodes[*position].m_key != key) {
+        return nullptr;
     }
-    return std::any_of(
-        m_values->begin(), m_values->end(),
-        [&key](const auto& value) { return value.m_key == key; });
+    return &nodes[*position];
 }
 
-auto SettingsNode::contains(const SettingsKeys& key) const noexcept -> bool {
+auto SettingsNode::find(string_view key) noexcept -> SettingsNode* {
+    detach();
+    return const_cast<SettingsNode*>( // NOLINT(cppcoreguidelines-pro-type-const-cast)
+        std::as_const(*this).find(key));
+}
+
+auto SettingsNode::find(const SettingsKeys& key) const noexcept
+    -> const SettingsNode* {
+    return findPath(key);
+}
+
+auto SettingsNode::find(SettingsKeysView key) const noexcept
+    -> const SettingsNode* {
+    return findPath(key);
+}
+
+template <typename Keys>
+auto SettingsNode::findPath(const Keys& key) const noexcept
+    -> const SettingsNode* {
     const SettingsNode* settings = this;
     for(const auto& keyPart : key) {
-        if(settings->contains(keyPart)) {
-            settings = settings->at(keyPart);
-        } else {
-            return false;
+        settings = settings->find(keyPart);
+        if(settings == nullptr) {
+            return nullptr;
         }
     }
-    return true;
+    return settings;
 }
 
-auto SettingsNode::add(const SettingsValue& newValue) noexcept -> bool {
+auto SettingsNode::addChild(SettingsKey key) noexcept -> SettingsNode& {
     if(!m_values) {
-        m_values = make_unique<SettingsNodeCollection>();
+        m_values = make_shared<Children>();
     }
-    m_values->emplace_back(SettingsNode(newValue));
+    detach();
+    auto& nodes = m_values->nodes;
+    auto& index = m_values->index;
+
+    // Insert after the existing children with the same key, so lookups keep
+    // finding the child that was added first
+    auto position =
+        upper_bound(index.begin(), index.end(), key,
+                    [&nodes](const SettingsKey& key, size_t position) {
+                        return key < nodes[position].m_key;
+                    });
+    index.insert(position, nodes.size());
+    return nodes.emplace_back(move(key));
+}
+
+auto SettingsNode::add(const SettingsValue& newValue) noexcept -> bool {
+    addChild(newValue);
     return true;
 }
 
@@ -185,12 +243,7 @@ auto SettingsNode::add(
     const SettingsValues& newValue) noexcept -> bool {
     SettingsNode* settings = this;
     for(const auto& parentKey : key) {
-        if(!settings->contains(parentKey)) {
-            if(!settings->add(parentKey)) {
-                LOG(warning) << "Failed to add key '" << parentKey << "'";
-            }
-        }
-        settings = settings->at(parentKey);
+        settings = &settings->child(parentKey);
     }
     return settings->add(newValue);
 }
@@ -202,12 +255,14 @@ auto SettingsNode::add(const SettingsKey& key,
 
 auto SettingsNode::add(const SettingsValues& newValue) noexcept -> bool {
     if(!m_values) {
-        m_values = make_unique<SettingsNodeCollection>();
+        m_values = make_shared<Children>();
+    }
+    detach();
+    m_values->nodes.reserve(m_values->nodes.size() + newValue.size());
+    m_values->index.reserve(m_values->index.size() + newValue.size());
+    for(const auto& value : newValue) {
+        addChild(value);
     }
-    m_values->reserve(m_values->size() + newValue.size());
-    std::transform(newValue.begin(), newValue.end(),
-                   std::back_inserter(*m_values),
-                   [](auto&& value) { return SettingsNode(value); });
     return true;
 }
 
@@ -216,8 +271,8 @@ auto SettingsNode::add(const SettingsKey& key,
     return add(SettingsKeys({key}), newValue);
 }
 
-auto SettingsNode::clear(const SettingsKey& key) noexcept -> bool {
-    return clear(SettingsKeys({key}));
+auto SettingsNode::clear(string_view key) noexcept -> bool {
+    return clear(SettingsKeys({SettingsKey(key)}));
 }
 
 auto SettingsNode::clear(const SettingsKeys& keys) noexcept -> bool {
@@ -229,30 +284,32 @@ auto SettingsNode::clear(const SettingsKeys& keys) noexcept -> bool {
         return true;
     }
 
-    SettingsNode* settings = this;
+    SettingsNode* parent = this;
     for(auto key = keys.begin(); key != keys.end() - 1; ++key) {
-        settings = settings->at(*key);
+        parent = parent->find(*key);
     }
-    for(auto value = settings->m_values->begin();
-        value != settings->m_values->end(); ++value) {
-        if(value->m_key == keys.back()) {
-            settings->m_values->erase(value);
-            return true;
+    const auto* value = parent->find(keys.back());
+
+    auto& children = *parent->m_values;
+    const auto removed = static_cast<size_t>(value - children.nodes.data());
+    children.nodes.erase(children.nodes.begin() +
+                         static_cast<std::ptrdiff_t>(removed));
+    children.index.erase(
+        std::remove(children.index.begin(), children.index.end(), removed),
+        children.index.end());
+    for(auto& position : children.index) {
+        if(position > removed) {
+            --position;
         }
     }
-    return false;
+    return true;
 }
 
-auto SettingsNode::values() const noexcept -> std::optional<SettingsValues> {
+auto SettingsNode::values() const noexcept -> std::optional<ValuesView> {
     if(!m_values) {
         return std::nullopt;
     }
-    SettingsValues result;
-    result.reserve(m_values->size());
-    std::transform(m_values->begin(), m_values->end(),
-                   std::back_inserter(result),
-                   [](const auto& value) { return value.m_key; });
-    return result;
+    return ValuesView(m_values->nodes);
 }
 
 auto SettingsNode::key() const noexcept -> const SettingsKey& { return m_key; }
@@ -263,67 +320,71 @@ void SettingsNode::swap(SettingsNode& other) noexcept {
 }
 
 void SettingsNode::overwrite(const SettingsNode& newSettings) noexcept {
-    std::vector<std::string> children =
-        newSettings.values().value_or(std::vector<std::string>());
-    for(const auto& key : children) {
-        const SettingsNode& newValue = newSettings[key];
-        if(!contains(key)) {
-            if(!add(key)) {
-                LOG(warning) << "Failed to add key '" << key << "'";
-            }
-        }
-        at(key)->deepCopy(newValue);
+    if(!newSettings.m_values) {
+        return;
+    }
+    for(const auto& newValue : newSettings.m_values->nodes) {
+        child(newValue.m_key).copyValues(newSettings[newValue.m_key]);
     }
 }
 
-auto SettingsNode::at(const SettingsKey& key) noexcept -> SettingsNode* {
-    expectsMessage(contains(key), "Key must exist");
-    auto value =
-        std::find_if(m_values->begin(), m_values->end(),
-                     [&key](const auto& value) { return value.m_key == key; });
-    ensures(value != m_values->end());
-    return &(*value);
+auto SettingsNode::at(string_view key) noexcept -> SettingsNode* {
+    auto* value = find(key);
+    expectsMessage(value != nullptr, "Key must exist");
+    return value;
 }
 
-auto SettingsNode::at(const SettingsKey& key) const noexcept
+auto SettingsNode::at(string_view key) const noexcept
     -> const SettingsNode* {
-    expectsMessage(contains(key), "Key must exist");
-    auto value =
-        std::find_if(m_values->begin(), m_values->end(),
-                     [&key](const auto& value) { return value.m_key == key; });
-    ensures(value != m_values->end());
-    return &(*value);
+    const auto* value = find(key);
+    expectsMessage(value != nullptr, "Key must exist");
+    return value;
 }
 
 auto SettingsNode::at(const SettingsKeys& key) noexcept -> SettingsNode* {
     expectsMessage(contains(key), "Key must exist");
     SettingsNode* settings = this;
     for(const auto& keyPart : key) {
-        settings = settings->at(keyPart);
+        settings = settings->find(keyPart);
     }
     return settings;
 }
 
 auto SettingsNode::at(const SettingsKeys& key) const noexcept
     -> const SettingsNode* {
-    expectsMessage(contains(key), "Key must exist");
-    const SettingsNode* settings = this;
-    for(const auto& keyPart : key) {
-        settings = settings->at(keyPart);
-    }
-    return settings;
+    const auto* value = find(key);
+    expectsMessage(value != nullptr, "Key must exist");
+    return value;
 }
 
-void SettingsNode::deepCopy( // NOLINT(misc-no-recursion)
-    const SettingsNode& other) noexcept {
+void SettingsNode::copyValues(const SettingsNode& other) noexcept {
     if(!other.m_values) {
         return;
     }
+    m_values = share(other.m_values);
+}
+
+auto SettingsNode::share( // NOLINT(misc-no-recursion)
+    const std::shared_ptr<Children>& values) noexcept
+    -> std::shared_ptr<Children> {
+    if(!values || values->shareable) {
+        return values;
+    }
+    // Copies the direct children only: their subtrees are shared if they can
+    auto copy = make_shared<Children>(*values);
+    copy->shareable = true;
+    return copy;
+}
 
-    m_values = make_unique<SettingsNodeCollection>();
-    m_values->reserve(other.m_values->size());
-    std::copy(other.m_values->begin(), other.m_values->end(),
-              std::back_inserter(*m_values));
+void SettingsNode::detach() noexcept {
+    if(m_values && m_values.use_count() > 1) {
+        // Copies the direct children only: their subtrees remain shared
+        m_values = make_shared<Children>(*m_values);
+    }
+    if(m_values) {
+        // The children may be modified, which invalidates their conversions
+        m_values->typed.clear();
+    }
 }
 
 auto operator<<(ostream& out, const SettingsNode& settings) noexcept
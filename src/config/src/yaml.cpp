@@ -1,10 +1,16 @@
 #include "yaml.h"
 
+#include <fstream>
 #include <iostream>
+#include <iterator>
 
 #include "logger.h"
+#include "yamlParser.h"
 
+using std::ifstream;
 using std::initializer_list;
+using std::istreambuf_iterator;
+using std::make_unique;
 using std::string;
 using std::vector;
 
@@ -12,13 +18,31 @@ using execHelper::config::Path;
 using execHelper::config::SettingsNode;
 
 namespace execHelper::yaml {
-Yaml::Yaml(const Path& file) : m_yaml(file) { ; }
+Yaml::Yaml(const Path& file) {
+    ifstream stream(file, std::ios::binary);
+    if(!stream) {
+        // Let yaml-cpp report the error
+        m_yaml = make_unique<YamlWrapper>(file);
+        return;
+    }
+    m_content.assign(istreambuf_iterator<char>(stream),
+                     istreambuf_iterator<char>());
+    m_supported = YamlParser(m_content).isSupported();
+    if(!m_supported) {
+        m_yaml = make_unique<YamlWrapper>(m_content);
+    }
+}
 
-Yaml::Yaml(const string& yamlConfig) : m_yaml(yamlConfig) { ; }
+Yaml::Yaml(const string& yamlConfig)
+    : m_content(yamlConfig), m_supported(YamlParser(m_content).isSupported()) {
+    if(!m_supported) {
+        m_yaml = make_unique<YamlWrapper>(m_content);
+    }
+}
 
 auto Yaml::getValue(const initializer_list<string>& keys) -> string {
     try {
-        return m_yaml.get<string>(keys);
+        return wrapper().get<string>(keys);
     } catch(YAML::Exception& e) {
         LOG(error) << "Yaml parser threw an exception: " << e.what();
         return "";
@@ -28,7 +52,7 @@ auto Yaml::getValue(const initializer_list<string>& keys) -> string {
 auto Yaml::getValueCollection(const initializer_list<string>& keys)
     -> vector<string> {
     try {
-        return m_yaml.get<vector<string>>(keys);
+        return wrapper().get<vector<string>>(keys);
     } catch(YAML::Exception& e) {
         LOG(error) << "Yaml parser threw an exception: " << e.what();
         return {};
@@ -37,6 +61,21 @@ auto Yaml::getValueCollection(const initializer_list<string>& keys)
 
 auto Yaml::getTree(const initializer_list<string>& keys,
                    SettingsNode* settings) const noexcept -> bool {
-    return m_yaml.getTree(keys, settings);
+    if(m_supported && keys.size() == 0U) {
+        return YamlParser(m_content).getTree(settings);
+    }
+    try {
+        return wrapper().getTree(keys, settings);
+    } catch(const YAML::Exception& e) {
+        LOG(error) << "Yaml parser threw an exception: " << e.what();
+        return false;
+    }
+}
+
+auto Yaml::wrapper() const -> const YamlWrapper& {
+    if(!m_yaml) {
+        m_yaml = make_unique<YamlWrapper>(m_content);
+    }
+    return *m_yaml;
 }
 } // namespace execHelper::yaml
@@ -0,0 +1,843 @@
+#include "yamlParser.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "logger.h"
+
+using std::numeric_limits;
+using std::string;
+using std::string_view;
+using std::unordered_map;
+using std::vector;
+
+using execHelper::config::SettingsNode;
+using execHelper::config::SettingsValue;
+
+namespace {
+using namespace std::literals;
+
+const size_t END = numeric_limits<size_t>::max();
+const size_t MAX_DEPTH = 256U;
+
+/**
+ * \brief Thrown when a document is not valid or uses YAML that is not supported
+ */
+struct UnsupportedYaml : public std::runtime_error {
+  public:
+    /**
+     * Create an unsupported YAML error
+     *
+     * \param[in] msg   A message detailing the specifics of the exception
+     */
+    inline explicit UnsupportedYaml(const std::string& msg)
+        : std::runtime_error(msg) {}
+};
+
+/**
+ * \brief A scalar of the document
+ */
+struct Scalar {
+    string_view value;   //!< brief The value, in the document or the buffer
+    string buffer;       //!< brief Holds the value if it contains escapes
+    bool isNull = false; //!< brief Whether the scalar is a null value
+};
+
+inline auto isWhiteOrEnd(char character) noexcept -> bool {
+    return character == ' ' || character == '\n' || character == '\0';
+}
+
+inline auto isFlowIndicator(char character) noexcept -> bool {
+    return character == ',' || character == '[' || character == ']' ||
+           character == '{' || character == '}';
+}
+
+/**
+ * \brief Converts a document to settings, the way
+ * execHelper::yaml::YamlWrapper converts a yaml-cpp document
+ *
+ * Nodes are added to the settings while they are parsed. An alias is resolved
+ * by parsing the anchored node again: that adds exactly what the anchored node
+ * added, without keeping an intermediate representation of it.
+ */
+class Parser {
+  public:
+    explicit Parser(string_view content) noexcept : m_content(content) {}
+
+    /**
+     * Parses the document
+     *
+     * \param[out] settings The settings to add the document to. Nothing is
+     * added if it is a nullptr.
+     * \returns The number of entries of the root of the document. Zero if the
+     * root is not a mapping or sequence.
+     * \throws UnsupportedYaml  The document is not supported
+     */
+    auto parse(SettingsNode* settings) -> size_t {
+        if(m_content.find_first_of("\r\0"sv) != string_view::npos) {
+            throw UnsupportedYaml("Unsupported characters");
+        }
+        if(m_content.substr(0U, 3U) == "\xEF\xBB\xBF"sv) {
+            throw UnsupportedYaml("Byte order marks are not supported");
+        }
+
+        skipToContent();
+        if(peek() == '%') {
+            throw UnsupportedYaml("Directives are not supported");
+        }
+        if(m_content.substr(m_position, 3U) == "---"sv &&
+           isWhiteOrEnd(peek(3U))) {
+            m_position += 3U;
+            nextLine();
+        }
+
+        size_t entries = 0U;
+        if(!isEnd()) {
+            entries = parseRoot(settings);
+        }
+
+        if(m_content.substr(m_position, 3U) == "..."sv) {
+            m_position += 3U;
+            nextLine();
+            if(!atEnd()) {
+                throw UnsupportedYaml("Content after the end of the document");
+            }
+        }
+        if(!atEnd()) {
+            throw UnsupportedYaml("Unexpected content after the root node");
+        }
+        return entries;
+    }
+
+  private:
+    /**
+     * \brief Where an anchored node is located in the document
+     */
+    enum class Context {
+        MapValue,     //!< brief The value of a block mapping entry
+        SequenceItem, //!< brief An entry of a block sequence
+        Flow,         //!< brief A node in a flow collection
+    };
+
+    /**
+     * \brief A position in the document
+     */
+    struct Cursor {
+        size_t position;  //!< brief The position of the cursor
+        size_t lineStart; //!< brief The start of the line of the cursor
+    };
+
+    /**
+     * \brief The node an anchor was defined for
+     */
+    struct Anchor {
+        size_t definedAt; //!< brief The position of the anchor
+        Cursor node;      //!< brief The position right after the anchor
+        Context context;  //!< brief The context the node is in
+        size_t indent;    //!< brief The indentation of the parent block
+    };
+
+    /**
+     * \brief Limits the nesting of nodes and aliases
+     */
+    class DepthGuard {
+      public:
+        explicit DepthGuard(size_t* depth) : m_depth(depth) {
+            if(*m_depth >= MAX_DEPTH) {
+                throw UnsupportedYaml("Nesting is too deep");
+            }
+            ++(*m_depth);
+        }
+
+        DepthGuard(const DepthGuard& other) = delete;
+        DepthGuard(DepthGuard&& other) noexcept = delete;
+        ~DepthGuard() noexcept { --(*m_depth); }
+        auto operator=(const DepthGuard& other) -> DepthGuard& = delete;
+        auto operator=(DepthGuard&& other) noexcept -> DepthGuard& = delete;
+
+      private:
+        size_t* m_depth;
+    };
+
+    auto parseRoot(SettingsNode* target) -> size_t {
+        const auto character = peek();
+        if(isSequenceEntry()) {
+            return parseBlockSequence(column(), target);
+        }
+        if(character == '[' || character == '{') {
+            const auto entries = parseFlowCollection(target);
+            endOfLine();
+            nextLine();
+            return entries;
+        }
+
+        const auto start = cursor();
+        const auto indent = column();
+        Scalar scalar;
+        readBlockScalar(&scalar);
+        skipSpaces();
+        if(isMappingIndicator()) {
+            setCursor(start);
+            return parseBlockMap(indent, target);
+        }
+        endOfLine();
+        nextLine();
+        if(!isEnd()) {
+            throw UnsupportedYaml("Multi-line scalars are not supported");
+        }
+        return 0U;
+    }
+
+    auto parseBlockMap(size_t indent, SettingsNode* target) -> size_t {
+        size_t entries = 0U;
+        do {
+            if(isSequenceEntry()) {
+                throw UnsupportedYaml("Sequence entry in a mapping");
+            }
+            Scalar key;
+            readBlockScalar(&key);
+            skipSpaces();
+            if(!isMappingIndicator()) {
+                throw UnsupportedYaml("Expected a mapping key");
+            }
+            ++m_position;
+            parseMapValue(indent, addKey(key, target));
+            ++entries;
+        } while(column() == indent);
+
+        checkDedent(indent);
+        return entries;
+    }
+
+    void parseMapValue(size_t indent, SettingsNode* target) {
+        skipSeparation();
+        if(peek() == '&') {
+            defineAnchor(Context::MapValue, indent);
+        }
+        parseMapValueContent(indent, target);
+    }
+
+    void parseMapValueContent(size_t indent, SettingsNode* target) {
+        skipSeparation();
+        if(atLineEnd()) {
+            nextLine();
+            if(isEnd()) {
+                return;
+            }
+            if(column() > indent) {
+                parseBlockNode(indent + 1U, target);
+            } else if(column() == indent && isSequenceEntry()) {
+                parseBlockSequence(indent, target);
+            }
+            return;
+        }
+        parseInlineNode(indent + 1U, target);
+    }
+
+    auto parseBlockSequence(size_t indent, SettingsNode* target) -> size_t {
+        size_t entries = 0U;
+        do {
+            ++m_position;
+            parseSequenceItem(indent, target);
+            ++entries;
+        } while(column() == indent && isSequenceEntry());
+
+        checkDedent(indent);
+        return entries;
+    }
+
+    void parseSequenceItem(size_t indent, SettingsNode* target) {
+        skipSeparation();
+        if(peek() == '&') {
+            defineAnchor(Context::SequenceItem, indent);
+        }
+        parseSequenceItemContent(indent, target);
+    }
+
+    void parseSequenceItemContent(size_t indent, SettingsNode* target) {
+        skipSeparation();
+        if(atLineEnd()) {
+            nextLine();
+            if(!isEnd() && column() > indent) {
+                parseBlockNode(indent + 1U, target);
+            }
+            return;
+        }
+        parseBlockNode(indent + 1U, target);
+    }
+
+    /**
+     * Parses the node that starts at the current position, which may be a
+     * block collection
+     */
+    void parseBlockNode(size_t minIndent, SettingsNode* target) {
+        DepthGuard guard(&m_depth);
+        const auto indent = column();
+        if(isSequenceEntry()) {
+            if(previousIsProperty()) {
+                throw UnsupportedYaml("Properties of a compact sequence");
+            }
+            parseBlockSequence(indent, target);
+            return;
+        }
+        const auto character = peek();
+        if(character == '[' || character == '{' || character == '*') {
+            parseInlineNode(minIndent, target);
+            return;
+        }
+
+        const auto start = cursor();
+        Scalar scalar;
+        readBlockScalar(&scalar);
+        skipSpaces();
+        if(isMappingIndicator()) {
+            if(previousIsProperty()) {
+                throw UnsupportedYaml("Properties of a mapping key");
+            }
+            setCursor(start);
+            parseBlockMap(indent, target);
+            return;
+        }
+        finishInlineNode(minIndent);
+        addValue(scalar, target);
+    }
+
+    /**
+     * Parses a node that must end on the line it starts on
+     */
+    void parseInlineNode(size_t minIndent, SettingsNode* target) {
+        DepthGuard guard(&m_depth);
+        const auto character = peek();
+        if(character == '[' || character == '{') {
+            parseFlowCollection(target);
+        } else if(character == '*') {
+            resolveAlias(target);
+        } else {
+            Scalar scalar;
+            readBlockScalar(&scalar);
+            addValue(scalar, target);
+        }
+        finishInlineNode(minIndent);
+    }
+
+    void finishInlineNode(size_t minIndent) {
+        endOfLine();
+        nextLine();
+        if(!isEnd() && column() >= minIndent) {
+            throw UnsupportedYaml("Multi-line scalars are not supported");
+        }
+    }
+
+    void parseFlowNode(SettingsNode* target) {
+        if(peek() == '&') {
+            defineAnchor(Context::Flow, 0U);
+        }
+        parseFlowNodeContent(target);
+    }
+
+    void parseFlowNodeContent(SettingsNode* target) {
+        DepthGuard guard(&m_depth);
+        skipFlowSeparation();
+        const auto character = peek();
+        if(character == '[' || character == '{') {
+            parseFlowCollection(target);
+        } else if(character == '*') {
+            resolveAlias(target);
+        } else {
+            Scalar scalar;
+            readFlowScalar(&scalar);
+            addValue(scalar, target);
+        }
+    }
+
+    auto parseFlowCollection(SettingsNode* target) -> size_t {
+        DepthGuard guard(&m_depth);
+        const auto isMap = (peek() == '{');
+        const auto closing = isMap ? '}' : ']';
+        ++m_position;
+        skipFlowSeparation();
+
+        size_t entries = 0U;
+        while(peek() != closing) {
+            if(isMap) {
+                parseFlowMapEntry(target);
+            } else {
+                parseFlowNode(target);
+                skipFlowSeparation();
+                if(peek() == ':') {
+                    throw UnsupportedYaml("Mappings in flow sequences");
+                }
+            }
+            ++entries;
+
+            skipFlowSeparation();
+            if(peek() == ',') {
+                ++m_position;
+                skipFlowSeparation();
+            } else if(peek() != closing) {
+                throw UnsupportedYaml("Unterminated flow collection");
+            }
+        }
+        ++m_position;
+        return entries;
+    }
+
+    void parseFlowMapEntry(SettingsNode* target) {
+        Scalar key;
+        readFlowScalar(&key);
+        auto* value = addKey(key, target);
+
+        const auto keyLine = m_lineStart;
+        skipFlowSeparation();
+        if(m_lineStart != keyLine) {
+            throw UnsupportedYaml("Multi-line flow mapping keys");
+        }
+        if(peek() != ':') {
+            return;
+        }
+        ++m_position;
+        skipFlowSeparation();
+        if(peek() != ',' && peek() != '}') {
+            parseFlowNode(value);
+        }
+    }
+
+    void defineAnchor(Context context, size_t indent) {
+        const auto definedAt = m_position;
+        ++m_position;
+        const auto name = readName();
+        skipSpaces();
+        const auto node = cursor();
+        skipToContent();
+        if(peek() == '&' || peek() == '*') {
+            throw UnsupportedYaml("Unsupported anchor");
+        }
+        setCursor(node);
+
+        // Anchors are defined again when their node is parsed again for an
+        // alias. Aliases always refer to the last definition before them.
+        auto& definitions = m_anchors[name];
+        if(definitions.empty() || definitions.back().definedAt < definedAt) {
+            definitions.push_back(Anchor{definedAt, node, context, indent});
+        }
+    }
+
+    void resolveAlias(SettingsNode* target) {
+        const auto usedAt = m_position;
+        ++m_position;
+        const auto name = readName();
+        const auto definitions = m_anchors.find(name);
+        if(definitions == m_anchors.end()) {
+            throw UnsupportedYaml("Unknown anchor");
+        }
+        auto anchor =
+            std::upper_bound(definitions->second.begin(),
+                             definitions->second.end(), usedAt,
+                             [](size_t position, const Anchor& definition) {
+                                 return position < definition.definedAt;
+                             });
+        if(anchor == definitions->second.begin()) {
+            throw UnsupportedYaml("Unknown anchor");
+        }
+        --anchor;
+
+        DepthGuard guard(&m_depth);
+        const auto aliasEnd = cursor();
+        setCursor(anchor->node);
+        switch(anchor->context) {
+        case Context::MapValue:
+            parseMapValueContent(anchor->indent, target);
+            break;
+        case Context::SequenceItem:
+            parseSequenceItemContent(anchor->indent, target);
+            break;
+        case Context::Flow:
+            parseFlowNodeContent(target);
+            break;
+        }
+        setCursor(aliasEnd);
+    }
+
+    auto readName() -> string_view {
+        const auto start = m_position;
+        while(!isWhiteOrEnd(peek()) && !isFlowIndicator(peek())) {
+            checkTab();
+            ++m_position;
+        }
+        if(m_position == start || peek() == '[' || peek() == '{') {
+            throw UnsupportedYaml("Invalid anchor name");
+        }
+        return m_content.substr(start, m_position - start);
+    }
+
+    void readBlockScalar(Scalar* scalar) {
+        if(readQuotedScalar(scalar)) {
+            return;
+        }
+        checkPlainStart(false);
+        const auto start = m_position;
+        auto end = m_position;
+        while(!atLineEnd() && !isMappingIndicator()) {
+            checkTab();
+            if(peek() == ' ') {
+                if(peek(1U) == '#') {
+                    break;
+                }
+            } else {
+                end = m_position + 1U;
+            }
+            ++m_position;
+        }
+        m_position = end;
+        setPlain(m_content.substr(start, end - start), scalar);
+    }
+
+    void readFlowScalar(Scalar* scalar) {
+        if(readQuotedScalar(scalar)) {
+            return;
+        }
+        checkPlainStart(true);
+        const auto start = m_position;
+        auto end = m_position;
+        while(!atLineEnd() && !isFlowIndicator(peek())) {
+            checkTab();
+            if(peek() == '?') {
+                throw UnsupportedYaml("Unsupported character in flow scalar");
+            }
+            if(peek() == ':' && (isWhiteOrEnd(peek(1U)) || peek(1U) == ',' ||
+                                 peek(1U) == ']' || peek(1U) == '}')) {
+                break;
+            }
+            if(peek() == ' ') {
+                if(peek(1U) == '#') {
+                    break;
+                }
+            } else {
+                end = m_position + 1U;
+            }
+            ++m_position;
+        }
+        m_position = end;
+        setPlain(m_content.substr(start, end - start), scalar);
+    }
+
+    void checkPlainStart(bool inFlow) const {
+        const auto character = peek();
+        if(character == '-' || character == ':') {
+            const auto next = peek(1U);
+            if(isWhiteOrEnd(next) || (inFlow && isFlowIndicator(next))) {
+                throw UnsupportedYaml("Unsupported indicator");
+            }
+            return;
+        }
+        if(isWhiteOrEnd(character) ||
+           "?,[]{}#&*!|>'\"%@`"sv.find(character) != string_view::npos) {
+            throw UnsupportedYaml("Unsupported scalar");
+        }
+    }
+
+    static void setPlain(string_view value, Scalar* scalar) noexcept {
+        scalar->value = value;
+        scalar->isNull = (value == "~"sv || value == "null"sv ||
+                          value == "Null"sv || value == "NULL"sv);
+    }
+
+    auto readQuotedScalar(Scalar* scalar) -> bool {
+        const auto quote = peek();
+        if(quote != '\'' && quote != '"') {
+            return false;
+        }
+        ++m_position;
+        const auto start = m_position;
+        bool escaped = false;
+        while(true) {
+            if(peek() == quote) {
+                if(quote == '"' || peek(1U) != '\'') {
+                    break;
+                }
+                escaped = true;
+                ++m_position;
+            } else if(quote == '"' && peek() == '\\') {
+                escaped = true;
+                ++m_position;
+            }
+            if(atLineEnd()) {
+                throw UnsupportedYaml("Multi-line scalars are not supported");
+            }
+            ++m_position;
+        }
+        const auto value = m_content.substr(start, m_position - start);
+        ++m_position;
+
+        scalar->isNull = false;
+        if(!escaped) {
+            scalar->value = value;
+            return true;
+        }
+        scalar->buffer.clear();
+        scalar->buffer.reserve(value.size());
+        for(size_t i = 0U; i < value.size(); ++i) {
+            if(quote == '\'' && value[i] == '\'') {
+                ++i;
+            } else if(quote == '"' && value[i] == '\\') {
+                ++i;
+                scalar->buffer.push_back(unescape(value[i]));
+                continue;
+            }
+            scalar->buffer.push_back(value[i]);
+        }
+        scalar->value = scalar->buffer;
+        return true;
+    }
+
+    static auto unescape(char character) -> char {
+        switch(character) {
+        case '0':
+            return '\0';
+        case 'a':
+            return '\a';
+        case 'b':
+            return '\b';
+        case 't':
+            return '\t';
+        case 'n':
+            return '\n';
+        case 'v':
+            return '\v';
+        case 'f':
+            return '\f';
+        case 'r':
+            return '\r';
+        case 'e':
+            return '\x1B';
+        case ' ':
+        case '"':
+        case '/':
+        case '\\':
+            return character;
+        default:
+            throw UnsupportedYaml("Unsupported escape sequence");
+        }
+    }
+
+    static auto addKey(const Scalar& key, SettingsNode* target)
+        -> SettingsNode* {
+        if(key.isNull) {
+            throw UnsupportedYaml("Null keys are not supported");
+        }
+        if(target == nullptr) {
+            return nullptr;
+        }
+        const SettingsValue value(key.value);
+        if(!target->add(value)) {
+            LOG(warning) << "Failed to add key '" << value << "'";
+        }
+        return &target->child(value);
+    }
+
+    static void addValue(const Scalar& scalar, SettingsNode* target) {
+        if(scalar.isNull || target == nullptr) {
+            return;
+        }
+        if(!target->add(SettingsValue(scalar.value))) {
+            LOG(warning) << "Failed to add a value to key '" << target->key()
+                         << "'";
+        }
+    }
+
+    [[nodiscard]] auto peek(size_t offset = 0U) const noexcept -> char {
+        const auto position = m_position + offset;
+        return position < m_content.size() ? m_content[position] : '\0';
+    }
+
+    [[nodiscard]] auto atEnd() const noexcept -> bool {
+        return m_position >= m_content.size();
+    }
+
+    [[nodiscard]] auto atLineEnd() const noexcept -> bool {
+        return peek() == '\n' || atEnd();
+    }
+
+    [[nodiscard]] auto cursor() const noexcept -> Cursor {
+        return Cursor{m_position, m_lineStart};
+    }
+
+    void setCursor(const Cursor& cursor) noexcept {
+        m_position = cursor.position;
+        m_lineStart = cursor.lineStart;
+    }
+
+    /**
+     * Returns whether the current position is at the end of the document,
+     * which may be a document marker
+     */
+    [[nodiscard]] auto isEnd() const noexcept -> bool {
+        if(atEnd()) {
+            return true;
+        }
+        const auto marker = m_content.substr(m_position, 3U);
+        return m_position == m_lineStart &&
+               (marker == "---"sv || marker == "..."sv) &&
+               isWhiteOrEnd(peek(3U));
+    }
+
+    /**
+     * Returns the column of the current position, or END at the end of the
+     * document
+     */
+    [[nodiscard]] auto column() const noexcept -> size_t {
+        return isEnd() ? END : m_position - m_lineStart;
+    }
+
+    [[nodiscard]] auto isSequenceEntry() const noexcept -> bool {
+        return peek() == '-' && isWhiteOrEnd(peek(1U));
+    }
+
+    [[nodiscard]] auto isMappingIndicator() const noexcept -> bool {
+        return peek() == ':' && isWhiteOrEnd(peek(1U));
+    }
+
+    /**
+     * Returns whether an anchor precedes the current position on its line
+     */
+    [[nodiscard]] auto previousIsProperty() const noexcept -> bool {
+        const auto line =
+            m_content.substr(m_lineStart, m_position - m_lineStart);
+        return line.find('&') != string_view::npos;
+    }
+
+    void checkDedent(size_t indent) const {
+        if(!isEnd() && column() > indent) {
+            throw UnsupportedYaml("Invalid indentation");
+        }
+    }
+
+    /**
+     * Tabs are only supported in quoted scalars: whether they separate tokens
+     * or are part of a plain scalar depends on their position
+     */
+    void checkTab() const {
+        if(peek() == '\t') {
+            throw UnsupportedYaml("Tabs are only supported in quoted scalars");
+        }
+    }
+
+    void skipSpaces() {
+        while(peek() == ' ') {
+            ++m_position;
+        }
+        checkTab();
+    }
+
+    /**
+     * Skips the spaces and the comment on the current line
+     */
+    void skipSeparation() {
+        const auto start = m_position;
+        skipSpaces();
+        if(peek() == '#' &&
+           (m_position > start || m_position == m_lineStart)) {
+            while(!atLineEnd()) {
+                ++m_position;
+            }
+        }
+    }
+
+    void endOfLine() {
+        skipSeparation();
+        if(!atLineEnd()) {
+            throw UnsupportedYaml("Unexpected content at the end of a line");
+        }
+    }
+
+    /**
+     * Moves to the first content on the next lines that contain content
+     */
+    void nextLine() {
+        endOfLine();
+        if(atEnd()) {
+            return;
+        }
+        ++m_position;
+        m_lineStart = m_position;
+        skipToContent();
+    }
+
+    void skipToContent() {
+        while(true) {
+            skipSeparation();
+            if(!atLineEnd() || atEnd()) {
+                return;
+            }
+            ++m_position;
+            m_lineStart = m_position;
+        }
+    }
+
+    void skipFlowSeparation() {
+        while(true) {
+            skipSeparation();
+            if(!atLineEnd() || atEnd()) {
+                break;
+            }
+            ++m_position;
+            m_lineStart = m_position;
+            if(isEnd()) {
+                throw UnsupportedYaml("Document marker in a flow collection");
+            }
+        }
+        if(atEnd()) {
+            throw UnsupportedYaml("Unterminated flow collection");
+        }
+    }
+
+    string_view m_content;
+    size_t m_position = 0U;
+    size_t m_lineStart = 0U;
+    size_t m_depth = 0U;
+    unordered_map<string_view, vector<Anchor>> m_anchors;
+};
+} // namespace
+
+namespace execHelper::yaml {
+YamlParser::YamlParser(string_view yamlConfig) noexcept
+    : m_content(yamlConfig) {
+    ;
+}
+
+auto YamlParser::isSupported() const noexcept -> bool {
+    try {
+        Parser(m_content).parse(nullptr);
+        return true;
+    } catch(const UnsupportedYaml& e) {
+        LOG(debug) << "Document is not supported by the parser: " << e.what();
+        return false;
+    } catch(const std::exception& e) {
+        LOG(warning) << "Failed to parse the document: " << e.what();
+        return false;
+    }
+}
+
+auto YamlParser::getTree(SettingsNode* settings) const noexcept -> bool {
+    try {
+        // The settings are copied on write, so this only copies what is
+        // changed and leaves the settings untouched if parsing fails
+        SettingsNode result(*settings);
+        if(Parser(m_content).parse(&result) == 0U) {
+            return false;
+        }
+        settings->swap(result);
+        return true;
+    } catch(const UnsupportedYaml& e) {
+        LOG(debug) << "Document is not supported by the parser: " << e.what();
+        return false;
+    } catch(const std::exception& e) {
+        LOG(warning) << "Failed to parse the document: " << e.what();
+        return false;
+    }
+}
+} // namespace execHelper::yaml
@@ -13,7 +13,6 @@ using std::initializer_list;
 using std::string;
 
 using execHelper::config::Path;
-using execHelper::config::SettingsKeys;
 using execHelper::config::SettingsNode;
 using execHelper::config::SettingsValue;
 
@@ -39,16 +38,26 @@ void YamlWrapper::swap(const YamlWrapper& other) noexcept {
 
 auto YamlWrapper::getSubNode(
     const std::initializer_list<std::string>& keys) const -> YAML::Node {
-    return std::accumulate(
-        keys.begin(), keys.end(), Clone(m_node),
-        [](const auto& node, const auto& key) { return node[key]; });
+    // Only use the const subscript operator: the non-const one inserts missing
+    // keys into the document. Node::reset rebinds the handle, whereas
+    // assigning to a node overwrites the node it refers to.
+    YAML::Node node;
+    node.reset(m_node);
+    for(const auto& key : keys) {
+        if(!node.IsDefined()) {
+            break;
+        }
+        const YAML::Node& parent = node;
+        node.reset(parent[key]);
+    }
+    return node;
 }
 
 auto YamlWrapper::getTree(const initializer_list<string>& keys,
                           SettingsNode* settings) const noexcept -> bool {
     try {
-        const YAML::Node& node = getSubNode(keys);
-        if(node.size() == 0 || node.IsNull()) {
+        const YAML::Node node = getSubNode(keys);
+        if(!node.IsDefined() || node.size() == 0 || node.IsNull()) {
             return false;
         }
         return getTree(node, settings);
@@ -60,13 +69,11 @@ auto YamlWrapper::getTree(const initializer_list<string>& keys,
 
 auto YamlWrapper::getTree(const YAML::Node& rootNode,
                           SettingsNode* settings) noexcept -> bool {
-    YAML::Node node = Clone(rootNode);
-    return getSubTree(node, settings, {});
+    return getSubTree(rootNode, settings);
 }
 
 auto YamlWrapper::getSubTree( // NOLINT(misc-no-recursion)
-    const YAML::Node& node, SettingsNode* yamlNode,
-    const SettingsKeys& keys) noexcept -> bool {
+    const YAML::Node& node, SettingsNode* yamlNode) noexcept -> bool {
     YAML::NodeType::value type = YAML::NodeType::Null;
     try {
         type = node.Type();
@@ -81,8 +88,9 @@ auto YamlWrapper::getSubTree( // NOLINT(misc-no-recursion)
         break;
     case YAML::NodeType::Scalar:
         try {
-            if(!yamlNode->add(keys, node.as<string>())) {
-                LOG(warning) << "Failed to add key '" << keys.back() << "'";
+            if(!yamlNode->add(node.as<string>())) {
+                LOG(warning) << "Failed to add a value to key '"
+                             << yamlNode->key() << "'";
             }
         } catch(const YAML::TypedBadConversion<string>&) {
             return false;
@@ -101,22 +109,20 @@ auto YamlWrapper::getSubTree( // NOLINT(misc-no-recursion)
                 return false;
             }
 
-            if(!yamlNode->add(keys, key)) {
+            if(!yamlNode->add(key)) {
                 LOG(warning) << "Failed to add key '" << key << "'";
             }
-            SettingsKeys newKeys = keys;
-            newKeys.push_back(key);
-            if(!YamlWrapper::getSubTree(element.second, yamlNode, newKeys)) {
+            if(!YamlWrapper::getSubTree(element.second,
+                                        &yamlNode->child(key))) {
                 return false;
             }
         }
         break;
     case YAML::NodeType::Sequence:
         if(!std::all_of(node.begin(), node.end(),
-                        [&yamlNode, &keys]( // NOLINT(misc-no-recursion)
+                        [&yamlNode]( // NOLINT(misc-no-recursion)
                             const auto& element) {
-                            return YamlWrapper::getSubTree(element, yamlNode,
-                                                           keys);
+                            return YamlWrapper::getSubTree(element, yamlNode);
                         })) {
             return false;
         }
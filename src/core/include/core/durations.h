@@ -0,0 +1,76 @@
+#ifndef __DURATIONS_H__
+#define __DURATIONS_H__
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "config/path.h"
+
+#include "shell.h"
+
+namespace execHelper::core {
+class Task;
+
+using Durations =
+    std::map<std::string, double>; //!< brief The duration in seconds per task key
+using TaskKey = std::function<std::string(
+    const Task&)>; //!< brief Returns the key that identifies a task across runs
+
+/**
+ * Reads the durations from the given file. Every line of the file contains the
+ * duration in seconds and the key of a task, separated by a tab. Newlines and
+ * backslashes in the key are escaped with a backslash. Later lines overrule
+ * earlier lines with the same key, so the files of multiple runs can be
+ * concatenated.
+ *
+ * \param[in] file  The file to read
+ * \returns The durations in the file. Empty if the file does not exist.
+ */
+auto readDurations(const config::Path& file) -> Durations;
+
+/**
+ * Writes the durations to the given file in the format of \ref readDurations()
+ *
+ * \param[in] file      The file to write to
+ * \param[in] durations The durations to write
+ * \returns True    If the durations were written
+ *          False   Otherwise
+ */
+auto writeDurations(const config::Path& file, const Durations& durations)
+    -> bool;
+
+/**
+ * \brief Records the duration of every task executed by another shell
+ */
+class DurationRecordingShell : public Shell {
+  public:
+    /**
+     * Create a shell
+     *
+     * \param[in] shell The shell to execute the tasks with
+     * \param[in] key   Returns the key to record the duration of a task under
+     */
+    DurationRecordingShell(const Shell& shell, TaskKey key) noexcept;
+
+    auto execute(const Task& task) const -> ShellReturnCode override;
+    [[nodiscard]] auto isExecutedSuccessfully(ShellReturnCode returnCode) const
+        noexcept -> bool override;
+
+    /**
+     * Returns the durations of the tasks executed so far
+     *
+     * \returns The recorded durations
+     */
+    [[nodiscard]] auto getDurations() const -> Durations;
+
+  private:
+    const Shell& m_shell;
+    const TaskKey m_key;
+    mutable std::mutex m_durationsMutex;
+    mutable Durations m_durations;
+};
+} // namespace execHelper::core
+
+#endif /* __DURATIONS_H__ */
@@ -1,6 +1,8 @@
 #ifndef __EXECUTOR_INTERFACE_H__
 #define __EXECUTOR_INTERFACE_H__
 
+#include <cstddef>
+
 namespace execHelper {
 namespace core {
 class Task;
@@ -14,6 +16,8 @@ namespace core {
  */
 class ExecutorInterface {
   public:
+    using Sequence = std::size_t; //!< brief Identifies a sequence of tasks
+
     virtual ~ExecutorInterface() = default;
 
     /**
@@ -26,6 +30,30 @@ class ExecutorInterface {
      */
     virtual void execute(const Task& task) noexcept = 0;
 
+    /**
+     * Execute the given task after all tasks that were passed before for the
+     * same sequence have finished
+     *
+     * \param[in] task  The task to execute
+     * \param[in] sequence  The sequence the task belongs to
+     *
+     * \note The default implementation assumes that \ref execute() blocks
+     * until the task finished, which executes the tasks in order
+     */
+    virtual void
+    executeInSequence(const Task& task,
+                      [[maybe_unused]] Sequence sequence) noexcept {
+        execute(task);
+    }
+
+    /**
+     * Blocks until all tasks passed to \ref execute() have finished
+     *
+     * \note The default implementation assumes that \ref execute() blocks
+     * until the task finished
+     */
+    virtual void wait() noexcept {}
+
   protected:
     ExecutorInterface() = default;
 };
@@ -0,0 +1,100 @@
+#ifndef __PARALLEL_EXECUTOR_H__
+#define __PARALLEL_EXECUTOR_H__
+
+#include "executorInterface.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "shell.h"
+#include "task.h"
+
+namespace execHelper::core {
+/**
+ * \brief Implements an executor that executes up to a given number of tasks
+ * concurrently. Executing a task only schedules it: use \ref wait() to block
+ * until all scheduled tasks have finished. The tasks of one sequence are
+ * executed one after the other, in the order in which they were scheduled.
+ */
+class ParallelExecutor : public ExecutorInterface {
+  public:
+    using Callback = std::function<void(
+        Shell::ShellReturnCode)>; //!< Brief Callback function signature
+
+    /**
+     * Create an executor
+     *
+     * \param[in] shell     The shell to execute the commands with. The shell
+     * must support concurrent calls to Shell::execute.
+     * \param[in] callback  The function to call with the result when a command
+     * fails. Calls to the callback are serialized.
+     * \param[in] jobs      The maximum number of tasks to execute concurrently
+     * \param[in] keepGoing Whether to continue starting scheduled tasks after a
+     * task failed
+     */
+    ParallelExecutor(const Shell& shell, Callback callback, std::size_t jobs,
+                     bool keepGoing) noexcept;
+
+    /**
+     * Waits for all scheduled tasks to finish before destroying the executor
+     */
+    ~ParallelExecutor() noexcept override;
+
+    ParallelExecutor(const ParallelExecutor& other) = delete;
+    ParallelExecutor(ParallelExecutor&& other) = delete;
+    auto operator=(const ParallelExecutor& other) = delete;
+    auto operator=(ParallelExecutor&& other) = delete;
+
+    void execute(const Task& task) noexcept override;
+    void executeInSequence(const Task& task,
+                           Sequence sequence) noexcept override;
+
+    void wait() noexcept override;
+
+  private:
+    /**
+     * \brief A task that is scheduled for execution
+     */
+    struct ScheduledTask {
+        Task task;                        //!< brief The task to execute
+        std::optional<Sequence> sequence; //!< brief The sequence of the task
+    };
+    using Queue = std::deque<ScheduledTask>; //!< brief The scheduled tasks
+
+    void schedule(ScheduledTask&& task) noexcept;
+
+    /**
+     * Returns the first scheduled task that can be started. Must be called
+     * with the mutex locked.
+     *
+     * \returns The task that can be started
+     *          The end of the queue if no scheduled task can be started
+     */
+    auto getRunnable() noexcept -> Queue::iterator;
+
+    void work() noexcept;
+
+    const Shell& m_shell;
+    Callback m_callback;
+    const bool m_keepGoing;
+
+    std::mutex m_mutex;
+    std::condition_variable m_taskAvailable;
+    std::condition_variable m_idle;
+    Queue m_queue;
+    std::set<Sequence> m_runningSequences;
+    std::size_t m_running{0U};
+    bool m_failed{false};
+    bool m_shutdown{false};
+
+    std::vector<std::thread> m_workers;
+};
+} // namespace execHelper::core
+#endif /* __PARALLEL_EXECUTOR_H__ */
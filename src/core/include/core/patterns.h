@@ -5,8 +5,6 @@
 
 #include "config/pattern.h"
 
-#include "mapPermutator.h"
-
 namespace execHelper {
 namespace core {
 /**
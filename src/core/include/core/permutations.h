@@ -0,0 +1,81 @@
+#ifndef __PERMUTATIONS_H__
+#define __PERMUTATIONS_H__
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace execHelper::core {
+/**
+ * \brief All combinations of picking one value for every dimension
+ *
+ * A dimension is identified by its position and a value by its index within
+ * the dimension. The combinations are numbered as a mixed radix number in
+ * which the last dimension is the least significant digit, so any combination
+ * can be computed directly from its number and the combinations can be split
+ * into independent ranges.
+ */
+class Permutations {
+  public:
+    using Index = std::size_t; //!< brief The number of a combination
+    using Radices =
+        std::vector<std::size_t>; //!< brief The number of values per dimension
+    using Combination =
+        std::vector<std::size_t>; //!< brief The value index for every dimension
+    using Range = std::pair<Index, Index>; //!< brief A half-open range of combinations
+
+    /**
+     * Create the combinations of the given dimensions
+     *
+     * \param[in] radices   The number of values of every dimension
+     * \throws std::overflow_error  The number of combinations does not fit in
+     * an index
+     */
+    explicit Permutations(Radices radices);
+
+    /**
+     * Returns the number of combinations
+     *
+     * \returns The number of combinations. One if there are no dimensions,
+     * zero if any dimension has no values.
+     */
+    [[nodiscard]] auto size() const noexcept -> Index;
+
+    /**
+     * Returns the number of dimensions
+     *
+     * \returns The number of dimensions
+     */
+    [[nodiscard]] auto dimensions() const noexcept -> std::size_t;
+
+    /**
+     * Returns the combination with the given number
+     *
+     * \param[in] index The number of the combination. Must be less than \ref size().
+     * \param[out] combination  The value index for every dimension
+     */
+    void combination(Index index, Combination* combination) const noexcept;
+
+    /*! @copydoc combination(Index, Combination*) const
+     *
+     * \returns The value index for every dimension
+     */
+    [[nodiscard]] auto combination(Index index) const -> Combination;
+
+    /**
+     * Split the combinations into contiguous ranges of (almost) equal size
+     *
+     * \param[in] nbOfRanges    The number of ranges. Must be larger than zero.
+     * \returns The ranges, in order. Earlier ranges are one combination larger
+     * if the combinations can not be divided equally.
+     */
+    [[nodiscard]] auto split(std::size_t nbOfRanges) const
+        -> std::vector<Range>;
+
+  private:
+    Radices m_radices;
+    Index m_size;
+};
+} // namespace execHelper::core
+
+#endif /* __PERMUTATIONS_H__ */
@@ -2,6 +2,17 @@
 #define __POSIX_SHELL_H__
 
 #include <csignal>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include "config/environment.h"
+#include "config/envp.h"
+#include "config/path.h"
 
 #include "shell.h"
 #include "task.h"
@@ -9,8 +20,18 @@
 namespace execHelper::core {
 /**
  * \brief Implementation for Shell that represents a posix shell
+ *
+ * Relative binaries are resolved to an absolute path once per combination of
+ * binary, PATH and working directory. Only successful resolutions are cached
+ * and they are kept for the lifetime of the shell, i.e. for one run: binaries
+ * that appear later on are still found, but binaries that are moved or removed
+ * after they were resolved will fail to launch.
+ *
+ * Tasks are launched in their inherited environment or, if they do not
+ * inherit one, in the environment of this process. The complete environment
+ * of a task is built once for every distinct environment.
  */
-class PosixShell final : public Shell {
+class PosixShell : public Shell {
   public:
     [[nodiscard]] auto execute(const Task& task) const
         -> ShellReturnCode override;
@@ -19,14 +40,87 @@ class PosixShell final : public Shell {
     isExecutedSuccessfully(ShellReturnCode returnCode) const noexcept
         -> bool override;
 
+  protected:
+    /**
+     * \brief The complete environment to launch a binary in
+     */
+    struct Environment {
+        /**
+         * Create an environment
+         *
+         * \param[in] env   The variables of the environment
+         */
+        explicit Environment(config::EnvironmentCollection env) noexcept
+            : collection(std::move(env)), envp(collection) {}
+
+        config::EnvironmentCollection
+            collection; //!< brief The variables of the environment
+        config::Envp envp; //!< brief The variables as an envp block
+    };
+
+    /**
+     * Launch the given binary and wait for it to finish
+     *
+     * \param[in] binary    The absolute path to the binary to launch
+     * \param[in] args      The arguments for the binary, excluding the binary itself
+     * \param[in] workingDirectory  The working directory to launch the binary in
+     * \param[in] env       The complete environment for the binary
+     * \returns The return code of the binary
+     */
+    [[nodiscard]] virtual auto
+    launch(const config::Path& binary, const TaskCollection& args,
+           const config::Path& workingDirectory,
+           const Environment& env) const -> ShellReturnCode;
+
   private:
+    using ResolutionKey = std::tuple<std::string, std::string, config::Path>;
+    using EnvironmentKey =
+        std::pair<InheritedEnvironment, config::EnvironmentCollection>;
+
+    /**
+     * Returns the complete environment of the given task
+     *
+     * \param[in] task  The task
+     * \returns The complete environment
+     */
+    [[nodiscard]] auto getEnvironment(const Task& task) const
+        -> std::shared_ptr<const Environment>;
+
+    /**
+     * Resolve the given binary to an absolute path
+     *
+     * \param[in] binary    The binary to resolve
+     * \param[in] env       The environment to search the binary in
+     * \param[in] workingDirectory  The working directory of the binary
+     * \returns The absolute path to the binary
+     * \throws PathNotFoundError    The binary could not be resolved
+     */
+    [[nodiscard]] auto resolve(const std::string& binary,
+                               const config::EnvironmentCollection& env,
+                               const config::Path& workingDirectory) const
+        -> config::Path;
+
+    mutable std::mutex m_resolvedMutex;
+    mutable std::map<ResolutionKey, config::Path> m_resolved;
+    mutable std::size_t m_nbOfHits{0U};
+    mutable std::size_t m_nbOfMisses{0U};
+
+    mutable std::mutex m_environmentsMutex;
+    mutable InheritedEnvironment m_processEnvironment;
+    mutable std::map<EnvironmentKey, std::shared_ptr<const Environment>>
+        m_environments;
+
     // cppcheck-suppress unusedPrivateFunction
     //void childProcessExecute(const Task& task) const noexcept;
     // cppcheck-suppress unusedPrivateFunction
     //ShellReturnCode waitForChild(pid_t pid) const noexcept;
 
-    static auto shellExpand(const Task& task) noexcept -> TaskCollection;
-    static auto wordExpand(const Task& task) noexcept -> TaskCollection;
+    static auto shellExpand(const Task& task,
+                            const config::EnvironmentCollection& env) noexcept
+        -> TaskCollection;
+    static auto wordExpand(const Task& task,
+                           const config::EnvironmentCollection& env) noexcept
+        -> TaskCollection;
 };
 } // namespace execHelper::core
 
@@ -0,0 +1,125 @@
+#ifndef __PROCESS_SUPERVISOR_H__
+#define __PROCESS_SUPERVISOR_H__
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string_view>
+
+#include <sys/types.h>
+
+#include "config/environment.h"
+#include "config/path.h"
+
+#include "shell.h"
+#include "task.h"
+
+namespace execHelper::core {
+/**
+ * \brief Spawns child processes and supervises them from a single event loop
+ *
+ * Every child gets a pidfd that is waited on together with the pipes of its
+ * captured output using one epoll instance, so no thread is dedicated to a
+ * single child. On kernels without pidfd support, exited children are detected
+ * by polling instead.
+ *
+ * \note The supervisor is not thread-safe: spawn children and run the event
+ * loop from the same thread.
+ */
+class ProcessSupervisor {
+  public:
+    /**
+     * \brief The output streams of a child that can be captured
+     */
+    enum class OutputStream { out, err };
+
+    using ExitCallback = std::function<void(
+        Shell::ShellReturnCode)>; //!< brief Called when a child exited
+    using OutputCallback = std::function<void(
+        OutputStream stream,
+        std::string_view output)>; //!< brief Called for captured output
+
+    /**
+     * Create a supervisor
+     *
+     * \throws std::system_error    The event loop could not be created
+     */
+    ProcessSupervisor();
+
+    /**
+     * Waits for all remaining children before destroying the supervisor
+     */
+    ~ProcessSupervisor() noexcept;
+
+    ProcessSupervisor(const ProcessSupervisor& other) = delete;
+    ProcessSupervisor(ProcessSupervisor&& other) = delete;
+    auto operator=(const ProcessSupervisor& other) = delete;
+    auto operator=(ProcessSupervisor&& other) = delete;
+
+    /**
+     * Spawn a child process
+     *
+     * \param[in] binary    The absolute path to the binary to execute
+     * \param[in] args      The arguments to pass to the binary, excluding the binary itself
+     * \param[in] workingDirectory  The working directory of the child
+     * \param[in] env       The complete environment of the child
+     * \param[in] onExit    Called with the return code of the child once it
+     * exited and all its captured output was delivered. A child that was
+     * killed by a signal returns 128 + the signal number, like a shell does.
+     * \param[in] onOutput  Called with every chunk of output of the child. If
+     * empty, the child inherits the output streams of this process.
+     * \returns The process id of the child
+     * \throws std::system_error    The child could not be spawned
+     */
+    auto spawn(const config::Path& binary, const TaskCollection& args,
+               const config::Path& workingDirectory,
+               const config::EnvironmentCollection& env, ExitCallback onExit,
+               OutputCallback onOutput = OutputCallback()) -> pid_t;
+
+    /**
+     * Returns the number of supervised children
+     *
+     * \returns The number of children that were spawned and whose exit was not
+     * reported yet
+     */
+    [[nodiscard]] auto size() const noexcept -> std::size_t;
+
+    /**
+     * Wait for events of the children and dispatch them to their callbacks
+     *
+     * \param[in] timeout   The maximum time to wait for an event
+     * \returns The number of children whose exit was reported
+     */
+    auto poll(std::chrono::milliseconds timeout) noexcept -> std::size_t;
+
+    /**
+     * Dispatch events until all children exited
+     */
+    void run() noexcept;
+
+  private:
+    struct Child {
+        int pidfd{-1};
+        int out{-1};
+        int err{-1};
+        bool exited{false};
+        Shell::ShellReturnCode returnCode{0U};
+        ExitCallback onExit;
+        OutputCallback onOutput;
+    };
+
+    void watch(int fd, pid_t pid);
+    void unwatch(int* fd) noexcept;
+    void drain(pid_t pid, Child* child, int* fd, OutputStream stream) noexcept;
+    void reap(pid_t pid, Child* child) noexcept;
+    auto finish() noexcept -> std::size_t;
+
+    int m_epoll;
+    std::map<pid_t, Child> m_children;
+    std::map<int, pid_t> m_fds;
+    std::size_t m_nbOfPolled{0U};
+};
+} // namespace execHelper::core
+
+#endif /* __PROCESS_SUPERVISOR_H__ */
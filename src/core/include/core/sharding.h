@@ -0,0 +1,102 @@
+#ifndef __SHARDING_H__
+#define __SHARDING_H__
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "durations.h"
+#include "executorInterface.h"
+
+namespace execHelper::core {
+class Task;
+
+/**
+ * \brief Thrown when a shard specification is invalid
+ */
+struct InvalidShardError : public std::runtime_error {
+  public:
+    /**
+     * Create an invalid shard error
+     *
+     * \param[in] msg   A message detailing the specifics of the exception
+     */
+    inline explicit InvalidShardError(const std::string& msg)
+        : std::runtime_error(msg) {}
+};
+
+/**
+ * \brief One of a number of equal parts a run is split into
+ */
+struct Shard {
+    std::size_t index; //!< brief The zero-based index of the shard
+    std::size_t count; //!< brief The total number of shards
+};
+
+/**
+ * The maximum number of shards a run can be split into
+ */
+constexpr std::size_t MAX_SHARD_COUNT = 65536U;
+
+/**
+ * Parses a shard specification of the form INDEX/COUNT, where INDEX is a
+ * one-based index that is at most COUNT and COUNT is at most MAX_SHARD_COUNT
+ *
+ * \param[in] value The specification to parse
+ * \returns The specified shard
+ * \throws InvalidShardError   The specification is invalid
+ */
+auto parseShard(std::string_view value) -> Shard;
+
+/**
+ * \brief Only passes the tasks that are assigned to a given shard on to
+ * another executor
+ *
+ * Every task is assigned to the shard that has the least work assigned to it so
+ * far, the lowest shard on a tie. The work of a task is its recorded duration,
+ * the mean of all recorded durations if it has none or one if nothing was
+ * recorded at all. The assignment only depends on the order of the tasks and
+ * the given durations: runs that are given the same tasks in the same order and
+ * the same durations execute every task in exactly one of the shards.
+ */
+class ShardedExecutor : public ExecutorInterface {
+  public:
+    /**
+     * Create an executor
+     *
+     * \param[in] executor  The executor to execute the tasks of the shard with
+     * \param[in] shard     The shard to execute
+     * \param[in] durations The recorded durations to weigh the tasks with
+     * \param[in] key       Returns the key of a task in the durations
+     */
+    ShardedExecutor(ExecutorInterface& executor, Shard shard,
+                    Durations durations, TaskKey key);
+
+    void execute(const Task& task) noexcept override;
+    void executeInSequence(const Task& task,
+                           Sequence sequence) noexcept override;
+    void wait() noexcept override;
+
+  private:
+    /**
+     * Assigns the given task to a shard
+     *
+     * \param[in] task  The task to assign
+     * \returns True    If the task is assigned to the shard of this executor
+     *          False   Otherwise
+     */
+    auto assign(const Task& task) noexcept -> bool;
+
+    ExecutorInterface& m_executor;
+    const Shard m_shard;
+    const Durations m_durations;
+    const TaskKey m_key;
+    double m_defaultDuration;
+    std::vector<double> m_loads;
+};
+} // namespace execHelper::core
+
+#endif /* __SHARDING_H__ */
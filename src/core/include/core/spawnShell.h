@@ -0,0 +1,25 @@
+#ifndef __SPAWN_SHELL_H__
+#define __SPAWN_SHELL_H__
+
+#include "posixShell.h"
+
+namespace execHelper::core {
+/**
+ * \brief Posix shell that launches tasks using posix_spawn
+ *
+ * Tasks are prepared the same way as for the \ref PosixShell, but the binary is
+ * launched with posix_spawn instead of forking the whole process. This avoids
+ * copying the page tables of this process for every launch. The argument block
+ * is built in a per-thread buffer that is reused between launches.
+ */
+class SpawnShell final : public PosixShell {
+  protected:
+    [[nodiscard]] auto launch(const config::Path& binary,
+                              const TaskCollection& args,
+                              const config::Path& workingDirectory,
+                              const Environment& env) const
+        -> ShellReturnCode override;
+};
+} // namespace execHelper::core
+
+#endif /* __SPAWN_SHELL_H__ */
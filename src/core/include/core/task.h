@@ -3,6 +3,7 @@
 
 #include <filesystem>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -12,9 +13,16 @@
 
 namespace execHelper::core {
 using TaskCollection = std::vector<std::string>;
+using InheritedEnvironment = std::shared_ptr<
+    const config::EnvironmentCollection>; //!< brief An immutable environment that is shared between tasks
 
 /**
  * \brief Represents a task to execute
+ *
+ * The environment of a task consists of two layers: an optional inherited
+ * environment that is shared with all the tasks derived from the same task and
+ * is never modified, and the variables that are set for this task, which
+ * override the inherited ones.
  */
 class Task {
   public:
@@ -67,12 +75,39 @@ class Task {
     std::string toString() const;
 
     /**
-     * Returns the environment in which to execute the task
+     * Returns the variables that are set for this task on top of the inherited
+     * environment
      *
      * \returns A collection of the environment
      */
     const config::EnvironmentCollection& getEnvironment() const noexcept;
 
+    /**
+     * Returns the environment the task inherits
+     *
+     * \returns The inherited environment. Empty if the task does not inherit an
+     * environment.
+     */
+    [[nodiscard]] auto getInheritedEnvironment() const noexcept
+        -> const InheritedEnvironment&;
+
+    /**
+     * Set the environment the task inherits. The variables that are set for
+     * this task are kept.
+     *
+     * \param[in] env   The environment to inherit
+     */
+    void setInheritedEnvironment(InheritedEnvironment env) noexcept;
+
+    /**
+     * Returns the complete environment in which to execute the task
+     *
+     * \returns The inherited environment, overridden by the variables that are
+     * set for this task
+     */
+    [[nodiscard]] auto getFullEnvironment() const
+        -> config::EnvironmentCollection;
+
     /**
      * Sets the working directory of the task
      *
@@ -109,7 +144,8 @@ class Task {
     bool append(TaskCollection&& taskPart) noexcept;
 
     /**
-     * Set the environment of the task. Replaces the existing environment for the task.
+     * Set the environment of the task. Replaces the existing variables that
+     * are set for the task, but keeps the inherited environment.
      *
      * \param[in] env  The environment to set for the task
      * \returns True    If the new environment was successfully set
@@ -137,7 +173,9 @@ class Task {
     bool appendToEnvironment(config::EnvironmentCollection&& newValue) noexcept;
 
     /**
-     * Checks whether other instance equals this instance of the object
+     * Checks whether other instance equals this instance of the object. Tasks
+     * with the same complete environment are equal, regardless of how it is
+     * layered.
      *
      * \param[in] other The other instance to compare with
      * \returns True    If the other instance is equal to this instance of the
@@ -169,6 +207,7 @@ class Task {
 
   private:
     TaskCollection m_task;
+    InheritedEnvironment m_inheritedEnv;
     config::EnvironmentCollection m_env;
     config::Path m_workingDirectory;
     config::Patterns m_patterns = {};
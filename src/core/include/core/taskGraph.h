@@ -0,0 +1,119 @@
+#ifndef __TASK_GRAPH_H__
+#define __TASK_GRAPH_H__
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "task.h"
+
+namespace execHelper::core {
+/**
+ * \brief Thrown when the dependencies in a task graph form a cycle
+ */
+struct CyclicDependencyError : public std::runtime_error {
+  public:
+    /**
+     * Create a cyclic dependency error
+     *
+     * \param[in] msg   A message detailing the specifics of the exception
+     */
+    inline explicit CyclicDependencyError(const std::string& msg)
+        : std::runtime_error(msg) {}
+};
+
+/**
+ * \brief A directed acyclic graph of named groups of tasks
+ *
+ * The tasks within a node are kept in the order in which they were added. A
+ * node may only be executed once all the nodes it depends on have finished.
+ */
+class TaskGraph {
+  public:
+    using Node = std::size_t;             //!< brief Node identifier
+    using Stage = std::vector<Node>;      //!< brief Mutually independent nodes
+    using Stages = std::vector<Stage>;    //!< brief Collection of stages
+
+    /**
+     * Add a node to the graph
+     *
+     * \param[in] name  The name of the node, used for diagnostics
+     * \param[in] tasks The tasks associated with the node
+     * \returns The identifier of the new node
+     */
+    auto addNode(std::string name, Tasks tasks = {}) noexcept -> Node;
+
+    /**
+     * Let a node depend on another node
+     *
+     * \param[in] node  The node that depends on the other one
+     * \param[in] dependency    The node it depends on
+     * \pre node < size() && dependency < size()
+     */
+    void addDependency(Node node, Node dependency) noexcept;
+
+    /**
+     * Replace the tasks associated with the given node
+     *
+     * \param[in] node  The node to replace the tasks of
+     * \param[in] tasks The new tasks of the node
+     * \pre node < size()
+     */
+    void setTasks(Node node, Tasks tasks) noexcept;
+
+    /**
+     * Returns the name of the given node
+     *
+     * \param[in] node  The node to get the name of
+     * \returns The name of the node
+     * \pre node < size()
+     */
+    [[nodiscard]] auto getName(Node node) const noexcept -> const std::string&;
+
+    /**
+     * Returns the tasks of the given node
+     *
+     * \param[in] node  The node to get the tasks of
+     * \returns The tasks of the node
+     * \pre node < size()
+     */
+    [[nodiscard]] auto getTasks(Node node) const noexcept -> const Tasks&;
+
+    /**
+     * Returns the number of nodes in the graph
+     *
+     * \returns The number of nodes
+     */
+    [[nodiscard]] auto size() const noexcept -> std::size_t;
+
+    /**
+     * Returns the nodes of the graph in topological order, grouped in stages.
+     * A node only depends on nodes of earlier stages, so all nodes of a stage
+     * can be executed concurrently. Within a stage, nodes keep the order in
+     * which they were added.
+     *
+     * \returns The stages of the graph
+     * \throws CyclicDependencyError    The dependencies form a cycle
+     */
+    [[nodiscard]] auto getStages() const -> Stages;
+
+    /**
+     * Returns all tasks of the graph in topological order
+     *
+     * \returns The tasks of all stages, concatenated
+     * \throws CyclicDependencyError    The dependencies form a cycle
+     */
+    [[nodiscard]] auto getTasks() const -> Tasks;
+
+  private:
+    struct NodeData {
+        std::string name;
+        Tasks tasks;
+        std::vector<Node> dependencies;
+    };
+
+    std::vector<NodeData> m_nodes;
+};
+} // namespace execHelper::core
+#endif /* __TASK_GRAPH_H__ */
@@ -0,0 +1,54 @@
+#ifndef __WORD_EXPANDER_H__
+#define __WORD_EXPANDER_H__
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "config/environment.h"
+
+#include "task.h"
+
+namespace execHelper::core {
+/**
+ * \brief Thrown when a word can not be expanded
+ */
+struct WordExpansionError : public std::runtime_error {
+  public:
+    /**
+     * Create a word expansion error
+     *
+     * \param[in] msg   A message detailing the specifics of the exception
+     */
+    inline explicit WordExpansionError(const std::string& msg)
+        : std::runtime_error(msg) {}
+};
+
+/**
+ * Expand the given word the way a posix shell expands a word
+ *
+ * Tilde expansion, parameter expansion of the form $NAME and ${NAME}, field
+ * splitting, pathname expansion and quote removal are performed in-process
+ * using the given environment only. Words without any characters that are
+ * special to the shell are appended as is. Words that require command
+ * substitution, arithmetic expansion or other forms of parameter expansion
+ * are expanded by /bin/sh, which is given the same environment. Like
+ * wordexp(3) with WRDE_UNDEF, the variables these forms refer to must be
+ * defined, so ${NAME:-default} does not substitute a default for an
+ * undefined variable.
+ *
+ * The expansion does not touch any process-wide state: words can be expanded
+ * concurrently from multiple threads.
+ *
+ * \param[in] word      The word to expand
+ * \param[in] env       The environment to expand the variables from
+ * \param[out] expanded The collection to append the resulting fields to
+ * \throws WordExpansionError   The word contains an undefined variable, an
+ * unquoted special character (one of |, &, ;, <, >, (, ), {, } or a newline),
+ * a syntax error or its substitutions failed. Nothing is appended in this case.
+ */
+void expandWord(std::string_view word, const config::EnvironmentCollection& env,
+                TaskCollection* expanded);
+} // namespace execHelper::core
+
+#endif /* __WORD_EXPANDER_H__ */
@@ -0,0 +1,115 @@
+#include "durations.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "logger.h"
+#include "task.h"
+
+using std::ifstream;
+using std::lock_guard;
+using std::mutex;
+using std::ofstream;
+using std::string;
+using std::chrono::duration;
+using std::chrono::steady_clock;
+
+using execHelper::config::Path;
+
+namespace {
+auto escape(const string& key) -> string {
+    string escaped;
+    escaped.reserve(key.size());
+    for(const auto character : key) {
+        if(character == '\\') {
+            escaped.append(R"(\\)");
+        } else if(character == '\n') {
+            escaped.append(R"(\n)");
+        } else {
+            escaped.push_back(character);
+        }
+    }
+    return escaped;
+}
+
+auto unescape(const string& escaped) -> string {
+    string key;
+    key.reserve(escaped.size());
+    for(size_t i = 0U; i < escaped.size(); ++i) {
+        if(escaped[i] == '\\' && i + 1U < escaped.size()) {
+            ++i;
+            key.push_back(escaped[i] == 'n' ? '\n' : escaped[i]);
+        } else {
+            key.push_back(escaped[i]);
+        }
+    }
+    return key;
+}
+} // namespace
+
+namespace execHelper::core {
+auto readDurations(const Path& file) -> Durations {
+    Durations durations;
+    ifstream stream(file);
+    string line;
+    while(getline(stream, line)) {
+        const auto separator = line.find('\t');
+        if(separator == string::npos) {
+            LOG(warning) << "Ignoring invalid line in " << file << ": '"
+                         << line << "'";
+            continue;
+        }
+
+        std::istringstream value(line.substr(0U, separator));
+        double seconds = 0.0;
+        if(!(value >> seconds) || seconds < 0.0) {
+            LOG(warning) << "Ignoring invalid duration in " << file << ": '"
+                         << line << "'";
+            continue;
+        }
+        durations[unescape(line.substr(separator + 1U))] = seconds;
+    }
+    LOG(debug) << "Read " << durations.size() << " durations from " << file;
+    return durations;
+}
+
+auto writeDurations(const Path& file, const Durations& durations) -> bool {
+    ofstream stream(file, std::ios::trunc);
+    stream << std::setprecision(6) << std::fixed;
+    for(const auto& [key, seconds] : durations) {
+        stream << seconds << '\t' << escape(key) << '\n';
+    }
+    stream.close();
+    return !stream.fail();
+}
+
+DurationRecordingShell::DurationRecordingShell(const Shell& shell,
+                                               TaskKey key) noexcept
+    : m_shell(shell), m_key(move(key)) {
+    ;
+}
+
+auto DurationRecordingShell::execute(const Task& task) const
+    -> ShellReturnCode {
+    const auto start = steady_clock::now();
+    auto returnCode = m_shell.execute(task);
+    const duration<double> elapsed = steady_clock::now() - start;
+
+    auto key = m_key(task);
+    lock_guard<mutex> lock(m_durationsMutex);
+    m_durations[move(key)] = elapsed.count();
+    return returnCode;
+}
+
+auto DurationRecordingShell::isExecutedSuccessfully(
+    ShellReturnCode returnCode) const noexcept -> bool {
+    return m_shell.isExecutedSuccessfully(returnCode);
+}
+
+auto DurationRecordingShell::getDurations() const -> Durations {
+    lock_guard<mutex> lock(m_durationsMutex);
+    return m_durations;
+}
+} // namespace execHelper::core
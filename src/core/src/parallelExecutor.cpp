@@ -0,0 +1,142 @@
+#include "parallelExecutor.h"
+
+#include <algorithm>
+#include <optional>
+#include <string>
+
+#include "log/log.h"
+
+#include "logger.h"
+#include "pathNotFoundError.h"
+#include "shell.h"
+#include "task.h"
+
+using std::lock_guard;
+using std::find_if;
+using std::max;
+using std::move;
+using std::mutex;
+using std::nullopt;
+using std::optional;
+using std::size_t;
+using std::string;
+using std::unique_lock;
+
+namespace execHelper::core {
+ParallelExecutor::ParallelExecutor(const Shell& shell, Callback callback,
+                                   size_t jobs, bool keepGoing) noexcept
+    : m_shell(shell), m_callback(move(callback)), m_keepGoing(keepGoing) {
+    jobs = max(jobs, size_t(1U));
+    LOG(debug) << "Starting parallel executor with " << jobs << " jobs";
+    m_workers.reserve(jobs);
+    for(size_t i = 0U; i < jobs; ++i) {
+        m_workers.emplace_back([this]() { work(); });
+    }
+}
+
+ParallelExecutor::~ParallelExecutor() noexcept {
+    wait();
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_taskAvailable.notify_all();
+    for(auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void ParallelExecutor::execute(const Task& task) noexcept {
+    schedule(ScheduledTask{task, nullopt});
+}
+
+void ParallelExecutor::executeInSequence(const Task& task,
+                                         Sequence sequence) noexcept {
+    schedule(ScheduledTask{task, sequence});
+}
+
+void ParallelExecutor::schedule(ScheduledTask&& task) noexcept {
+    {
+        lock_guard<mutex> lock(m_mutex);
+        if(m_failed && !m_keepGoing) {
+            LOG(debug) << "Not scheduling '" << task.task.toString()
+                       << "': a previous task failed";
+            return;
+        }
+        m_queue.push_back(move(task));
+    }
+    m_taskAvailable.notify_one();
+}
+
+void ParallelExecutor::wait() noexcept {
+    unique_lock<mutex> lock(m_mutex);
+    m_idle.wait(lock, [this]() { return m_queue.empty() && m_running == 0U; });
+}
+
+auto ParallelExecutor::getRunnable() noexcept -> Queue::iterator {
+    // The first scheduled task of a sequence is always the next one of it
+    return find_if(m_queue.begin(), m_queue.end(), [this](const auto& task) {
+        return !task.sequence || m_runningSequences.count(*task.sequence) == 0U;
+    });
+}
+
+void ParallelExecutor::work() noexcept {
+    unique_lock<mutex> lock(m_mutex);
+    while(true) {
+        m_taskAvailable.wait(lock, [this]() {
+            return m_shutdown || getRunnable() != m_queue.end();
+        });
+        auto runnable = getRunnable();
+        if(runnable == m_queue.end()) {
+            return; // Only reached on shutdown
+        }
+
+        Task task = move(runnable->task);
+        const auto sequence = runnable->sequence;
+        m_queue.erase(runnable);
+        if(sequence) {
+            m_runningSequences.insert(*sequence);
+        }
+        ++m_running;
+
+        // The user feedback is only given while holding the lock, so the
+        // feedback of concurrently executed tasks does not interleave
+        user_feedback_info("Executing '" << task.toString() << "'");
+        lock.unlock();
+
+        Shell::ShellReturnCode returnCode = 0U;
+        bool success = true;
+        optional<string> error;
+        try {
+            returnCode = m_shell.execute(task);
+            success = m_shell.isExecutedSuccessfully(returnCode);
+        } catch(const PathNotFoundError& e) {
+            error = e.what();
+            returnCode = 1U;
+            success = false;
+        }
+
+        lock.lock();
+        if(error) {
+            user_feedback_error("Execution error: " << *error);
+        }
+        --m_running;
+        if(sequence) {
+            m_runningSequences.erase(*sequence);
+            m_taskAvailable.notify_all(); // The next task of the sequence
+        }
+        if(!success) {
+            m_callback(returnCode);
+            m_failed = true;
+            if(!m_keepGoing) {
+                LOG(debug) << "Discarding " << m_queue.size()
+                           << " scheduled tasks after a failure";
+                m_queue.clear();
+            }
+        }
+        if(m_queue.empty() && m_running == 0U) {
+            m_idle.notify_all();
+        }
+    }
+}
+} // namespace execHelper::core
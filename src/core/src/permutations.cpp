@@ -0,0 +1,69 @@
+#include "permutations.h"
+
+#include <limits>
+#include <stdexcept>
+
+#include "log/assertions.h"
+
+using std::numeric_limits;
+using std::overflow_error;
+using std::size_t;
+using std::vector;
+
+namespace execHelper::core {
+Permutations::Permutations(Radices radices)
+    : m_radices(std::move(radices)), m_size(1U) {
+    for(const auto radix : m_radices) {
+        if(radix == 0U) {
+            m_size = 0U;
+            return;
+        }
+    }
+    for(const auto radix : m_radices) {
+        if(m_size > numeric_limits<Index>::max() / radix) {
+            throw overflow_error("Too many combinations to enumerate");
+        }
+        m_size *= radix;
+    }
+}
+
+auto Permutations::size() const noexcept -> Index { return m_size; }
+
+auto Permutations::dimensions() const noexcept -> size_t {
+    return m_radices.size();
+}
+
+void Permutations::combination(Index index,
+                               Combination* combination) const noexcept {
+    expects(index < m_size);
+    combination->resize(m_radices.size());
+    for(auto dimension = m_radices.size(); dimension > 0U; --dimension) {
+        const auto radix = m_radices[dimension - 1U];
+        (*combination)[dimension - 1U] = index % radix;
+        index /= radix;
+    }
+}
+
+auto Permutations::combination(Index index) const -> Combination {
+    Combination result;
+    combination(index, &result);
+    return result;
+}
+
+auto Permutations::split(size_t nbOfRanges) const -> vector<Range> {
+    expects(nbOfRanges > 0U);
+    vector<Range> ranges;
+    ranges.reserve(nbOfRanges);
+
+    const auto rangeSize = m_size / nbOfRanges;
+    const auto remainder = m_size % nbOfRanges;
+    Index begin = 0U;
+    for(size_t range = 0U; range < nbOfRanges; ++range) {
+        const auto end = begin + rangeSize + (range < remainder ? 1U : 0U);
+        ranges.emplace_back(begin, end);
+        begin = end;
+    }
+    ensures(begin == m_size);
+    return ranges;
+}
+} // namespace execHelper::core
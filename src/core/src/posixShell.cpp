@@ -1,21 +1,19 @@
 #include "posixShell.h"
 #include "log/log.h"
 
-#include <span>
+#include <mutex>
 #include <vector>
 
 #ifdef _WIN32
 #include <boost/algorithm/string.hpp>
 #else
-#include <glob.h>
-#include <wordexp.h>
+#include "wordExpander.h"
 #endif
 
 #include <boost/filesystem.hpp>
 #include <boost/process.hpp>
 #include <boost/process/start_dir.hpp>
 
-#include "config/envp.h"
 #include "log/assertions.h"
 
 #include "logger.h"
@@ -26,10 +24,10 @@ using boost::replace_all;
 #endif
 
 using std::exception;
-using std::span;
+using std::move;
 using std::string;
 
-using execHelper::config::Envp;
+using execHelper::config::EnvironmentCollection;
 
 namespace process = boost::process;
 namespace this_process = boost::this_process;
@@ -37,6 +35,12 @@ namespace filesystem = boost::filesystem;
 
 namespace {
 const execHelper::core::PosixShell::ShellReturnCode POSIX_SUCCESS = 0U;
+const std::size_t MAX_CACHED_ENVIRONMENTS = 64U;
+#ifdef _WIN32
+const char PATH_DELIMITER = ';';
+#else
+const char PATH_DELIMITER = ':';
+#endif
 
 /**
  * This construction constructs the PATH from its parents' path and the various inputs.
@@ -46,7 +50,7 @@ const execHelper::core::PosixShell::ShellReturnCode POSIX_SUCCESS = 0U;
  * \param[in] workingDir    The working directory from where the path will operate
  * \returns The constructed PATH for the child. The first entry will be the given working directory
  */
-inline auto getPath(const process::environment& env,
+inline auto getPath(const EnvironmentCollection& env,
                     const filesystem::path& workingDir) noexcept
     -> std::vector<filesystem::path> {
     std::vector<filesystem::path> path;
@@ -60,13 +64,20 @@ inline auto getPath(const process::environment& env,
         return {};
     }
 
-    try {
-        std::vector<std::string> stringPaths = env.at("PATH").to_vector();
-        path.reserve(path.size() + stringPaths.size());
-        std::move(stringPaths.begin(), stringPaths.end(),
-                  std::back_inserter(path));
+    auto pathValue = env.find("PATH");
+    if(pathValue != env.end()) {
+        const auto& paths = pathValue->second;
+        size_t begin = 0U;
+        while(begin <= paths.size()) {
+            auto end = paths.find(PATH_DELIMITER, begin);
+            if(end == string::npos) {
+                end = paths.size();
+            }
+            path.emplace_back(paths.substr(begin, end - begin));
+            begin = end + 1U;
+        }
         LOG(debug) << "Added current path to the PATH environment variable";
-    } catch(const exception&) {
+    } else {
         LOG(debug) << "PATH environment variable does not exist. Adding the "
                       "path of this executable to the PATH!";
         try {
@@ -81,63 +92,155 @@ inline auto getPath(const process::environment& env,
     }
     return path;
 }
-} // namespace
-
-namespace execHelper::core {
-auto PosixShell::execute(const Task& task) const
-    -> PosixShell::ShellReturnCode {
-    if(task.getTask().empty()) {
-        return POSIX_SUCCESS;
-    }
-
-    process::environment env = this_process::
-        environment(); // Explicitly copy the environment so that only the child environment is modified
-    for(const auto& envPair : task.getEnvironment()) {
-        env[envPair.first] = envPair.second;
-    }
 
-    TaskCollection args = shellExpand(task);
-    filesystem::path binary = args.front();
+/**
+ * Searches the absolute path to the given binary
+ *
+ * \param[in] binary    The binary to search for
+ * \param[in] env       The environment to search the binary in
+ * \param[in] workingDirectory  The working directory of the binary
+ * \returns The absolute path to the binary
+ * \throws PathNotFoundError    The binary could not be found
+ */
+inline auto findBinary(const string& binary, const EnvironmentCollection& env,
+                       const execHelper::config::Path& workingDirectory)
+    -> filesystem::path {
+    using execHelper::core::PathNotFoundError;
 
-    if(binary.is_relative()) {
-        binary = process::search_path(
-            args.front(),
+    filesystem::path result = binary;
+    if(result.is_relative()) {
+        result = process::search_path(
+            binary,
             getPath(
                 env,
                 filesystem::path(
-                    task.getWorkingDirectory()))); // getPath guarantees that the given working directory is part of the PATH it returns, so there is no need to explicitly look for the binary in the considered working directory first.
+                    workingDirectory
+                        .string()))); // getPath guarantees that the given working directory is part of the PATH it returns, so there is no need to explicitly look for the binary in the considered working directory first.
 
-        if(binary.empty()) {
+        if(result.empty()) {
             throw PathNotFoundError(
                 std::string("Failed to convert binary '")
-                    .append(args.front())
+                    .append(binary)
                     .append("' to an absolute path. Are you sure the binary is "
                             "in your PATH?"));
         }
 
-        LOG(debug) << "Binary is relative. Corrected to " << binary;
-        binary = filesystem::absolute(binary);
-        LOG(debug) << "Binary " << args.front() << " is relative. Corrected to "
-                   << binary;
+        result = filesystem::absolute(result);
+        LOG(debug) << "Binary " << binary << " is relative. Corrected to "
+                   << result;
     }
-    if(!filesystem::exists(binary)) {
+    if(!filesystem::exists(result)) {
         throw PathNotFoundError(std::string("Could not find binary '")
-                                    .append(args.front())
+                                    .append(binary)
                                     .append("' on this system"));
     }
-    if(!filesystem::is_regular_file(binary) &&
-       !filesystem::is_symlink(binary)) {
+    if(!filesystem::is_regular_file(result) &&
+       !filesystem::is_symlink(result)) {
         throw PathNotFoundError(std::string("Cannot execute a non-file binary ")
-                                    .append(binary.string()));
+                                    .append(result.string()));
+    }
+    return result;
+}
+} // namespace
+
+namespace execHelper::core {
+auto PosixShell::execute(const Task& task) const
+    -> PosixShell::ShellReturnCode {
+    if(task.getTask().empty()) {
+        return POSIX_SUCCESS;
     }
 
+    auto env = getEnvironment(task);
+
+    TaskCollection args = shellExpand(task, env->collection);
+    if(args.empty()) {
+        return POSIX_SUCCESS;
+    }
+
+    auto binary =
+        resolve(args.front(), env->collection, task.getWorkingDirectory());
     args.erase(args.begin());
+    return launch(binary, args, task.getWorkingDirectory(), *env);
+}
+
+auto PosixShell::getEnvironment(const Task& task) const
+    -> std::shared_ptr<const Environment> {
+    std::lock_guard<std::mutex> lock(m_environmentsMutex);
+    auto inherited = task.getInheritedEnvironment();
+    if(!inherited) {
+        if(!m_processEnvironment) {
+            // The environment of this process does not change during a run
+            EnvironmentCollection processEnvironment;
+            for(const auto& entry : this_process::environment()) {
+                processEnvironment.emplace(entry.get_name(), entry.to_string());
+            }
+            m_processEnvironment = std::make_shared<const EnvironmentCollection>(
+                move(processEnvironment));
+        }
+        inherited = m_processEnvironment;
+    }
+
+    EnvironmentKey key(inherited, task.getEnvironment());
+    auto environment = m_environments.find(key);
+    if(environment != m_environments.end()) {
+        return environment->second;
+    }
+
+    if(m_environments.size() >= MAX_CACHED_ENVIRONMENTS) {
+        m_environments.clear();
+    }
+    EnvironmentCollection collection(*inherited);
+    for(const auto& envPair : task.getEnvironment()) {
+        collection.insert_or_assign(envPair.first, envPair.second);
+    }
+    auto result = std::make_shared<const Environment>(move(collection));
+    m_environments.emplace(move(key), result);
+    return result;
+}
+
+auto PosixShell::resolve(const string& binary, const EnvironmentCollection& env,
+                         const config::Path& workingDirectory) const
+    -> config::Path {
+    auto pathValue = env.find("PATH");
+    ResolutionKey key(binary,
+                      pathValue != env.end() ? pathValue->second : string(),
+                      workingDirectory);
+    {
+        std::lock_guard<std::mutex> lock(m_resolvedMutex);
+        auto resolved = m_resolved.find(key);
+        if(resolved != m_resolved.end()) {
+            ++m_nbOfHits;
+            LOG(trace) << "Resolved " << binary << " to " << resolved->second
+                       << " from cache (hits: " << m_nbOfHits
+                       << ", misses: " << m_nbOfMisses << ")";
+            return resolved->second;
+        }
+        ++m_nbOfMisses;
+        LOG(trace) << "Resolving " << binary << " (hits: " << m_nbOfHits
+                   << ", misses: " << m_nbOfMisses << ")";
+    }
+
+    auto result =
+        config::Path(findBinary(binary, env, workingDirectory).string());
+
+    std::lock_guard<std::mutex> lock(m_resolvedMutex);
+    m_resolved.emplace(move(key), result);
+    return result;
+}
+
+auto PosixShell::launch(const config::Path& binary, const TaskCollection& args,
+                        const config::Path& workingDirectory,
+                        const Environment& env) const -> ShellReturnCode {
+    process::environment childEnv;
+    for(const auto& envPair : env.collection) {
+        childEnv[envPair.first] = envPair.second;
+    }
 
     try {
-        return system(binary, process::args = args,
+        return system(filesystem::path(binary.string()), process::args = args,
                       process::start_dir =
-                          filesystem::path(task.getWorkingDirectory()),
-                      env);
+                          filesystem::path(workingDirectory.string()),
+                      childEnv);
     } catch(const boost::process::process_error& e) {
         LOG(error) << "Failed to execute command with " << binary;
         user_feedback_error("Failed to execute command. Are you sure "
@@ -151,72 +254,43 @@ auto PosixShell::isExecutedSuccessfully(
     return returnCode == POSIX_SUCCESS;
 }
 
-inline auto PosixShell::shellExpand(const Task& task) noexcept
+inline auto PosixShell::shellExpand(const Task& task,
+                                    const EnvironmentCollection& env) noexcept
     -> TaskCollection {
-    return wordExpand(task);
+    return wordExpand(task, env);
 }
 
-inline auto PosixShell::wordExpand(const Task& task) noexcept
+inline auto PosixShell::wordExpand(const Task& task,
+                                   const EnvironmentCollection& env) noexcept
     -> TaskCollection {
 #ifdef _WIN32
     TaskCollection result;
 
-    auto environment = task.getEnvironment();
+    auto environment = env;
 
     // Windows has some 'special' environment variables
     environment["cd"] = task.getWorkingDirectory().string();
     environment["CD"] = task.getWorkingDirectory().string();
 
     for(auto arg : task.getTask()) {
-        for(const auto& env : environment) {
-            auto pattern = std::string("%").append(env.first).append("%");
-            replace_all(arg, pattern, env.second);
+        for(const auto& envPair : environment) {
+            auto pattern = std::string("%").append(envPair.first).append("%");
+            replace_all(arg, pattern, envPair.second);
         }
         result.emplace_back(arg);
     }
     return result;
 
 #else
-    // Cache envp pointer
-    char** cached_environ = environ;
-
-    // Set global environment, since this is where wordexp will look for substitutions
-    auto envp = Envp(task.getEnvironment());
-    environ = envp.getEnvp();
-
     TaskCollection result;
     for(const auto& taskItem : task.getTask()) {
-        wordexp_t expanded{};
-        size_t returnCode =
-            wordexp(taskItem.c_str(), // NOLINT(concurrency-mt-unsafe
-                    &expanded,        // NOLINT(concurrency-mt-unsafe)
-                    WRDE_SHOWERR | WRDE_UNDEF);
-        if(returnCode == 0) {
-            std::span<char*> word(expanded.we_wordv, expanded.we_wordc);
-            std::copy(word.begin(), word.end(), std::back_inserter(result));
-        } else {
-            switch(returnCode) {
-            case WRDE_BADVAL:
-                user_feedback_error("Command contains undefined variable");
-                break;
-            case WRDE_SYNTAX:
-                user_feedback_error("Syntax error in shell argument");
-                break;
-            case WRDE_BADCHAR:
-                user_feedback_error("Bad character: Illegal occurrence of "
-                                    "newline or one of |, &, ;, <, >, (, ), {, "
-                                    "}.");
-                break;
-            default:
-                user_feedback_error(
-                    "An error occured during executing: " << returnCode);
-                break;
-            }
+        try {
+            expandWord(taskItem, env, &result);
+        } catch(const WordExpansionError& e) {
+            user_feedback_error(e.what());
             result.push_back(taskItem);
         }
-        wordfree(&expanded);
     }
-    environ = cached_environ;
     return result;
 #endif
 }
@@ -0,0 +1,291 @@
+#include "processSupervisor.h"
+
+#include <array>
+#include <cerrno>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "config/envp.h"
+#include "log/assertions.h"
+
+#include "logger.h"
+
+using std::array;
+using std::generic_category;
+using std::move;
+using std::size_t;
+using std::string;
+using std::string_view;
+using std::system_error;
+using std::vector;
+using std::chrono::milliseconds;
+
+using execHelper::config::EnvironmentCollection;
+using execHelper::config::Envp;
+using execHelper::config::Path;
+
+namespace {
+const execHelper::core::Shell::ShellReturnCode SIGNAL_OFFSET = 128U;
+const execHelper::core::Shell::ShellReturnCode EXEC_FAILED = 127U;
+const milliseconds POLLING_INTERVAL(10);
+const size_t MAX_EVENTS = 64U;
+const size_t READ_SIZE = 4096U;
+
+/**
+ * Returns a pidfd for the given process or -1 if the kernel does not support them
+ */
+inline auto openPidfd(pid_t pid) noexcept -> int {
+#ifdef SYS_pidfd_open
+    return static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+#else
+    (void)pid;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+inline auto toReturnCode(int status) noexcept
+    -> execHelper::core::Shell::ShellReturnCode {
+    if(WIFSIGNALED(status)) {
+        return SIGNAL_OFFSET + WTERMSIG(status);
+    }
+    return WEXITSTATUS(status);
+}
+
+inline void closeAll(const vector<int>& fds) noexcept {
+    for(const auto fd : fds) {
+        if(fd >= 0) {
+            close(fd);
+        }
+    }
+}
+} // namespace
+
+namespace execHelper::core {
+ProcessSupervisor::ProcessSupervisor() : m_epoll(epoll_create1(EPOLL_CLOEXEC)) {
+    if(m_epoll < 0) {
+        throw system_error(errno, generic_category(),
+                           "Failed to create the event loop");
+    }
+}
+
+ProcessSupervisor::~ProcessSupervisor() noexcept {
+    run();
+    close(m_epoll);
+}
+
+auto ProcessSupervisor::spawn(const Path& binary, const TaskCollection& args,
+                              const Path& workingDirectory,
+                              const EnvironmentCollection& env,
+                              ExitCallback onExit, OutputCallback onOutput)
+    -> pid_t {
+    // Prepare everything the child needs up front: only async-signal-safe calls are allowed after forking
+    const string binaryString = binary.string();
+    const string workingDirectoryString = workingDirectory.string();
+    vector<char*> argv;
+    argv.reserve(args.size() + 2U);
+    argv.push_back(const_cast<char*>(binaryString.c_str())); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+    for(const auto& arg : args) {
+        argv.push_back(const_cast<char*>(arg.c_str())); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+    }
+    argv.push_back(nullptr);
+    Envp envp(env);
+
+    array<int, 2> out{-1, -1};
+    array<int, 2> err{-1, -1};
+    if(onOutput && (pipe2(out.data(), O_CLOEXEC) != 0 ||
+                    pipe2(err.data(), O_CLOEXEC) != 0)) {
+        auto error = errno;
+        closeAll({out[0], out[1], err[0], err[1]});
+        throw system_error(error, generic_category(),
+                           "Failed to create the output pipes");
+    }
+
+    pid_t pid = fork();
+    if(pid < 0) {
+        auto error = errno;
+        closeAll({out[0], out[1], err[0], err[1]});
+        throw system_error(error, generic_category(),
+                           "Failed to spawn " + binaryString);
+    }
+    if(pid == 0) {
+        if(onOutput && (dup2(out[1], STDOUT_FILENO) < 0 ||
+                        dup2(err[1], STDERR_FILENO) < 0)) {
+            _exit(EXEC_FAILED);
+        }
+        if(chdir(workingDirectoryString.c_str()) != 0) {
+            _exit(EXEC_FAILED);
+        }
+        execve(binaryString.c_str(), argv.data(), envp.getEnvp());
+        _exit(EXEC_FAILED);
+    }
+    LOG(debug) << "Spawned " << binary << " with pid " << pid;
+    closeAll({out[1], err[1]});
+
+    Child& child = m_children[pid];
+    child.onExit = move(onExit);
+    child.onOutput = move(onOutput);
+    child.out = out[0];
+    child.err = err[0];
+    child.pidfd = openPidfd(pid);
+    if(child.pidfd < 0) {
+        LOG(debug) << "No pidfd available for " << pid
+                   << ": falling back to polling";
+        ++m_nbOfPolled;
+    }
+    try {
+        if(child.pidfd >= 0) {
+            watch(child.pidfd, pid);
+        }
+        if(child.out >= 0) {
+            watch(child.out, pid);
+            watch(child.err, pid);
+        }
+    } catch(const system_error& e) {
+        // The child is already running: keep supervising it through polling
+        LOG(error) << "Failed to watch " << pid << ": " << e.what();
+        if(child.pidfd >= 0) {
+            unwatch(&child.pidfd);
+            ++m_nbOfPolled;
+        }
+        unwatch(&child.out);
+        unwatch(&child.err);
+    }
+    return pid;
+}
+
+auto ProcessSupervisor::size() const noexcept -> size_t {
+    return m_children.size();
+}
+
+auto ProcessSupervisor::poll(milliseconds timeout) noexcept -> size_t {
+    if(m_children.empty()) {
+        return 0U;
+    }
+    if(m_nbOfPolled > 0U &&
+       (timeout.count() < 0 || timeout > POLLING_INTERVAL)) {
+        timeout = POLLING_INTERVAL;
+    }
+
+    array<epoll_event, MAX_EVENTS> events{};
+    int nbOfEvents = epoll_wait(m_epoll, events.data(), events.size(),
+                                static_cast<int>(timeout.count()));
+    if(nbOfEvents < 0 && errno != EINTR) {
+        LOG(error) << "Failed to wait for events: " << errno;
+    }
+
+    for(int i = 0; i < nbOfEvents; ++i) {
+        int fd = events.at(i).data.fd;
+        auto pidIt = m_fds.find(fd);
+        if(pidIt == m_fds.end()) {
+            continue; // Already closed while handling an earlier event
+        }
+        pid_t pid = pidIt->second;
+        auto& child = m_children.at(pid);
+        if(fd == child.pidfd) {
+            reap(pid, &child);
+        } else if(fd == child.out) {
+            drain(pid, &child, &child.out, OutputStream::out);
+        } else if(fd == child.err) {
+            drain(pid, &child, &child.err, OutputStream::err);
+        }
+    }
+
+    if(m_nbOfPolled > 0U) {
+        for(auto& [pid, child] : m_children) {
+            if(child.pidfd < 0 && !child.exited) {
+                reap(pid, &child);
+            }
+        }
+    }
+    return finish();
+}
+
+void ProcessSupervisor::run() noexcept {
+    const milliseconds forever(-1);
+    while(!m_children.empty()) {
+        poll(forever);
+    }
+}
+
+void ProcessSupervisor::watch(int fd, pid_t pid) {
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if(epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event) != 0) {
+        throw system_error(errno, generic_category(),
+                           "Failed to watch a child");
+    }
+    m_fds.emplace(fd, pid);
+}
+
+void ProcessSupervisor::unwatch(int* fd) noexcept {
+    if(*fd < 0) {
+        return;
+    }
+    epoll_ctl(m_epoll, EPOLL_CTL_DEL, *fd, nullptr);
+    m_fds.erase(*fd);
+    close(*fd);
+    *fd = -1;
+}
+
+void ProcessSupervisor::drain(pid_t pid, Child* child, int* fd,
+                              OutputStream stream) noexcept {
+    array<char, READ_SIZE> buffer{};
+    auto nbOfBytes = read(*fd, buffer.data(), buffer.size());
+    if(nbOfBytes > 0) {
+        child->onOutput(stream,
+                        string_view(buffer.data(), size_t(nbOfBytes)));
+        return;
+    }
+    if(nbOfBytes < 0 && (errno == EAGAIN || errno == EINTR)) {
+        return;
+    }
+    LOG(trace) << "Output of " << pid << " closed";
+    unwatch(fd);
+}
+
+void ProcessSupervisor::reap(pid_t pid, Child* child) noexcept {
+    int status = 0;
+    auto result = waitpid(pid, &status, WNOHANG);
+    if(result == 0 || (result < 0 && errno == EINTR)) {
+        return; // Still running
+    }
+    child->exited = true;
+    child->returnCode = result < 0 ? EXEC_FAILED : toReturnCode(status);
+    LOG(debug) << "Child " << pid << " exited with "
+               << int(child->returnCode);
+    if(child->pidfd < 0) {
+        expects(m_nbOfPolled > 0U);
+        --m_nbOfPolled;
+    }
+    unwatch(&child->pidfd);
+}
+
+auto ProcessSupervisor::finish() noexcept -> size_t {
+    size_t nbOfFinished = 0U;
+    for(auto it = m_children.begin(); it != m_children.end();) {
+        auto& child = it->second;
+        // Only report the exit once all output of the child was delivered
+        if(!child.exited || child.out >= 0 || child.err >= 0) {
+            ++it;
+            continue;
+        }
+        auto onExit = move(child.onExit);
+        auto returnCode = child.returnCode;
+        it = m_children.erase(it);
+        ++nbOfFinished;
+        if(onExit) {
+            onExit(returnCode);
+        }
+    }
+    return nbOfFinished;
+}
+} // namespace execHelper::core
@@ -0,0 +1,110 @@
+#include "sharding.h"
+
+#include <algorithm>
+#include <charconv>
+#include <numeric>
+#include <string>
+
+#include "logger.h"
+#include "task.h"
+
+using std::accumulate;
+using std::from_chars;
+using std::min_element;
+using std::size_t;
+using std::string;
+using std::string_view;
+using std::to_string;
+
+namespace {
+auto toNumber(string_view value) -> size_t {
+    size_t number = 0U;
+    const auto* end = value.data() + value.size();
+    auto [last, error] = from_chars(value.data(), end, number);
+    if(value.empty() || error != std::errc() || last != end) {
+        throw execHelper::core::InvalidShardError(
+            "'" + string(value) + "' is not a valid number");
+    }
+    return number;
+}
+} // namespace
+
+namespace execHelper::core {
+auto parseShard(string_view value) -> Shard {
+    const auto separator = value.find('/');
+    if(separator == string_view::npos) {
+        throw InvalidShardError("Invalid shard '" + string(value) +
+                                "': expected INDEX/COUNT");
+    }
+
+    const auto index = toNumber(value.substr(0U, separator));
+    const auto count = toNumber(value.substr(separator + 1U));
+    if(index == 0U || index > count) {
+        throw InvalidShardError("Invalid shard '" + string(value) +
+                                "': INDEX must be between 1 and COUNT");
+    }
+    if(count > MAX_SHARD_COUNT) {
+        throw InvalidShardError("Invalid shard '" + string(value) +
+                                "': COUNT must be at most " +
+                                to_string(MAX_SHARD_COUNT));
+    }
+    return Shard{index - 1U, count};
+}
+
+ShardedExecutor::ShardedExecutor(ExecutorInterface& executor, Shard shard,
+                                 Durations durations, TaskKey key)
+    : m_executor(executor),
+      m_shard(shard),
+      m_durations(move(durations)),
+      m_key(move(key)),
+      m_defaultDuration(1.0),
+      m_loads(shard.count, 0.0) {
+    if(!m_durations.empty()) {
+        m_defaultDuration =
+            accumulate(m_durations.begin(), m_durations.end(), 0.0,
+                       [](double sum, const auto& duration) {
+                           return sum + duration.second;
+                       }) /
+            static_cast<double>(m_durations.size());
+    }
+}
+
+void ShardedExecutor::execute(const Task& task) noexcept {
+    if(assign(task)) {
+        m_executor.execute(task);
+    }
+}
+
+void ShardedExecutor::executeInSequence(const Task& task,
+                                        Sequence sequence) noexcept {
+    if(assign(task)) {
+        m_executor.executeInSequence(task, sequence);
+    }
+}
+
+auto ShardedExecutor::assign(const Task& task) noexcept -> bool {
+    auto duration = m_defaultDuration;
+    if(!m_durations.empty()) {
+        try {
+            auto recorded = m_durations.find(m_key(task));
+            if(recorded != m_durations.end()) {
+                duration = recorded->second;
+            }
+        } catch(const std::exception& e) {
+            LOG(warning) << "Failed to look up the duration of '"
+                         << task.toString() << "': " << e.what();
+        }
+    }
+
+    auto leastLoaded = min_element(m_loads.begin(), m_loads.end());
+    *leastLoaded += duration;
+    if(static_cast<size_t>(leastLoaded - m_loads.begin()) == m_shard.index) {
+        return true;
+    }
+    LOG(trace) << "Skipping '" << task.toString()
+               << "': it belongs to another shard";
+    return false;
+}
+
+void ShardedExecutor::wait() noexcept { m_executor.wait(); }
+} // namespace execHelper::core
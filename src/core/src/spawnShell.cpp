@@ -0,0 +1,136 @@
+#include "spawnShell.h"
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <spawn.h>
+#include <sys/wait.h>
+
+#include "log/log.h"
+
+#include "logger.h"
+
+#if defined(__GLIBC__)
+#if __GLIBC_PREREQ(2, 29)
+#define HAVE_POSIX_SPAWN_CHDIR
+#endif
+#endif
+
+using std::size_t;
+using std::string;
+using std::string_view;
+using std::vector;
+
+using execHelper::config::Path;
+
+#ifdef HAVE_POSIX_SPAWN_CHDIR
+namespace {
+const execHelper::core::Shell::ShellReturnCode SIGNAL_OFFSET = 128U;
+const execHelper::core::Shell::ShellReturnCode LAUNCH_FAILED = 1U;
+
+/**
+ * \brief A block of null terminated strings and a null terminated array of pointers to them
+ */
+class StringBlock {
+  public:
+    void clear() noexcept {
+        m_buffer.clear();
+        m_offsets.clear();
+        m_pointers.clear();
+    }
+
+    void append(string_view value) noexcept {
+        m_offsets.push_back(m_buffer.size());
+        m_buffer.insert(m_buffer.end(), value.begin(), value.end());
+        m_buffer.push_back('\0');
+    }
+
+    /**
+     * Returns the pointers to all appended strings
+     *
+     * \note The returned pointers are invalidated by any further modification
+     */
+    auto data() noexcept -> char* const* {
+        for(const auto offset : m_offsets) {
+            m_pointers.push_back(&m_buffer[offset]);
+        }
+        m_pointers.push_back(nullptr);
+        return m_pointers.data();
+    }
+
+  private:
+    vector<char> m_buffer;
+    vector<size_t> m_offsets;
+    vector<char*> m_pointers;
+};
+
+/**
+ * Returns the reusable buffer for the argument block of the calling thread
+ */
+inline auto getArgv() noexcept -> StringBlock& {
+    thread_local StringBlock argv;
+    argv.clear(); // Keeps the allocated capacity of earlier launches
+    return argv;
+}
+
+inline auto toReturnCode(int status) noexcept
+    -> execHelper::core::Shell::ShellReturnCode {
+    if(WIFSIGNALED(status)) {
+        return SIGNAL_OFFSET + WTERMSIG(status);
+    }
+    return WEXITSTATUS(status);
+}
+} // namespace
+#endif
+
+namespace execHelper::core {
+auto SpawnShell::launch(const Path& binary, const TaskCollection& args,
+                        const Path& workingDirectory,
+                        const Environment& env) const -> ShellReturnCode {
+#ifndef HAVE_POSIX_SPAWN_CHDIR
+    // Changing the working directory of the child requires posix_spawn_file_actions_addchdir_np
+    return PosixShell::launch(binary, args, workingDirectory, env);
+#else
+    auto& argv = getArgv();
+    const auto& binaryString = binary.native();
+    argv.append(binaryString);
+    for(const auto& arg : args) {
+        argv.append(arg);
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    int result = posix_spawn_file_actions_addchdir_np(
+        &actions, workingDirectory.c_str());
+
+    pid_t pid = 0;
+    if(result == 0) {
+        result = posix_spawn(
+            &pid, binaryString.c_str(), &actions, nullptr, argv.data(),
+            const_cast<char* const*>( // NOLINT(cppcoreguidelines-pro-type-const-cast)
+                env.envp.getEnvp()));
+    }
+    posix_spawn_file_actions_destroy(&actions);
+
+    if(result != 0) {
+        LOG(error) << "Failed to spawn " << binary << ": "
+                   << std::strerror(result);
+        user_feedback_error("Failed to execute command. Are you sure "
+                            << binary << " is available for this user?'");
+        return LAUNCH_FAILED;
+    }
+
+    int status = 0;
+    while(waitpid(pid, &status, 0) < 0) {
+        if(errno != EINTR) {
+            LOG(error) << "Failed to wait for " << binary << ": "
+                       << std::strerror(errno);
+            return LAUNCH_FAILED;
+        }
+    }
+    return toReturnCode(status);
+#endif
+}
+} // namespace execHelper::core
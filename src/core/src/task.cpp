@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <filesystem>
 #include <iostream>
+#include <new>
 #include <numeric>
 #include <ostream>
 #include <utility>
@@ -65,6 +66,26 @@ auto Task::getEnvironment() const noexcept -> const EnvironmentCollection& {
     return m_env;
 }
 
+auto Task::getInheritedEnvironment() const noexcept
+    -> const InheritedEnvironment& {
+    return m_inheritedEnv;
+}
+
+void Task::setInheritedEnvironment(InheritedEnvironment env) noexcept {
+    m_inheritedEnv = move(env);
+}
+
+auto Task::getFullEnvironment() const -> EnvironmentCollection {
+    if(!m_inheritedEnv) {
+        return m_env;
+    }
+    EnvironmentCollection result(*m_inheritedEnv);
+    for(const auto& envPair : m_env) {
+        result.insert_or_assign(envPair.first, envPair.second);
+    }
+    return result;
+}
+
 void Task::setWorkingDirectory(const Path& workingDirectory) noexcept {
     LOG(trace) << "Changing working directory of task to " << workingDirectory;
     m_workingDirectory = workingDirectory;
@@ -141,9 +162,19 @@ auto Task::getPatterns() const noexcept -> const config::Patterns& {
 }
 
 auto Task::operator==(const Task& other) const noexcept -> bool {
-    return (m_task == other.m_task &&
-            m_workingDirectory == other.m_workingDirectory &&
-            m_env == other.m_env);
+    if(m_task != other.m_task ||
+       m_workingDirectory != other.m_workingDirectory) {
+        return false;
+    }
+    if(m_inheritedEnv == other.m_inheritedEnv) {
+        return m_env == other.m_env;
+    }
+    try {
+        return getFullEnvironment() == other.getFullEnvironment();
+    } catch(const std::bad_alloc& e) {
+        LOG(error) << e.what();
+        return false;
+    }
 }
 
 auto Task::operator!=(const Task& other) const noexcept -> bool {
@@ -155,6 +186,11 @@ auto operator<<(ostream& stream, const Task& task) noexcept -> ostream& {
     EnvironmentCollection environment = task.getEnvironment();
     stream << string("Task {");
 
+    const auto& inherited = task.getInheritedEnvironment();
+    if(inherited) {
+        stream << string("Inherited environment(") << inherited->size()
+               << ") ";
+    }
     stream << string("Environment(") << environment.size() << "): {";
     for(const auto& envVar : environment) {
         stream << string(" ") << envVar.first << ": " << envVar.second << ";";
@@ -0,0 +1,109 @@
+#include "taskGraph.h"
+
+#include <algorithm>
+
+#include "log/assertions.h"
+
+#include "logger.h"
+
+using std::find;
+using std::move;
+using std::size_t;
+using std::sort;
+using std::string;
+using std::vector;
+
+namespace execHelper::core {
+auto TaskGraph::addNode(string name, Tasks tasks) noexcept -> Node {
+    m_nodes.push_back(NodeData{move(name), move(tasks), {}});
+    return m_nodes.size() - 1U;
+}
+
+void TaskGraph::addDependency(Node node, Node dependency) noexcept {
+    expects(node < m_nodes.size());
+    expects(dependency < m_nodes.size());
+
+    auto& dependencies = m_nodes[node].dependencies;
+    if(find(dependencies.begin(), dependencies.end(), dependency) ==
+       dependencies.end()) {
+        LOG(trace) << "'" << m_nodes[node].name << "' depends on '"
+                   << m_nodes[dependency].name << "'";
+        dependencies.push_back(dependency);
+    }
+}
+
+void TaskGraph::setTasks(Node node, Tasks tasks) noexcept {
+    expects(node < m_nodes.size());
+    m_nodes[node].tasks = move(tasks);
+}
+
+auto TaskGraph::getName(Node node) const noexcept -> const string& {
+    expects(node < m_nodes.size());
+    return m_nodes[node].name;
+}
+
+auto TaskGraph::getTasks(Node node) const noexcept -> const Tasks& {
+    expects(node < m_nodes.size());
+    return m_nodes[node].tasks;
+}
+
+auto TaskGraph::size() const noexcept -> size_t { return m_nodes.size(); }
+
+auto TaskGraph::getStages() const -> Stages {
+    // Kahn's algorithm, processing all nodes without remaining dependencies at once
+    vector<size_t> remaining(m_nodes.size());
+    vector<vector<Node>> dependents(m_nodes.size());
+    Stage current;
+    for(Node node = 0U; node < m_nodes.size(); ++node) {
+        remaining[node] = m_nodes[node].dependencies.size();
+        for(const auto dependency : m_nodes[node].dependencies) {
+            dependents[dependency].push_back(node);
+        }
+        if(remaining[node] == 0U) {
+            current.push_back(node);
+        }
+    }
+
+    Stages stages;
+    size_t nbOfScheduled = 0U;
+    while(!current.empty()) {
+        Stage next;
+        for(const auto node : current) {
+            for(const auto dependent : dependents[node]) {
+                if(--remaining[dependent] == 0U) {
+                    next.push_back(dependent);
+                }
+            }
+        }
+        sort(next.begin(), next.end());
+        nbOfScheduled += current.size();
+        stages.emplace_back(move(current));
+        current = move(next);
+    }
+
+    if(nbOfScheduled != m_nodes.size()) {
+        string cycle;
+        for(Node node = 0U; node < m_nodes.size(); ++node) {
+            if(remaining[node] > 0U) {
+                cycle.append(cycle.empty() ? "'" : ", '")
+                    .append(m_nodes[node].name)
+                    .append("'");
+            }
+        }
+        throw CyclicDependencyError(
+            string("Cyclic dependency detected involving ").append(cycle));
+    }
+    return stages;
+}
+
+auto TaskGraph::getTasks() const -> Tasks {
+    Tasks result;
+    for(const auto& stage : getStages()) {
+        for(const auto node : stage) {
+            const auto& tasks = m_nodes[node].tasks;
+            result.insert(result.end(), tasks.begin(), tasks.end());
+        }
+    }
+    return result;
+}
+} // namespace execHelper::core
@@ -0,0 +1,582 @@
+#include "wordExpander.h"
+
+#include <array>
+#include <cctype>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <glob.h>
+#include <pwd.h>
+#include <unistd.h>
+
+#include <boost/process.hpp>
+
+#include "config/pathManipulation.h"
+
+#include "logger.h"
+
+using std::array;
+using std::nullopt;
+using std::optional;
+using std::size_t;
+using std::span;
+using std::string;
+using std::string_view;
+using std::vector;
+
+using execHelper::config::EnvironmentCollection;
+using execHelper::config::getHomeDirectory;
+using execHelper::core::TaskCollection;
+using execHelper::core::WordExpansionError;
+
+namespace process = boost::process;
+
+using namespace std::literals;
+
+namespace {
+constexpr auto SPECIAL_CHARACTERS = "$`'\"\\~*?[|&;<>(){}\n \t"sv;
+constexpr auto BAD_CHARACTERS = "|&;<>(){}\n"sv;
+constexpr auto GLOB_CHARACTERS = "*?["sv;
+constexpr auto IFS_WHITESPACE = " \t\n"sv;
+constexpr auto TILDE_PREFIX_END = "/: \t"sv;
+constexpr auto DEFAULT_IFS = " \t\n"sv;
+constexpr auto DOUBLE_QUOTE_ESCAPES = "$`\"\\\n"sv;
+constexpr auto SPECIAL_PARAMETERS = "@*#?-$!"sv;
+constexpr auto SHELL = "/bin/sh";
+constexpr size_t PASSWD_BUFFER_SIZE = 4096U;
+
+inline auto contains(string_view characters, char c) noexcept -> bool {
+    return characters.find(c) != string_view::npos;
+}
+
+inline auto isNameStart(char c) noexcept -> bool {
+    return std::isalpha(static_cast<unsigned char>(c)) != 0 || c == '_';
+}
+
+inline auto isNameCharacter(char c) noexcept -> bool {
+    return std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '_';
+}
+
+inline auto syntaxError(string_view word, string_view reason)
+    -> WordExpansionError {
+    return WordExpansionError(string("Syntax error in shell argument '")
+                                  .append(word)
+                                  .append("': ")
+                                  .append(reason));
+}
+
+/**
+ * Returns the home directory of the given user
+ *
+ * \param[in] user  The user. The current user if empty.
+ * \param[in] env   The environment of the current user
+ * \returns The home directory of the user if it exists
+ */
+auto getUserHome(const string& user, const EnvironmentCollection& env)
+    -> optional<string> {
+    if(user.empty()) {
+        auto home = getHomeDirectory(env);
+        if(home) {
+            return home->string();
+        }
+    }
+
+    passwd entry{};
+    passwd* result = nullptr;
+    array<char, PASSWD_BUFFER_SIZE> buffer{};
+    if(user.empty()) {
+        getpwuid_r(getuid(), &entry, buffer.data(), buffer.size(), &result);
+    } else {
+        getpwnam_r(user.c_str(), &entry, buffer.data(), buffer.size(),
+                   &result);
+    }
+    if(result == nullptr || result->pw_dir == nullptr) {
+        return nullopt;
+    }
+    return string(result->pw_dir);
+}
+
+/**
+ * Expand the given word using the shell
+ *
+ * \param[in] word  The word to expand, in which every unquoted '#' is escaped
+ * \param[in] env   The environment of the shell
+ * \returns The fields the word expands to
+ * \throws WordExpansionError   The shell failed to expand the word
+ */
+auto expandInShell(string_view word, const EnvironmentCollection& env)
+    -> TaskCollection {
+    LOG(trace) << "Expanding '" << word << "' using " << SHELL;
+
+    process::environment shellEnv;
+    for(const auto& envPair : env) {
+        shellEnv[envPair.first] = envPair.second;
+    }
+
+    // The word must not contain an unquoted '#' that starts a comment
+    string script("set -u; set -- ");
+    script.append(word).append("; for arg do printf '%s\\0' \"$arg\"; done");
+
+    string output;
+    try {
+        process::ipstream stream;
+        process::child shell(string(SHELL),
+                             process::args = vector<string>{"-c", script},
+                             process::std_out > stream, shellEnv);
+        output.assign(std::istreambuf_iterator<char>(stream),
+                      std::istreambuf_iterator<char>());
+        shell.wait();
+        if(shell.exit_code() != 0) {
+            throw WordExpansionError(
+                string("Failed to expand shell argument '")
+                    .append(word)
+                    .append("'"));
+        }
+    } catch(const process::process_error& e) {
+        throw WordExpansionError(string("Failed to expand shell argument '")
+                                     .append(word)
+                                     .append("': ")
+                                     .append(e.what()));
+    }
+
+    TaskCollection fields;
+    size_t begin = 0U;
+    for(auto end = output.find('\0'); end != string::npos;
+        end = output.find('\0', begin)) {
+        fields.emplace_back(output.substr(begin, end - begin));
+        begin = end + 1U;
+    }
+    return fields;
+}
+
+/**
+ * \brief Collects the fields a word expands to
+ */
+class Fields {
+  public:
+    /**
+     * Create a collection of fields
+     *
+     * \param[in] ifs   The field separators to split unquoted expansions on
+     */
+    explicit Fields(string_view ifs) noexcept : m_ifs(ifs) {}
+
+    /**
+     * Append characters that are subject to neither field splitting nor
+     * pathname expansion
+     *
+     * \param[in] value The characters to append
+     */
+    void appendQuoted(string_view value) {
+        m_exists = true;
+        m_value.append(value);
+        for(const auto c : value) {
+            if(contains(GLOB_CHARACTERS, c) || c == '\\') {
+                m_pattern.push_back('\\');
+            }
+            m_pattern.push_back(c);
+        }
+    }
+
+    /**
+     * Append a character that is subject to pathname expansion
+     *
+     * \param[in] c The character to append
+     */
+    void appendUnquoted(char c) {
+        m_exists = true;
+        m_value.push_back(c);
+        m_pattern.push_back(c);
+        m_glob = m_glob || contains(GLOB_CHARACTERS, c);
+    }
+
+    /**
+     * Append the result of an unquoted expansion, which is split into fields
+     *
+     * \param[in] value The result of the expansion
+     */
+    void appendExpansion(string_view value) {
+        size_t i = 0U;
+        while(i < value.size()) {
+            if(!contains(m_ifs, value[i])) {
+                appendUnquoted(value[i]);
+                ++i;
+                continue;
+            }
+
+            // Whitespace separators surrounding at most one other separator delimit a field
+            bool delimited = false;
+            for(; i < value.size() && contains(m_ifs, value[i]); ++i) {
+                if(!contains(IFS_WHITESPACE, value[i])) {
+                    if(delimited) {
+                        break;
+                    }
+                    delimited = true;
+                }
+            }
+            finish(delimited);
+        }
+    }
+
+    /**
+     * Finish the current field
+     *
+     * \param[in] force Finish the current field, even if it is empty
+     */
+    void finish(bool force = false) {
+        if(!m_exists && !force) {
+            return;
+        }
+
+        bool matched = false;
+        if(m_glob) {
+            glob_t globbed{};
+            if(glob(m_pattern.c_str(), 0, nullptr, &globbed) == 0) {
+                span<char*> paths(globbed.gl_pathv, globbed.gl_pathc);
+                m_fields.insert(m_fields.end(), paths.begin(), paths.end());
+                matched = true;
+            }
+            globfree(&globbed);
+        }
+        if(!matched) {
+            m_fields.emplace_back(std::move(m_value));
+        }
+
+        m_value.clear();
+        m_pattern.clear();
+        m_glob = false;
+        m_exists = false;
+    }
+
+    /**
+     * Returns whether a tilde at the current position starts a tilde prefix:
+     * at the start of a field, after the '=' of an assignment in the first
+     * field or after a ':' in such an assignment
+     *
+     * \returns True    If a tilde at the current position is expanded
+     *          False   Otherwise
+     */
+    [[nodiscard]] auto allowsTilde() const noexcept -> bool {
+        if(!m_exists) {
+            return true;
+        }
+        if(!m_fields.empty() || m_value.empty()) {
+            return false;
+        }
+        return m_value.back() == '=' ||
+               (m_value.back() == ':' && m_value.find('=') != string::npos);
+    }
+
+    /**
+     * Returns the finished fields
+     *
+     * \returns The finished fields
+     */
+    auto get() noexcept -> TaskCollection& { return m_fields; }
+
+  private:
+    string_view m_ifs;
+    string m_value;
+    string m_pattern;
+    bool m_glob{false};
+    bool m_exists{false};
+    TaskCollection m_fields;
+};
+
+/**
+ * \brief Expands a single word
+ */
+class Expander {
+  public:
+    Expander(string_view word, const EnvironmentCollection& env)
+        : m_word(word), m_env(env), m_fields(getIfs(env)) {}
+
+    auto expand() -> TaskCollection {
+        while(m_pos < m_word.size()) {
+            const char c = m_word[m_pos];
+            switch(c) {
+            case '\'':
+                expandSingleQuoted();
+                break;
+            case '"':
+                expandDoubleQuoted();
+                break;
+            case '\\':
+                expandEscaped();
+                break;
+            case '$':
+                expandDollar(false);
+                break;
+            case '`':
+                skipBackquoted();
+                break;
+            case '~':
+                if(!m_fields.allowsTilde() || !expandTilde()) {
+                    m_fields.appendUnquoted(c);
+                    ++m_pos;
+                }
+                break;
+            case '#':
+                m_comments.push_back(m_pos);
+                m_fields.appendUnquoted(c);
+                ++m_pos;
+                break;
+            case ' ':
+            case '\t':
+                m_fields.finish();
+                ++m_pos;
+                break;
+            default:
+                if(contains(BAD_CHARACTERS, c)) {
+                    throw WordExpansionError(
+                        string("Bad character in shell argument '")
+                            .append(m_word)
+                            .append("': Illegal occurrence of newline or one "
+                                    "of |, &, ;, <, >, (, ), {, }."));
+                }
+                m_fields.appendUnquoted(c);
+                ++m_pos;
+                break;
+            }
+        }
+
+        if(m_needsShell) {
+            return expandInShell(getShellWord(), m_env);
+        }
+        m_fields.finish();
+        return std::move(m_fields.get());
+    }
+
+  private:
+    static auto getIfs(const EnvironmentCollection& env) noexcept
+        -> string_view {
+        auto ifs = env.find("IFS");
+        if(ifs == env.end()) {
+            return DEFAULT_IFS;
+        }
+        return ifs->second;
+    }
+
+    /**
+     * Returns the word to pass to the shell. An unquoted '#' at the start of
+     * a shell word starts a comment, while it is taken literally here.
+     */
+    [[nodiscard]] auto getShellWord() const -> string {
+        string shellWord;
+        size_t begin = 0U;
+        for(const auto comment : m_comments) {
+            shellWord.append(m_word.substr(begin, comment - begin))
+                .push_back('\\');
+            begin = comment;
+        }
+        return shellWord.append(m_word.substr(begin));
+    }
+
+    /**
+     * Expands the tilde prefix at the current position
+     *
+     * \returns True    If the tilde prefix was expanded
+     *          False   If the tilde must be taken literally
+     */
+    auto expandTilde() -> bool {
+        auto end = m_word.find_first_of(TILDE_PREFIX_END, m_pos + 1U);
+        if(end == string_view::npos) {
+            end = m_word.size();
+        }
+        auto user = m_word.substr(m_pos + 1U, end - m_pos - 1U);
+        for(const auto c : user) {
+            if(!isNameCharacter(c) && c != '.' && c != '-') {
+                return false; // Not a login name
+            }
+        }
+
+        auto home = getUserHome(string(user), m_env);
+        if(!home) {
+            return false;
+        }
+        m_fields.appendQuoted(*home);
+        m_pos = end;
+        return true;
+    }
+
+    void expandSingleQuoted() {
+        auto end = m_word.find('\'', m_pos + 1U);
+        if(end == string_view::npos) {
+            throw syntaxError(m_word, "unterminated single quote");
+        }
+        m_fields.appendQuoted(m_word.substr(m_pos + 1U, end - m_pos - 1U));
+        m_pos = end + 1U;
+    }
+
+    void expandDoubleQuoted() {
+        m_fields.appendQuoted(""); // Even empty quotes result in a field
+        ++m_pos;
+        while(m_pos < m_word.size() && m_word[m_pos] != '"') {
+            const char c = m_word[m_pos];
+            if(c == '\\' && m_pos + 1U < m_word.size() &&
+               contains(DOUBLE_QUOTE_ESCAPES, m_word[m_pos + 1U])) {
+                m_fields.appendQuoted(m_word.substr(m_pos + 1U, 1U));
+                m_pos += 2U;
+            } else if(c == '$') {
+                expandDollar(true);
+            } else if(c == '`') {
+                skipBackquoted();
+            } else {
+                m_fields.appendQuoted(m_word.substr(m_pos, 1U));
+                ++m_pos;
+            }
+        }
+        if(m_pos >= m_word.size()) {
+            throw syntaxError(m_word, "unterminated double quote");
+        }
+        ++m_pos;
+    }
+
+    void expandEscaped() {
+        if(m_pos + 1U >= m_word.size()) {
+            throw syntaxError(m_word, "trailing backslash");
+        }
+        m_fields.appendQuoted(m_word.substr(m_pos + 1U, 1U));
+        m_pos += 2U;
+    }
+
+    void expandDollar(bool quoted) {
+        const auto next = m_pos + 1U;
+        const char c = next < m_word.size() ? m_word[next] : '\0';
+        if(c == '(') {
+            m_needsShell = true;
+            m_pos = skipEnclosed(next, '(', ')');
+        } else if(c == '{') {
+            auto end = next + 1U;
+            while(end < m_word.size() && isNameCharacter(m_word[end])) {
+                ++end;
+            }
+            if(end < m_word.size() && m_word[end] == '}' && end > next + 1U &&
+               isNameStart(m_word[next + 1U])) {
+                appendValue(lookup(m_word.substr(next + 1U, end - next - 1U)),
+                            quoted);
+                m_pos = end + 1U;
+            } else {
+                requireDefined(next + 1U);
+                m_needsShell = true;
+                m_pos = skipEnclosed(next, '{', '}');
+            }
+        } else if(isNameStart(c)) {
+            auto end = next;
+            while(end < m_word.size() && isNameCharacter(m_word[end])) {
+                ++end;
+            }
+            appendValue(lookup(m_word.substr(next, end - next)), quoted);
+            m_pos = end;
+        } else if(c != '\0' && (std::isdigit(static_cast<unsigned char>(c)) !=
+                                    0 ||
+                                contains(SPECIAL_PARAMETERS, c))) {
+            m_needsShell = true;
+            m_pos = next + 1U;
+        } else {
+            // A lone dollar sign is taken literally
+            m_fields.appendUnquoted('$');
+            ++m_pos;
+        }
+    }
+
+    void skipBackquoted() {
+        m_needsShell = true;
+        for(auto i = m_pos + 1U; i < m_word.size(); ++i) {
+            if(m_word[i] == '\\') {
+                ++i;
+            } else if(m_word[i] == '`') {
+                m_pos = i + 1U;
+                return;
+            }
+        }
+        throw syntaxError(m_word, "unterminated command substitution");
+    }
+
+    /**
+     * Returns the position just after the closing character that matches the
+     * opening character at the given position
+     */
+    [[nodiscard]] auto skipEnclosed(size_t open, char opening,
+                                    char closing) const -> size_t {
+        size_t depth = 0U;
+        for(auto i = open; i < m_word.size(); ++i) {
+            const char c = m_word[i];
+            if(c == '\\') {
+                ++i;
+            } else if(c == '\'') {
+                i = m_word.find('\'', i + 1U);
+                if(i == string_view::npos) {
+                    break;
+                }
+            } else if(c == opening) {
+                ++depth;
+            } else if(c == closing && --depth == 0U) {
+                return i + 1U;
+            }
+        }
+        throw syntaxError(m_word, "unterminated substitution");
+    }
+
+    /**
+     * Requires the variable named at the given position, optionally preceded
+     * by a '#', to be defined. The shell would substitute a default value or
+     * the length of an undefined variable.
+     */
+    void requireDefined(size_t begin) const {
+        if(begin < m_word.size() && m_word[begin] == '#') {
+            ++begin;
+        }
+        auto end = begin;
+        while(end < m_word.size() && isNameCharacter(m_word[end])) {
+            ++end;
+        }
+        if(end > begin && isNameStart(m_word[begin])) {
+            static_cast<void>(lookup(m_word.substr(begin, end - begin)));
+        }
+    }
+
+    [[nodiscard]] auto lookup(string_view name) const -> const string& {
+        auto value = m_env.find(string(name));
+        if(value == m_env.end()) {
+            throw WordExpansionError(
+                string("Command contains undefined variable '")
+                    .append(name)
+                    .append("'"));
+        }
+        return value->second;
+    }
+
+    void appendValue(string_view value, bool quoted) {
+        if(quoted) {
+            m_fields.appendQuoted(value);
+        } else {
+            m_fields.appendExpansion(value);
+        }
+    }
+
+    string_view m_word;
+    const EnvironmentCollection& m_env;
+    Fields m_fields;
+    size_t m_pos{0U};
+    bool m_needsShell{false};
+    vector<size_t> m_comments;
+};
+} // namespace
+
+namespace execHelper::core {
+void expandWord(string_view word, const EnvironmentCollection& env,
+                TaskCollection* expanded) {
+    if(!word.empty() &&
+       word.find_first_of(SPECIAL_CHARACTERS) == string_view::npos) {
+        expanded->emplace_back(word);
+        return;
+    }
+
+    auto fields = Expander(word, env).expand();
+    expanded->insert(expanded->end(), std::make_move_iterator(fields.begin()),
+                     std::make_move_iterator(fields.end()));
+}
+} // namespace execHelper::core
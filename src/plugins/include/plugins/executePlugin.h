@@ -51,10 +51,36 @@ auto getPluginNames(const Plugins& plugins) noexcept
     -> core::Tasks;
 } // namespace detail
 
+/**
+ * Resolves the given commands into the tasks to execute
+ *
+ * \param[in] commands  The commands to resolve
+ * \param[in] task      The task to start resolving from
+ * \param[in] context   The context to resolve the commands in
+ * \returns The resolved tasks. If the context has a sink, every resolved task
+ * is handed over to the sink as soon as it is resolved and the returned
+ * collection is empty.
+ */
 [[nodiscard]] auto executeCommands(const config::CommandCollection& commands,
                                    const core::Task& task,
                                    const ExecutionContext& context)
     -> core::Tasks;
+
+/**
+ * Resolves the given targets for every combination of the patterns of the
+ * given task. The patterns are replaced in both the targets and the task.
+ * Targets that fail to resolve are reported and skipped.
+ *
+ * \param[in] task      The task to start resolving from
+ * \param[in] targets   The targets to resolve. May contain patterns.
+ * \param[in] context   The context to resolve the targets in
+ * \returns The resolved tasks. If the context has a sink, every resolved task
+ * is handed over to the sink as soon as it is resolved and the returned
+ * collection is empty.
+ */
+[[nodiscard]] auto runTargets(const core::Task& task,
+                              const config::CommandCollection& targets,
+                              const ExecutionContext& context) -> core::Tasks;
 } // namespace execHelper::plugins
 
 #endif /* __EXECUTE_PLUGIN_H__ */
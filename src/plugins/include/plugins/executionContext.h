@@ -3,6 +3,7 @@
 
 #include <map>
 #include <memory>
+#include <utility>
 
 #include "plugin.h"
 
@@ -27,17 +28,20 @@ class ExecutionContext {
      * \param[in] settings  The settings to use
      * \param[in] patterns  The patterns to use
      * \param[in] plugins   The plugins to use
+     * \param[in] sink      The sink to hand over every resolved task to as
+     * soon as it is resolved. If empty, resolved tasks are returned instead.
      *
      * \note The caller is responsible for making sure the lifetime of the given objects extend the lifetime of this object
      */
     ExecutionContext(const config::FleetingOptionsInterface& options,
                      const config::SettingsNode& settings,
                      const config::PatternsHandler& patterns,
-                     const Plugins& plugins)
+                     const Plugins& plugins, TaskSink sink = TaskSink())
         : m_options(options),
           m_settings(settings),
           m_patterns(patterns),
-          m_plugins(plugins) {
+          m_plugins(plugins),
+          m_sink(std::move(sink)) {
         ;
     }
 
@@ -80,11 +84,24 @@ class ExecutionContext {
         return m_plugins;
     }
 
+    /**
+     * Get the sink for resolved tasks of this context. Plugins hand every task
+     * they register over to the sink as soon as it is registered, so it can be
+     * executed while the other tasks are still being resolved.
+     *
+     * \returns The sink for this context. Empty if resolved tasks must be
+     * returned to the caller instead.
+     */
+    [[nodiscard]] inline auto sink() const noexcept -> const TaskSink& {
+        return m_sink;
+    }
+
   private:
     const config::FleetingOptionsInterface& m_options;
     const config::SettingsNode& m_settings;
     const config::PatternsHandler& m_patterns;
     const Plugins& m_plugins;
+    TaskSink m_sink;
 };
 } // namespace execHelper::plugins
 
@@ -2,6 +2,7 @@
 #define LUA_PLUGIN_INCLUDE
 
 #include <filesystem>
+#include <optional>
 #include <string_view>
 
 #include "core/task.h"
@@ -14,10 +15,38 @@ using VariablesMap = SettingsNode;
 namespace execHelper::plugins {
 class ExecutionContext;
 
+/**
+ * Runs the given lua script for the given task. The script is compiled once
+ * per run and, if a chunk cache file is given, once for as long as the script
+ * does not change.
+ *
+ * \param[in] task  The task to pass to the script
+ * \param[in] config    The configuration of the plugin
+ * \param[in] context   The context of the invocation
+ * \param[in] script    The lua script to run
+ * \param[in] chunkCacheFile    The file to cache the compiled script in
+ * \returns The tasks registered by the script
+ * \throws std::runtime_error   If the script could not be compiled or failed
+ */
 [[nodiscard]] auto
 luaPlugin(core::Task task, const config::VariablesMap& config,
-          const ExecutionContext& context, const std::filesystem::path& script)
-    -> core::Tasks;
+          const ExecutionContext& context, const std::filesystem::path& script,
+          const std::optional<std::filesystem::path>& chunkCacheFile =
+              std::nullopt) -> core::Tasks;
+
+/**
+ * Returns the file in the given cache directory in which the compiled chunk
+ * of the given lua script is cached
+ *
+ * \param[in] script    The lua script
+ * \param[in] cacheDirectory    The directory to store the cache file in
+ * \returns The chunk cache file of the script
+ *          std::nullopt if the path of the script can not be resolved
+ */
+[[nodiscard]] auto
+getLuaChunkCacheFile(const std::filesystem::path& script,
+                     const std::filesystem::path& cacheDirectory) noexcept
+    -> std::optional<std::filesystem::path>;
 
 [[nodiscard]] inline auto
 luaPluginSummary(const std::filesystem::path& script) noexcept {
@@ -0,0 +1,24 @@
+#ifndef NATIVE_PLUGINS_INCLUDE
+#define NATIVE_PLUGINS_INCLUDE
+
+#include <string>
+#include <string_view>
+
+#include "plugin.h"
+
+namespace execHelper::plugins {
+/**
+ * Returns the plugins that are implemented natively. They behave like the lua
+ * plugins with the same name that are shipped with exec-helper, without the
+ * cost of running a lua script.
+ *
+ * \returns A mapping of the native plugins
+ */
+[[nodiscard]] auto getNativePlugins() noexcept -> const Plugins&;
+
+[[nodiscard]] inline auto nativePluginSummary(std::string_view name) noexcept {
+    return "Native plugin for module " + std::string(name);
+}
+} // namespace execHelper::plugins
+
+#endif /* NATIVE_PLUGINS_INCLUDE */
@@ -14,6 +14,7 @@ using ApplyFunction = std::function<core::Tasks(
     core::Task task, const config::VariablesMap& variables,
     const ExecutionContext& context)>;
 using SummaryFunction = std::function<std::string()>;
+using TaskSink = std::function<void(core::Task task)>;
 
 using Plugins = std::map<std::string, ApplyFunction>;
 using PluginSummaries = std::map<std::string, std::string>;
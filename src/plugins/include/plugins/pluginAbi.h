@@ -0,0 +1,139 @@
+#ifndef PLUGIN_ABI_INCLUDE
+#define PLUGIN_ABI_INCLUDE
+
+/*
+ * The binary interface between exec-helper and plugins implemented by a shared
+ * library. This header only uses C, so plugins can be written in any language
+ * that can export C functions and do not depend on the compiler or standard
+ * library exec-helper is built with.
+ *
+ * A plugin library exports the EXEC_HELPER_PLUGIN_ENTRY_POINT function, which
+ * describes the plugin. The plugin is registered under the file name of the
+ * library without its extension. Its summary is read from the first line of
+ * the file next to the library with the same name and the .summary extension
+ * instead, so listing the plugins does not load any library. Strings are
+ * zero-terminated and UTF-8 encoded. Strings and arrays passed to a plugin are
+ * only valid during the invocation they are passed to.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** The version of the interface described by this header */
+#define EXEC_HELPER_PLUGIN_ABI_VERSION 1U
+
+/** The name of the function every plugin library must export */
+#define EXEC_HELPER_PLUGIN_ENTRY_POINT "exec_helper_get_plugin"
+
+/** The task that is passed to the plugin */
+#define EXEC_HELPER_PLUGIN_TASK ((exec_helper_task)0U)
+
+/** Returned instead of a task by functions that fail */
+#define EXEC_HELPER_INVALID_TASK ((exec_helper_task)-1)
+
+/**
+ * \brief An invocation of a plugin. Opaque to the plugin.
+ */
+typedef struct exec_helper_invocation exec_helper_invocation;
+
+/**
+ * \brief Refers to a task of an invocation
+ */
+typedef size_t exec_helper_task;
+
+/**
+ * \brief The functions exec-helper offers to a plugin
+ *
+ * Unless mentioned otherwise, the functions return zero on success and
+ * non-zero on failure.
+ */
+typedef struct exec_helper_host {
+    /** The version of the interface of exec-helper */
+    uint32_t abi_version;
+
+    /**
+     * Returns the values of the given key in the configuration of the plugin.
+     * The key is a path of the given depth into the configuration. Returns
+     * NULL if the key does not exist and sets count to the number of values
+     * otherwise.
+     */
+    const char* const* (*get_values)(exec_helper_invocation* invocation,
+                                     const char* const* key, size_t depth,
+                                     size_t* count);
+
+    /** Returns non-zero if the plugin must be verbose */
+    int (*verbose)(exec_helper_invocation* invocation);
+
+    /** Returns the number of jobs the plugin must use */
+    uint32_t (*jobs)(exec_helper_invocation* invocation);
+
+    /**
+     * Returns a copy of the given task, or EXEC_HELPER_INVALID_TASK if it
+     * does not exist
+     */
+    exec_helper_task (*copy_task)(exec_helper_invocation* invocation,
+                                  exec_helper_task task);
+
+    /** Appends the given argument to the given task */
+    int (*append)(exec_helper_invocation* invocation, exec_helper_task task,
+                  const char* argument);
+
+    /** Sets the given environment variable of the given task */
+    int (*set_environment)(exec_helper_invocation* invocation,
+                           exec_helper_task task, const char* name,
+                           const char* value);
+
+    /** Sets the working directory of the given task */
+    int (*set_working_directory)(exec_helper_invocation* invocation,
+                                 exec_helper_task task,
+                                 const char* directory);
+
+    /** Registers the given task as a task to execute */
+    int (*register_task)(exec_helper_invocation* invocation,
+                         exec_helper_task task);
+
+    /**
+     * Resolves the given targets for every combination of the patterns of the
+     * given task and registers the resolved tasks, like run_target() in a lua
+     * plugin
+     */
+    int (*run_targets)(exec_helper_invocation* invocation,
+                       exec_helper_task task, const char* const* targets,
+                       size_t count);
+
+    /** Reports why the invocation fails */
+    void (*error)(exec_helper_invocation* invocation, const char* message);
+} exec_helper_host;
+
+/**
+ * \brief Describes a plugin
+ */
+typedef struct exec_helper_plugin {
+    /** The version of the interface the plugin is built against */
+    uint32_t abi_version;
+
+    /**
+     * Applies the plugin. The configured working directory and environment
+     * are already applied to EXEC_HELPER_PLUGIN_TASK. Returns zero on success
+     * and non-zero on failure.
+     */
+    int (*apply)(const exec_helper_host* host,
+                 exec_helper_invocation* invocation);
+} exec_helper_plugin;
+
+/**
+ * \brief The signature of EXEC_HELPER_PLUGIN_ENTRY_POINT. Returns the
+ * description of the plugin, which must stay valid while the library is
+ * loaded, or NULL if the plugin can not be used.
+ */
+typedef const exec_helper_plugin* (*exec_helper_plugin_entry_point)(void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* PLUGIN_ABI_INCLUDE */
@@ -0,0 +1,106 @@
+#ifndef PLUGIN_INDEX_INCLUDE
+#define PLUGIN_INDEX_INCLUDE
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "config/path.h"
+
+namespace execHelper::plugins {
+/**
+ * \brief A plugin found in a plugin search directory
+ */
+struct PluginIndexEntry {
+    std::string name;    //!< brief The name the plugin is registered under
+    config::Path path;   //!< brief The file that implements the plugin
+    std::string summary; //!< brief The summary of the plugin
+    int64_t modified{0}; //!< brief The modification time of the files the
+                         //!< entry is derived from
+
+    auto operator==(const PluginIndexEntry& other) const noexcept
+        -> bool = default;
+};
+
+using PluginIndex = std::vector<PluginIndexEntry>;
+
+/**
+ * Lists the lua plugins and the shared library plugins in the given
+ * directory. The shared libraries are not loaded, so libraries that do not
+ * implement a compatible plugin are listed as well: they fail when they are
+ * applied. The directory is not searched recursively.
+ *
+ * \param[in] directory The directory to search
+ * \returns The plugins in the directory, ordered by name
+ * \throws std::filesystem::filesystem_error    If the directory can not be
+ * listed
+ */
+[[nodiscard]] auto scanPluginDirectory(const config::Path& directory)
+    -> PluginIndex;
+
+/**
+ * Returns the file in the given cache directory in which the plugin index of
+ * the given search directory is stored
+ *
+ * \param[in] directory The plugin search directory
+ * \param[in] cacheDirectory    The directory to store the index in
+ * \returns The plugin index file of the directory
+ *          std::nullopt if the path of the directory can not be resolved
+ */
+[[nodiscard]] auto
+getPluginIndexFile(const config::Path& directory,
+                   const config::Path& cacheDirectory) noexcept
+    -> std::optional<config::Path>;
+
+/**
+ * Reads the plugin index of the given directory. The index is only used if
+ * the modification times of the directory and of the indexed plugins did not
+ * change since it was written by the same version of the binary, so the
+ * directory does not need to be listed.
+ *
+ * \param[in] indexFile The plugin index file to read
+ * \param[in] directory The plugin search directory the index must belong to
+ * \param[in] version   The version of the binary that reads the index
+ * \returns The plugins in the directory
+ *          std::nullopt if the index does not exist, is stale, is corrupt or
+ *          was written by another version
+ */
+[[nodiscard]] auto readPluginIndex(const config::Path& indexFile,
+                                   const config::Path& directory,
+                                   std::string_view version) noexcept
+    -> std::optional<PluginIndex>;
+
+/**
+ * Writes the plugin index of the given directory. The file is replaced
+ * atomically.
+ *
+ * \param[in] indexFile The plugin index file to write
+ * \param[in] directory The plugin search directory the index belongs to
+ * \param[in] index The plugins in the directory
+ * \param[in] version   The version of the binary that writes the index
+ * \returns True    If the index was written
+ *          False   Otherwise
+ */
+auto writePluginIndex(const config::Path& indexFile,
+                      const config::Path& directory, const PluginIndex& index,
+                      std::string_view version) noexcept -> bool;
+
+/**
+ * Returns the plugins in the given directory, using and updating its plugin
+ * index in the given cache directory if one is given
+ *
+ * \param[in] directory The directory to search
+ * \param[in] cacheDirectory    The directory the plugin indices are stored in
+ * \param[in] version   The version of the binary that uses the plugin indices
+ * \returns The plugins in the directory, ordered by name
+ * \throws std::filesystem::filesystem_error    If the directory can not be
+ * listed
+ */
+[[nodiscard]] auto getPlugins(const config::Path& directory,
+                              const std::optional<config::Path>& cacheDirectory,
+                              std::string_view version) -> PluginIndex;
+} // namespace execHelper::plugins
+
+#endif /* PLUGIN_INDEX_INCLUDE */
@@ -1,21 +1,152 @@
 #ifndef __PLUGIN_UTILS_H__
 #define __PLUGIN_UTILS_H__
 
+#include <cstddef>
+#include <optional>
 #include <ostream>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "config/commandLineOptions.h"
 #include "config/path.h"
 #include "config/pattern.h"
 #include "config/variablesMap.h"
-#include "core/mapPermutator.h"
+#include "core/permutations.h"
 #include "core/task.h"
 
 #include "plugin.h"
 
 namespace execHelper::plugins {
-using PatternPermutator =
-    core::MapPermutator<config::PatternKey, config::PatternValue>;
+/**
+ * \brief All combinations of the values of a set of patterns
+ *
+ * The patterns are ordered by their key. The combinations are numbered such
+ * that the values of the last pattern change fastest and any combination can
+ * be retrieved directly by its number.
+ */
+class PatternPermutator {
+  public:
+    using Index = core::Permutations::Index; //!< brief The number of a combination
+    using Range = core::Permutations::Range; //!< brief A half-open range of combinations
+
+    /**
+     * \brief Iterates over the combinations of a permutator
+     */
+    class Iterator {
+      public:
+        /**
+         * Create an iterator
+         *
+         * \param[in] permutator    The permutator to iterate over
+         * \param[in] index The number of the combination to point to
+         */
+        Iterator(const PatternPermutator& permutator, Index index) noexcept
+            : m_permutator(&permutator), m_index(index) {}
+
+        /**
+         * Advance to the next combination
+         *
+         * \returns This iterator
+         */
+        auto operator++() noexcept -> Iterator& {
+            ++m_index;
+            return *this;
+        }
+
+        /**
+         * Equality operator
+         *
+         * \param[in] other The other object to compare with
+         * \returns True    If both iterators point to the same combination of the same permutator
+         *          False   Otherwise
+         */
+        auto operator==(const Iterator& other) const noexcept -> bool {
+            return m_index == other.m_index &&
+                   m_permutator == other.m_permutator;
+        }
+
+        /**
+         * Inequality operator
+         *
+         * \param[in] other The other object to compare with
+         * \returns !operator==(other)
+         */
+        auto operator!=(const Iterator& other) const noexcept -> bool {
+            return !(*this == other);
+        }
+
+        /**
+         * Dereference operator
+         *
+         * \returns The combination the iterator points to
+         */
+        auto operator*() const -> config::PatternCombinations {
+            return m_permutator->combination(m_index);
+        }
+
+      private:
+        const PatternPermutator* m_permutator;
+        Index m_index;
+    };
+
+    using iterator = Iterator;       //!< brief iterator type
+    using const_iterator = Iterator; //!< brief const iterator type
+
+    /**
+     * Create the combinations of the given patterns. If multiple patterns have
+     * the same key, the first one is used.
+     *
+     * \param[in] patterns  The patterns
+     * \throws std::overflow_error  There are too many combinations
+     */
+    explicit PatternPermutator(const config::Patterns& patterns);
+
+    /**
+     * Returns the number of combinations
+     *
+     * \returns The number of combinations. A permutator without patterns has
+     * one empty combination.
+     */
+    [[nodiscard]] auto size() const noexcept -> Index;
+
+    /**
+     * Returns the combination with the given number
+     *
+     * \param[in] index The number of the combination. Must be less than \ref size().
+     * \returns The value of every pattern in the combination
+     */
+    [[nodiscard]] auto combination(Index index) const
+        -> config::PatternCombinations;
+
+    /**
+     * Split the combinations into contiguous ranges of (almost) equal size
+     *
+     * \param[in] nbOfRanges    The number of ranges. Must be larger than zero.
+     * \returns The ranges, in order
+     */
+    [[nodiscard]] auto split(std::size_t nbOfRanges) const
+        -> std::vector<Range>;
+
+    /**
+     * Return iterator to beginning
+     *
+     * \returns A begin iterator
+     */
+    [[nodiscard]] auto begin() const noexcept -> const_iterator;
+
+    /**
+     * Return iterator to end
+     *
+     * \returns An end iterator
+     */
+    [[nodiscard]] auto end() const noexcept -> const_iterator;
+
+  private:
+    config::PatternKeys m_keys;
+    std::vector<config::PatternValues> m_values;
+    core::Permutations m_permutations;
+};
 
 const config::PatternKey& getPatternsKey() noexcept;
 const std::string& getWorkingDirKey() noexcept;
@@ -23,8 +154,7 @@ const std::string& getWorkingDirKey() noexcept;
 config::EnvironmentCollection
 getEnvironment(const config::VariablesMap& variables) noexcept;
 
-PatternPermutator
-makePatternPermutator(const config::Patterns& patterns) noexcept;
+PatternPermutator makePatternPermutator(const config::Patterns& patterns);
 
 config::EnvironmentCollection replacePatternsInEnvironment(
     const config::EnvironmentCollection& env,
@@ -40,9 +170,14 @@ auto replacePatternCombinations(
     -> std::string;
 auto toString(const config::PatternKeys& values) noexcept -> std::string;
 
-auto discoverPlugins(const config::Paths& searchPaths) noexcept -> Plugins;
-auto discoverPluginSummaries(const config::Paths& searchPaths) noexcept
-    -> PluginSummaries;
+auto discoverPlugins(
+    const config::Paths& searchPaths,
+    const std::optional<config::Path>& cacheDirectory = std::nullopt,
+    std::string_view version = std::string_view()) noexcept -> Plugins;
+auto discoverPluginSummaries(
+    const config::Paths& searchPaths,
+    const std::optional<config::Path>& cacheDirectory = std::nullopt,
+    std::string_view version = std::string_view()) noexcept -> PluginSummaries;
 } // namespace execHelper::plugins
 
 #endif /* __PLUGIN_UTILS_H__ */
@@ -0,0 +1,86 @@
+#ifndef SHARED_LIBRARY_PLUGIN_INCLUDE
+#define SHARED_LIBRARY_PLUGIN_INCLUDE
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "core/task.h"
+
+#include "pluginAbi.h"
+
+namespace execHelper::config {
+class SettingsNode;
+using VariablesMap = SettingsNode;
+} // namespace execHelper::config
+
+namespace execHelper::plugins {
+class ExecutionContext;
+
+/**
+ * The extension of the shared libraries that are discovered as plugins
+ */
+#if defined(_WIN32)
+constexpr std::string_view SHARED_LIBRARY_PLUGIN_EXTENSION = ".dll";
+#elif defined(__APPLE__)
+constexpr std::string_view SHARED_LIBRARY_PLUGIN_EXTENSION = ".dylib";
+#else
+constexpr std::string_view SHARED_LIBRARY_PLUGIN_EXTENSION = ".so";
+#endif
+
+/**
+ * The extension of the file next to a shared library plugin that contains its
+ * summary
+ */
+constexpr std::string_view SHARED_LIBRARY_PLUGIN_SUMMARY_EXTENSION =
+    ".summary";
+
+/**
+ * A plugin loaded from a shared library. The library stays loaded for as
+ * long as the plugin is referenced.
+ */
+using SharedLibraryPlugin = std::shared_ptr<const exec_helper_plugin>;
+
+/**
+ * Loads the plugin implemented by the given shared library
+ *
+ * \param[in] library   The shared library to load
+ * \returns The plugin
+ * \throws std::runtime_error   If the library can not be loaded or does not
+ * implement a compatible plugin
+ */
+[[nodiscard]] auto loadSharedLibraryPlugin(const std::filesystem::path& library)
+    -> SharedLibraryPlugin;
+
+/**
+ * Returns the summary of the plugin implemented by the given shared library.
+ * It is read from the summary file next to the library: the library itself is
+ * not loaded.
+ *
+ * \param[in] library   The shared library
+ * \returns The first line of the summary file of the library
+ *          A generic summary if there is no summary file
+ */
+[[nodiscard]] auto
+sharedLibraryPluginSummary(const std::filesystem::path& library) noexcept
+    -> std::string;
+
+/**
+ * Applies the given plugin to the given task
+ *
+ * \param[in] plugin    The plugin to apply
+ * \param[in] task  The task to pass to the plugin
+ * \param[in] config    The configuration of the plugin
+ * \param[in] context   The context of the invocation
+ * \returns The tasks registered by the plugin
+ * \throws std::runtime_error   If the plugin fails
+ */
+[[nodiscard]] auto applySharedLibraryPlugin(const exec_helper_plugin& plugin,
+                                            core::Task task,
+                                            const config::VariablesMap& config,
+                                            const ExecutionContext& context)
+    -> core::Tasks;
+} // namespace execHelper::plugins
+
+#endif /* SHARED_LIBRARY_PLUGIN_INCLUDE */
@@ -20,7 +20,6 @@ using std::move;
 using std::string;
 
 using execHelper::config::Path;
-using execHelper::config::SettingsKeys;
 using execHelper::config::SettingsValues;
 using execHelper::config::VariablesMap;
 using execHelper::core::Task;
@@ -49,20 +48,17 @@ commandLineCommand(Task task, const VariablesMap& variables,
 
     Tasks tasks;
     if(variables
-           .get<SettingsValues>(
-               SettingsKeys({string(COMMAND_LINE_KEY), commandLine->front()}),
-               SettingsValues())
+           .get<SettingsValues>({COMMAND_LINE_KEY, commandLine->front()},
+                                SettingsValues())
            .empty()) {
         task.append(move(*commandLine));
         tasks.emplace_back(move(task));
     } else {
-        SettingsKeys keys({string(COMMAND_LINE_KEY)});
         for(const auto& commandKey : variables.get<SettingsValues>(
-                string(COMMAND_LINE_KEY), SettingsValues())) {
-            SettingsKeys tmpKey = keys;
-            tmpKey.emplace_back(commandKey);
+                COMMAND_LINE_KEY, SettingsValues())) {
             Task newTask = task;
-            newTask.append(move(*(variables.get<CommandLineArgs>(tmpKey))));
+            newTask.append(move(*(variables.get<CommandLineArgs>(
+                {COMMAND_LINE_KEY, commandKey}))));
             tasks.emplace_back(newTask);
         }
     }
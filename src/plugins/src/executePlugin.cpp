@@ -2,7 +2,6 @@
 
 #include <algorithm>
 #include <memory>
-#include <numeric>
 #include <utility>
 
 #include <stdexcept>
@@ -16,6 +15,7 @@
 #include "executionContext.h"
 #include "logger.h"
 #include "plugin.h"
+#include "pluginUtils.h"
 
 using namespace std;
 
@@ -25,7 +25,7 @@ using execHelper::config::PatternKeys;
 using execHelper::config::Patterns;
 using execHelper::config::PatternsHandler;
 using execHelper::config::SettingsKey;
-using execHelper::config::SettingsKeys;
+using execHelper::config::SettingsKeysView;
 using execHelper::config::SettingsNode;
 using execHelper::config::SettingsValues;
 using execHelper::config::VariablesMap;
@@ -39,7 +39,7 @@ constexpr auto patternsKey = "patterns"sv;
 
 auto getNextPatterns(const VariablesMap& variables,
                      const PatternsHandler& patterns) -> Patterns {
-    auto newPatternKeys = variables.get<PatternKeys>(string(patternsKey), {});
+    auto newPatternKeys = variables.get<PatternKeys>(patternsKey, {});
     Patterns newPatterns;
     for(const auto& key : newPatternKeys) {
         if(!patterns.contains(key)) {
@@ -97,29 +97,35 @@ auto getNextStep(const Command& currentCommand, const SettingsNode& settings,
 }
 
 inline void index(VariablesMap* variables, const SettingsNode& settings,
-                  const SettingsKeys& key) noexcept {
+                  SettingsKeysView key) noexcept {
     if(!settings.contains(key)) {
         return;
     }
 
-    expects(!key.empty());
-    if(!variables->replace(key.back(), *(settings.get<SettingsValues>(key)))) {
-        LOG(error) << "Failed to replace key '" << key.back() << "'";
+    expects(key.size() > 0U);
+    const SettingsKey lastKey(*prev(key.end()));
+    if(!variables->replace(lastKey, *(settings.get<SettingsValues>(key)))) {
+        LOG(error) << "Failed to replace key '" << lastKey << "'";
     }
 
     // Get current depth to the level of the given key
-    const SettingsNode& currentDepth = accumulate(
-        key.begin(), key.end(), static_cast<const SettingsNode&>(settings),
-        [](const auto& node, const auto& subkey) { return node[subkey]; });
+    const SettingsNode* currentDepth = &settings;
+    for(const auto& subkey : key) {
+        currentDepth = &(*currentDepth)[subkey];
+    }
 
-    for(const auto& depthKey :
-        currentDepth.get<SettingsValues>(SettingsKeys(), SettingsValues())) {
-        (*variables)[depthKey] = currentDepth[depthKey];
+    const auto depthKeys = currentDepth->values();
+    if(!depthKeys) {
+        return;
+    }
+    for(const auto& depthKey : *depthKeys) {
+        variables->child(depthKey) =
+            (*currentDepth)[depthKey]; // Shares the subtree with the settings
     }
 }
 
 inline auto getVariablesMap(VariablesMap* variables,
-                            const vector<SettingsKeys>& keys,
+                            std::initializer_list<SettingsKeysView> keys,
                             const SettingsNode& rootSettings) noexcept -> bool {
     for(const auto& key : keys) {
         if(rootSettings.contains(key)) {
@@ -129,6 +135,22 @@ inline auto getVariablesMap(VariablesMap* variables,
     return true;
 }
 
+/**
+ * Hands the given tasks over to the sink of the context, if it has one
+ *
+ * \returns The tasks that still need to be returned to the caller
+ */
+inline auto forwardToSink(Tasks tasks, const ExecutionContext& context)
+    -> Tasks {
+    const auto& sink = context.sink();
+    if(!sink) {
+        return tasks;
+    }
+    for(auto& task : tasks) {
+        sink(move(task));
+    }
+    return {};
+}
 } // namespace
 
 namespace execHelper::plugins::detail {
@@ -139,13 +161,14 @@ auto executeCommands(const config::Command& initialCommand,
     auto applyFunction =
         getNextStep(command, context.settings(), context.plugins());
     VariablesMap newVariablesMap(command);
-    const vector<SettingsKeys> keys = {{command}, {command, initialCommand}};
-    getVariablesMap(&newVariablesMap, keys, context.settings());
+    getVariablesMap(&newVariablesMap, {{command}, {command, initialCommand}},
+                    context.settings());
 
     Task preparedTask = task;
     auto newPatterns = getNextPatterns(newVariablesMap, context.patterns());
     preparedTask.addPatterns(newPatterns);
-    return applyFunction(preparedTask, newVariablesMap, context);
+    return forwardToSink(
+        applyFunction(preparedTask, newVariablesMap, context), context);
 }
 } // namespace execHelper::plugins::detail
 
@@ -160,4 +183,29 @@ auto executeCommands(const CommandCollection& commands, const Task& task,
     }
     return tasks;
 }
+
+auto runTargets(const Task& task, const CommandCollection& targets,
+                const ExecutionContext& context) -> Tasks {
+    Tasks tasks;
+    for(const auto& combination : makePatternPermutator(task.getPatterns())) {
+        CommandCollection commands;
+        commands.reserve(targets.size());
+        transform(targets.begin(), targets.end(), back_inserter(commands),
+                  [&combination](const auto& target) {
+                      return replacePatternCombinations(target, combination);
+                  });
+
+        try {
+            // Nested lua plugins lease a state of their own
+            auto newTasks = executeCommands(
+                commands, replacePatternCombinations(task, combination),
+                context);
+            move(newTasks.begin(), newTasks.end(), back_inserter(tasks));
+        } catch(const std::runtime_error& e) {
+            user_feedback_error(e.what());
+            rethrow_if_nested(e);
+        }
+    }
+    return tasks;
+}
 } // namespace execHelper::plugins
@@ -3,10 +3,16 @@
 #include "log/log.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iterator>
+#include <memory>
+#include <mutex>
+#include <sstream>
 #include <stdexcept>
+#include <system_error>
 #include <unordered_map>
 #include <utility>
 
@@ -17,6 +23,7 @@
 #include <boost/optional.hpp>
 
 #include "config/commandLineOptions.h"
+#include "config/settingsCache.h"
 #include "core/task.h"
 
 #include "addEnvironment.h"
@@ -35,6 +42,9 @@ using execHelper::config::Jobs_t;
 using execHelper::config::Path;
 using execHelper::config::VariablesMap;
 using execHelper::config::VERBOSE_KEY;
+using execHelper::config::fnv1a;
+using execHelper::config::getSettingsCacheFileIn;
+using execHelper::config::writeAtomically;
 using execHelper::core::Task;
 using execHelper::core::TaskCollection;
 using execHelper::core::Tasks;
@@ -46,7 +56,7 @@ class Config {
   public:
     explicit Config(const VariablesMap& config) noexcept : m_config(config) {}
 
-    auto get(const string& key) noexcept
+    auto get(const string& key) const noexcept
         -> boost::optional<unordered_map<string, string>> {
         if(!m_config.contains(key)) {
             return boost::none;
@@ -69,7 +79,7 @@ class Config {
         if(subsubnode.values()) {
             // Construct a map
             for(const auto& value : values) {
-                result[value] = *(subnode.get<std::string>(value));
+                result[value] = *(subnode.getRef<std::string>(value));
             }
         } else {
             // Construct an array with indices as keys
@@ -86,119 +96,448 @@ class Config {
 } // namespace
 
 namespace execHelper::plugins {
-auto luaPlugin(Task task, const VariablesMap& config,
-               const ExecutionContext& context, const filesystem::path& script)
-    -> Tasks {
-    Tasks tasks;
-    LuaContext lua;
+namespace {
+const string_view CHUNK_CACHE_MAGIC("EHLC 2");
+
+/**
+ * \brief A lua script compiled to a binary chunk
+ */
+struct Chunk {
+    int64_t modified = 0; //!< brief The modification time of the script
+    uint64_t size = 0U;   //!< brief The size of the script
+    uint64_t hash = 0U;   //!< brief The hash of the content of the script
+    string bytecode;      //!< brief The compiled script
+};
 
-    WorkingDirectory::apply(task, config);
-    AddEnvironment::apply(task, config);
+/**
+ * \brief Compiles the given source to the bytecode of a binary chunk
+ */
+using Compiler = std::function<string(const string& source)>;
+
+/**
+ * Returns the content of the given file
+ *
+ * \param[in] file  The file to read
+ * \returns The content of the file. A file that can not be read is empty.
+ */
+auto readFile(const Path& file) -> string {
+    ifstream stream(file, std::ios::binary);
+    return string((istreambuf_iterator<char>(stream)),
+                  istreambuf_iterator<char>());
+}
 
+/**
+ * Returns the header of the chunk cache file of the given script
+ *
+ * \param[in] script    The script the chunk was compiled from
+ * \param[in] chunk The compiled chunk of the script
+ * \returns The header, ending with a newline. It ends with the length and the
+ *          hash of the bytecode, as lua does not verify binary chunks.
+ */
+auto getChunkCacheHeader(const Path& script, const Chunk& chunk) -> string {
+    std::ostringstream header;
+    header << CHUNK_CACHE_MAGIC << " " << LUA_VERSION_NUM << "\n"
+           << filesystem::weakly_canonical(script).string() << "\n"
+           << chunk.modified << " " << chunk.size << " " << chunk.hash << " "
+           << chunk.bytecode.size() << " " << fnv1a(chunk.bytecode) << "\n";
+    return header.str();
+}
+
+/**
+ * Reads the chunk of the given script from the given chunk cache file
+ *
+ * \param[in] cacheFile The chunk cache file to read
+ * \param[in] script    The script the chunk must have been compiled from
+ * \returns The cached chunk
+ *          std::nullopt if the cache does not exist, belongs to another
+ *          script or lua version or its bytecode does not match its hash
+ */
+auto readChunkCache(const Path& cacheFile, const Path& script) noexcept
+    -> std::optional<Chunk> {
     try {
-        lua.writeVariable(
-            "verbose",
-            config.get<bool>(VERBOSE_KEY, context.options().getVerbosity()));
-        lua.writeVariable(
-            "jobs", config.get<Jobs_t>(JOBS_KEY, context.options().getJobs()));
+        const auto content = readFile(cacheFile);
+        std::istringstream stream(content);
+        string magic;
+        string path;
+        if(!getline(stream, magic) || !getline(stream, path)) {
+            return std::nullopt;
+        }
 
-        lua.executeCode("function get_commandline() "
-                        "return list(config['command-line']) or {} "
-                        "end");
-
-        lua.executeCode("function get_environment() "
-                        "return config['environment'] or {} "
-                        "end");
-
-        lua.executeCode("function get_verbose(verbose_command)"
-                        "if one(config['verbose']) "
-                        "then "
-                        "if one(config['verbose']) == 'yes' "
-                        "then "
-                        "return {verbose_command} "
-                        "end "
-                        "else "
-                        "if verbose "
-                        "then "
-                        "return {verbose_command} "
-                        "end "
-                        "end "
-                        "return {} "
-                        "end");
-        lua.executeCode("function input_error(message) "
-                        "error(message) "
-                        "end");
+        std::ostringstream version;
+        version << CHUNK_CACHE_MAGIC << " " << LUA_VERSION_NUM;
+        if(magic != version.str() ||
+           path != filesystem::weakly_canonical(script).string()) {
+            return std::nullopt;
+        }
 
-        // Define the Config class
-        Config configWrapper(config);
+        Chunk chunk;
+        size_t length = 0U;
+        uint64_t bytecodeHash = 0U;
+        if(!(stream >> chunk.modified >> chunk.size >> chunk.hash >> length >>
+             bytecodeHash) ||
+           stream.get() != '\n') {
+            return std::nullopt;
+        }
+        const auto offset = static_cast<size_t>(stream.tellg());
+        if(content.size() - offset != length) {
+            return std::nullopt;
+        }
+        chunk.bytecode = content.substr(offset);
+        if(fnv1a(chunk.bytecode) != bytecodeHash) {
+            return std::nullopt;
+        }
+        return chunk;
+    } catch(const std::exception& e) {
+        LOG(debug) << "Could not read lua chunk cache " << cacheFile << ": "
+                   << e.what();
+        return std::nullopt;
+    }
+}
+
+/**
+ * \brief Keeps the compiled chunks of the lua scripts for the current run and
+ * optionally in chunk cache files, so a script is only compiled again when
+ * it changes
+ */
+class ChunkCache {
+  public:
+    /**
+     * Returns the compiled chunk of the given script, compiling it if it is
+     * not cached or changed since it was cached
+     *
+     * \param[in] script    The script to return the chunk of
+     * \param[in] cacheFile The chunk cache file of the script
+     * \param[in] compile   Compiles the script if it is not cached
+     * \returns The compiled chunk
+     * \throws LuaContext::SyntaxErrorException If the script does not compile
+     */
+    auto get(const Path& script, const std::optional<Path>& cacheFile,
+             const Compiler& compile) -> shared_ptr<const Chunk> {
+        error_code error;
+        const auto modified = filesystem::last_write_time(script, error);
+        if(error) {
+            // Scripts that can not be read are run as empty scripts
+            auto chunk = make_shared<Chunk>();
+            chunk->bytecode = compile(readFile(script));
+            return chunk;
+        }
+
+        // The modification time and size of a script are not trusted to tell
+        // whether it changed: a chunk is only reused for the same content
+        const auto key = script.string();
+        const auto source = readFile(script);
+        auto chunk = make_shared<Chunk>();
+        *chunk = {static_cast<int64_t>(modified.time_since_epoch().count()),
+                  source.size(), fnv1a(source), string()};
+        {
+            lock_guard<mutex> lock(m_mutex);
+            auto found = m_chunks.find(key);
+            if(found != m_chunks.end() && found->second->size == chunk->size &&
+               found->second->hash == chunk->hash) {
+                return found->second;
+            }
+        }
+
+        auto cached = cacheFile ? readChunkCache(*cacheFile, script)
+                                : std::nullopt;
+        if(cached && cached->size == chunk->size &&
+           cached->hash == chunk->hash) {
+            chunk->bytecode = move(cached->bytecode);
+        } else {
+            LOG(debug) << "Compiling lua script " << script;
+            chunk->bytecode = compile(source);
+        }
+
+        if(cacheFile && (!cached || cached->modified != chunk->modified ||
+                         cached->size != chunk->size ||
+                         cached->hash != chunk->hash) &&
+           !writeAtomically(*cacheFile, getChunkCacheHeader(script, *chunk) +
+                                            chunk->bytecode)) {
+            LOG(debug) << "Could not write lua chunk cache " << *cacheFile;
+        }
+
+        lock_guard<mutex> lock(m_mutex);
+        m_chunks[key] = chunk;
+        return chunk;
+    }
+
+    /**
+     * Forgets the cached chunk of the given script
+     *
+     * \param[in] script    The script to forget the chunk of
+     * \param[in] cacheFile The chunk cache file of the script
+     */
+    void forget(const Path& script,
+                const std::optional<Path>& cacheFile) noexcept {
+        if(cacheFile) {
+            error_code error;
+            filesystem::remove(*cacheFile, error);
+        }
+        lock_guard<mutex> lock(m_mutex);
+        m_chunks.erase(script.string());
+    }
+
+  private:
+    mutex m_mutex;
+    unordered_map<string, shared_ptr<const Chunk>> m_chunks;
+};
+
+/**
+ * Returns the compiled chunks shared by all lua states
+ *
+ * \returns The chunk cache
+ */
+auto getChunks() noexcept -> ChunkCache& {
+    static ChunkCache chunks;
+    return chunks;
+}
+
+/**
+ * \brief The state of a single invocation of a lua plugin that the helper
+ * functions of a lua state act upon
+ */
+struct Invocation {
+    Tasks* tasks;                    //!< brief The registered tasks
+    const ExecutionContext* context; //!< brief The context
+};
+
+/**
+ * \brief A lua state with the helper library of the plugins loaded, so it can
+ * be reused for multiple invocations
+ */
+class LuaState {
+  public:
+    /**
+     * Constructor
+     *
+     * \throws std::runtime_error   If the helper library could not be loaded
+     */
+    LuaState();
+
+    LuaState(const LuaState& other) = delete;
+    LuaState(LuaState&& other) noexcept = delete;
+    ~LuaState() noexcept = default;
+
+    auto operator=(const LuaState& other) -> LuaState& = delete;
+    auto operator=(LuaState&& other) noexcept -> LuaState& = delete;
+
+    /**
+     * Runs the given script for the given task
+     *
+     * \param[in] task  The task to pass to the script
+     * \param[in] config    The configuration of the plugin
+     * \param[in] context   The context of the invocation
+     * \param[in] script    The script to run
+     * \param[in] chunkCacheFile    The file to cache the compiled script in
+     * \returns The tasks registered by the script
+     */
+    auto run(Task task, const VariablesMap& config,
+             const ExecutionContext& context, const filesystem::path& script,
+             const std::optional<filesystem::path>& chunkCacheFile) -> Tasks;
+
+    /**
+     * Restores the globals to the state right after loading the helper library
+     */
+    void reset();
+
+  private:
+    /**
+     * Compiles the given source to the bytecode of a binary chunk
+     *
+     * \param[in] source    The source to compile
+     * \returns The bytecode
+     * \throws LuaContext::SyntaxErrorException If the source does not compile
+     */
+    auto compile(const string& source) -> string;
+
+    /**
+     * Loads the compiled chunk of the given script, unless it is loaded already
+     *
+     * \param[in] script    The script to load the chunk of
+     * \param[in] chunk The compiled chunk of the script
+     * \returns True    If the chunk is loaded
+     *          False   If the bytecode of the chunk is invalid
+     */
+    auto load(const filesystem::path& script,
+              const shared_ptr<const Chunk>& chunk) -> bool;
+
+    LuaContext m_lua;
+    Invocation m_invocation{nullptr, nullptr};
+    std::function<void()> m_reset;
+    std::function<std::tuple<bool, string>(const string&)> m_compileChunk;
+    std::function<boost::optional<string>(const string&, const string&)>
+        m_loadChunk;
+    std::function<void(const string&)> m_runChunk;
+    unordered_map<string, shared_ptr<const Chunk>> m_loaded;
+};
+
+/**
+ * \brief Hands out lua states that are not in use by another invocation
+ */
+class LuaStatePool {
+  public:
+    /**
+     * \brief Returns a lua state to the pool when it goes out of scope
+     */
+    class Lease {
+      public:
+        /**
+         * Constructor
+         *
+         * \param[in] pool  The pool to return the state to
+         * \param[in] state The leased state
+         */
+        Lease(LuaStatePool& pool, unique_ptr<LuaState> state) noexcept
+            : m_pool(pool), m_state(move(state)) {
+            ;
+        }
+
+        Lease(const Lease& other) = delete;
+        Lease(Lease&& other) noexcept = delete;
+
+        ~Lease() noexcept { m_pool.release(move(m_state)); }
+
+        auto operator=(const Lease& other) -> Lease& = delete;
+        auto operator=(Lease&& other) noexcept -> Lease& = delete;
+
+        /**
+         * Access the leased state
+         *
+         * \returns The leased state
+         */
+        auto operator->() const noexcept -> LuaState* { return m_state.get(); }
+
+      private:
+        LuaStatePool& m_pool;
+        unique_ptr<LuaState> m_state;
+    };
+
+    /**
+     * Leases a state, creating a new one if all states are in use
+     *
+     * \returns The leased state
+     */
+    auto acquire() -> Lease {
+        {
+            lock_guard<mutex> lock(m_mutex);
+            if(!m_states.empty()) {
+                auto state = move(m_states.back());
+                m_states.pop_back();
+                return Lease(*this, move(state));
+            }
+        }
+        return Lease(*this, make_unique<LuaState>());
+    }
+
+  private:
+    /**
+     * Resets the given state and makes it available again. States that can
+     * not be reset are discarded.
+     *
+     * \param[in] state The state to release
+     */
+    void release(unique_ptr<LuaState> state) noexcept {
+        try {
+            state->reset();
+        } catch(const std::exception& e) {
+            LOG(warning) << "Discarding lua state: " << e.what();
+            return;
+        }
+        lock_guard<mutex> lock(m_mutex);
+        m_states.push_back(move(state));
+    }
+
+    mutex m_mutex;
+    vector<unique_ptr<LuaState>> m_states;
+};
 
-        lua.writeVariable("config", configWrapper);
+LuaState::LuaState() {
+    try {
+        m_lua.executeCode("function get_commandline() "
+                          "return list(config['command-line']) or {} "
+                          "end");
+
+        m_lua.executeCode("function get_environment() "
+                          "return config['environment'] or {} "
+                          "end");
+
+        m_lua.executeCode("function get_verbose(verbose_command)"
+                          "if one(config['verbose']) "
+                          "then "
+                          "if one(config['verbose']) == 'yes' "
+                          "then "
+                          "return {verbose_command} "
+                          "end "
+                          "else "
+                          "if verbose "
+                          "then "
+                          "return {verbose_command} "
+                          "end "
+                          "end "
+                          "return {} "
+                          "end");
+        m_lua.executeCode("function input_error(message) "
+                          "error(message) "
+                          "end");
 
-        lua.writeFunction<boost::optional<unordered_map<string, string>>(
-            Config&, const std::string&)>(
-            "config", LuaContext::Metatable, "__index",
-            [](Config& config, const std::string& key) {
+        // Define the Config class
+        m_lua.registerMember<Config,
+                             boost::optional<unordered_map<string, string>>>(
+            [](const Config& config, const std::string& key) {
                 return config.get(key);
             });
 
         // Define the Task class
-        lua.writeVariable("task", task);
-        lua.registerFunction<Task, Task()>(
+        m_lua.registerFunction<Task, Task()>(
             "new", [](const Task& /*task*/) { return Task(); });
-        lua.registerFunction<Task, Task()>(
+        m_lua.registerFunction<Task, Task()>(
             "copy", [](const Task& task) { return Task(task); });
-        lua.registerFunction<Task, void(const vector<pair<int, string>>&)>(
+        m_lua.registerFunction<Task, void(const vector<pair<int, string>>&)>(
             "add_args", [](Task& task, const vector<pair<int, string>>& args) {
                 std::for_each(
                     args.begin(), args.end(),
                     [&task](const auto& arg) { task.append(arg.second); });
             });
 
-        lua.writeFunction("register_task", [&tasks](Task task) {
-            tasks.emplace_back(move(task));
+        m_lua.writeFunction("register_task", [this](Task task) {
+            const auto& context = *m_invocation.context;
+            if(context.sink()) {
+                context.sink()(move(task));
+                return;
+            }
+            m_invocation.tasks->emplace_back(move(task));
         });
 
-        lua.writeFunction("register_tasks",
-                          [&tasks](const vector<pair<int, Task>>& newTasks) {
-                              transform(
-                                  newTasks.begin(), newTasks.end(),
-                                  back_inserter(tasks),
-                                  [](const auto& task) { return task.second; });
-                          });
-
-        lua.writeFunction<Tasks(const Task&, const vector<pair<int, string>>&)>(
-            "run_target",
-            [&context](const Task& task,
-                       const vector<pair<int, string>>& commands) -> Tasks {
-                Tasks tasks;
-                for(const auto& combination :
-                    makePatternPermutator(task.getPatterns())) {
-                    CommandCollection commandsToExecute;
-                    commandsToExecute.reserve(commands.size());
-
-                    transform(commands.begin(), commands.end(),
-                              back_inserter(commandsToExecute),
-                              [&combination](const auto& command) {
-                                  return replacePatternCombinations(
-                                      command.second, combination);
-                              });
-
-                    core::Task newTask =
-                        replacePatternCombinations(task, combination);
-                    try {
-                        auto newTasks = executeCommands(commandsToExecute,
-                                                        newTask, context);
-                        move(newTasks.begin(), newTasks.end(),
-                             back_inserter(tasks));
-                    } catch(const std::runtime_error& e) {
-                        user_feedback_error(e.what());
-                        rethrow_if_nested(e);
+        m_lua.writeFunction(
+            "register_tasks", [this](const vector<pair<int, Task>>& newTasks) {
+                const auto& context = *m_invocation.context;
+                if(context.sink()) {
+                    for(const auto& task : newTasks) {
+                        context.sink()(task.second);
                     }
+                    return;
                 }
-                return tasks;
+                transform(newTasks.begin(), newTasks.end(),
+                          back_inserter(*m_invocation.tasks),
+                          [](const auto& task) { return task.second; });
             });
 
-        lua.writeFunction<boost::optional<string>(
+        // When streaming to a sink, the tasks of the targets are handed over
+        // to the sink as they are resolved and the returned list is empty
+        m_lua.writeFunction<Tasks(const Task&,
+                                  const vector<pair<int, string>>&)>(
+            "run_target",
+            [this](const Task& task,
+                   const vector<pair<int, string>>& commands) -> Tasks {
+                CommandCollection targets;
+                targets.reserve(commands.size());
+                transform(commands.begin(), commands.end(),
+                          back_inserter(targets),
+                          [](const auto& command) { return command.second; });
+                return runTargets(task, targets, *m_invocation.context);
+            });
+
+        m_lua.writeFunction<boost::optional<string>(
             const boost::optional<unordered_map<string, string>>&)>(
             "one",
             [](const boost::optional<unordered_map<string, string>>& values)
@@ -209,13 +548,13 @@ auto luaPlugin(Task task, const VariablesMap& config,
                 return (*values).at("0");
             });
 
-        lua.writeFunction("user_feedback", [](const string& message) {
+        m_lua.writeFunction("user_feedback", [](const string& message) {
             user_feedback_error(message);
         });
-        lua.writeFunction("user_feedback_error", [](const string& message) {
+        m_lua.writeFunction("user_feedback_error", [](const string& message) {
             user_feedback_error(message);
         });
-        lua.writeFunction(
+        m_lua.writeFunction(
             "list",
             [](const boost::optional<unordered_map<string, string>>& values)
                 -> boost::optional<std::vector<pair<int, string>>> {
@@ -237,20 +576,134 @@ auto luaPlugin(Task task, const VariablesMap& config,
                 return result;
             });
 
-        lua.writeFunction<bool(const std::string&)>(
+        m_lua.writeFunction<bool(const std::string&)>(
             "isdir", [](const std::string& path) {
                 filesystem::path ppath(path);
                 return filesystem::is_directory(ppath);
             });
+
+        // Compiled scripts are kept in a table that is not reachable from the
+        // scripts themselves
+        m_lua.executeCode("local chunks = {} "
+                          "function compile_chunk(source) "
+                          "local chunk, message = load(source, 'chunk') "
+                          "if chunk == nil "
+                          "then "
+                          "return false, message "
+                          "end "
+                          "return true, string.dump(chunk) "
+                          "end "
+                          "function load_chunk(name, bytecode) "
+                          "local chunk, message = load(bytecode, 'chunk', 'b') "
+                          "chunks[name] = chunk "
+                          "return message "
+                          "end "
+                          "function run_chunk(name) "
+                          "chunks[name]() "
+                          "end");
+        m_compileChunk = m_lua.readVariable<
+            std::function<std::tuple<bool, string>(const string&)>>(
+            "compile_chunk");
+        m_loadChunk = m_lua.readVariable<std::function<boost::optional<string>(
+            const string&, const string&)>>("load_chunk");
+        m_runChunk =
+            m_lua.readVariable<std::function<void(const string&)>>("run_chunk");
+        m_lua.writeVariable("compile_chunk", nullptr);
+        m_lua.writeVariable("load_chunk", nullptr);
+        m_lua.writeVariable("run_chunk", nullptr);
+
+        // Remember the content and metatable of every table reachable from
+        // the globals of the helper library, such as the string and table
+        // libraries, so everything a script defines, overrides or removes in
+        // them can be undone before the state is reused. The functions are
+        // kept in locals, as a script may override the globals.
+        m_lua.executeCode("local next, rawset, type = next, rawset, type "
+                          "local getmetatable = debug.getmetatable "
+                          "local setmetatable = debug.setmetatable "
+                          "local snapshots = {} "
+                          "local function snapshot(value) "
+                          "if type(value) ~= 'table' or snapshots[value] "
+                          "then "
+                          "return "
+                          "end "
+                          "local content = {} "
+                          "snapshots[value] = { "
+                          "content = content, "
+                          "metatable = getmetatable(value) "
+                          "} "
+                          "for key, field in next, value do "
+                          "content[key] = field "
+                          "snapshot(field) "
+                          "end "
+                          "snapshot(getmetatable(value)) "
+                          "end "
+                          "snapshot(_G) "
+                          "local string_metatable = getmetatable('') "
+                          "snapshot(string_metatable) "
+                          "function reset_globals() "
+                          "setmetatable('', string_metatable) "
+                          "for value, saved in next, snapshots do "
+                          "setmetatable(value, saved.metatable) "
+                          "for key in next, value do "
+                          "if saved.content[key] == nil then "
+                          "rawset(value, key, nil) "
+                          "end "
+                          "end "
+                          "for key, field in next, saved.content do "
+                          "rawset(value, key, field) "
+                          "end "
+                          "end "
+                          "end");
+        m_reset = m_lua.readVariable<std::function<void()>>("reset_globals");
+        m_lua.writeVariable("reset_globals", nullptr);
     } catch(std::exception& e) {
         LOG(error) << "Internal error: '" << e.what() << "'";
         throw runtime_error(
             string("Lua plugin: Internal error: ").append(e.what()));
     }
+}
 
+auto LuaState::run(Task task, const VariablesMap& config,
+                   const ExecutionContext& context,
+                   const filesystem::path& script,
+                   const std::optional<filesystem::path>& chunkCacheFile)
+    -> Tasks {
+    Tasks tasks;
+    m_invocation = {&tasks, &context};
+
+    try {
+        m_lua.writeVariable(
+            "verbose",
+            config.get<bool>(VERBOSE_KEY, context.options().getVerbosity()));
+        m_lua.writeVariable(
+            "jobs", config.get<Jobs_t>(JOBS_KEY, context.options().getJobs()));
+        m_lua.writeVariable("config", Config(config));
+        m_lua.writeVariable("task", move(task));
+    } catch(std::exception& e) {
+        LOG(error) << "Internal error: '" << e.what() << "'";
+        throw runtime_error(
+            string("Lua plugin: Internal error: ").append(e.what()));
+    }
+
+    bool invalidChunk = false;
     try {
-        ifstream executionCode(script);
-        lua.executeCode(executionCode);
+        const auto compiler = [this](const string& source) {
+            return compile(source);
+        };
+        auto loaded =
+            load(script, getChunks().get(script, chunkCacheFile, compiler));
+        if(!loaded) {
+            // The cached chunk is corrupt: compile the script again
+            getChunks().forget(script, chunkCacheFile);
+            loaded =
+                load(script, getChunks().get(script, chunkCacheFile, compiler));
+        }
+        if(loaded) {
+            m_runChunk(script.string());
+        } else {
+            getChunks().forget(script, chunkCacheFile);
+            invalidChunk = true;
+        }
     } catch(const LuaContext::SyntaxErrorException& e) {
         LOG(error) << "Syntax error detected in lua file '" + script.string() +
                           "': " + e.what();
@@ -265,6 +718,77 @@ auto luaPlugin(Task task, const VariablesMap& config,
         LOG(error) << e.what();
         rethrow_if_nested(e);
     }
+
+    if(invalidChunk) {
+        throw runtime_error(
+            string("Lua plugin: Internal error: invalid compiled chunk for lua "
+                   "file '")
+                .append(script.string())
+                .append("'"));
+    }
     return tasks;
 }
+
+auto LuaState::compile(const string& source) -> string {
+    auto [compiled, result] = m_compileChunk(source);
+    if(!compiled) {
+        throw LuaContext::SyntaxErrorException(result);
+    }
+    return result;
+}
+
+auto LuaState::load(const filesystem::path& script,
+                    const shared_ptr<const Chunk>& chunk) -> bool {
+    const auto name = script.string();
+    auto loaded = m_loaded.find(name);
+    if(loaded != m_loaded.end() && loaded->second == chunk) {
+        return true;
+    }
+
+    if(auto message = m_loadChunk(name, chunk->bytecode)) {
+        LOG(warning) << "Failed to load the compiled chunk of " << script
+                     << ": " << *message;
+        m_loaded.erase(name);
+        return false;
+    }
+    m_loaded[name] = chunk;
+    return true;
+}
+
+void LuaState::reset() {
+    m_invocation = {nullptr, nullptr};
+    m_reset();
+}
+
+/**
+ * Returns the pool of lua states shared by all lua plugins
+ *
+ * \returns The pool
+ */
+auto getPool() noexcept -> LuaStatePool& {
+    static LuaStatePool pool;
+    return pool;
+}
+} // namespace
+
+auto luaPlugin(Task task, const VariablesMap& config,
+               const ExecutionContext& context, const filesystem::path& script,
+               const std::optional<filesystem::path>& chunkCacheFile)
+    -> Tasks {
+    WorkingDirectory::apply(task, config);
+    AddEnvironment::apply(task, config);
+
+    auto state = getPool().acquire();
+    return state->run(move(task), config, context, script, chunkCacheFile);
+}
+
+auto getLuaChunkCacheFile(const filesystem::path& script,
+                          const filesystem::path& cacheDirectory) noexcept
+    -> std::optional<filesystem::path> {
+    auto cacheFile = getSettingsCacheFileIn(script, cacheDirectory);
+    if(cacheFile) {
+        cacheFile->replace_extension(".luac");
+    }
+    return cacheFile;
+}
 } // namespace execHelper::plugins
@@ -0,0 +1,331 @@
+#include "nativePlugins.h"
+
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "config/commandLineOptions.h"
+#include "config/variablesMap.h"
+#include "core/task.h"
+
+#include "addEnvironment.h"
+#include "commandLine.h"
+#include "executePlugin.h"
+#include "executionContext.h"
+#include "logger.h"
+#include "workingDirectory.h"
+
+using std::nullopt;
+using std::optional;
+using std::pair;
+using std::runtime_error;
+using std::string;
+using std::string_view;
+using std::vector;
+
+using execHelper::config::JOBS_KEY;
+using execHelper::config::VariablesMap;
+using execHelper::config::VERBOSE_KEY;
+using execHelper::core::Task;
+using execHelper::core::TaskCollection;
+using execHelper::core::Tasks;
+using execHelper::plugins::COMMAND_LINE_KEY;
+using execHelper::plugins::ExecutionContext;
+
+/*
+ * The helpers below mirror the helper library of the lua plugins, so the
+ * native plugins interpret their configuration like the lua scripts do.
+ */
+namespace {
+/**
+ * Returns the first value of the given key, like one() in a lua plugin
+ *
+ * \param[in] variables The configuration of the plugin
+ * \param[in] key   The key to get the value of
+ * \returns The first value of the key
+ *          std::nullopt if the key has no values
+ */
+auto one(const VariablesMap& variables, string_view key) -> optional<string> {
+    const auto* values = variables.getRef<vector<string>>(key);
+    if(values == nullptr || values->empty()) {
+        return nullopt;
+    }
+    return values->front();
+}
+
+/**
+ * Returns the values of the given key, like list() in a lua plugin
+ *
+ * \param[in] variables The configuration of the plugin
+ * \param[in] key   The key to get the values of
+ * \returns The values of the key
+ *          std::nullopt if the key does not exist
+ */
+auto list(const VariablesMap& variables, string_view key)
+    -> optional<vector<string>> {
+    return variables.get<vector<string>>(key);
+}
+
+/**
+ * Returns the key-value pairs of the given key, in the order they are
+ * configured
+ *
+ * \param[in] variables The configuration of the plugin
+ * \param[in] key   The key to get the pairs of
+ * \returns The pairs of the key
+ */
+auto pairs(const VariablesMap& variables, const string& key)
+    -> vector<pair<string, string>> {
+    vector<pair<string, string>> result;
+    const auto* names = variables.getRef<vector<string>>(key);
+    if(names == nullptr) {
+        return result;
+    }
+    result.reserve(names->size());
+    for(const auto& name : *names) {
+        const auto* value = variables.getRef<string>({key, name});
+        if(value != nullptr) {
+            result.emplace_back(name, *value);
+        }
+    }
+    return result;
+}
+
+/**
+ * Returns the given flag if verbose mode is activated, like get_verbose() in a
+ * lua plugin
+ *
+ * \param[in] variables The configuration of the plugin
+ * \param[in] context   The context of the invocation
+ * \param[in] flag  The flag that activates verbose mode
+ * \returns The arguments to add to the task
+ */
+auto getVerbose(const VariablesMap& variables, const ExecutionContext& context,
+                string flag) -> TaskCollection {
+    const auto verbose = one(variables, VERBOSE_KEY);
+    if(verbose ? *verbose == "yes" : context.options().getVerbosity()) {
+        return {std::move(flag)};
+    }
+    return {};
+}
+
+/**
+ * Returns the number of jobs to use
+ *
+ * \param[in] variables The configuration of the plugin
+ * \param[in] context   The context of the invocation
+ * \returns The number of jobs
+ */
+auto getJobs(const VariablesMap& variables, const ExecutionContext& context)
+    -> string {
+    return one(variables, JOBS_KEY)
+        .value_or(std::to_string(context.options().getJobs()));
+}
+
+/**
+ * Returns the command line arguments, like get_commandline() in a lua plugin
+ *
+ * \param[in] variables The configuration of the plugin
+ * \returns The command line arguments
+ */
+auto getCommandLine(const VariablesMap& variables) -> TaskCollection {
+    return list(variables, COMMAND_LINE_KEY).value_or(TaskCollection());
+}
+
+/**
+ * Applies the configuration every plugin supports to the given task
+ *
+ * \param[in] task  The task to prepare
+ * \param[in] variables The configuration of the plugin
+ * \returns The prepared task
+ */
+auto prepare(Task task, const VariablesMap& variables) -> Task {
+    execHelper::plugins::WorkingDirectory::apply(task, variables);
+    execHelper::plugins::AddEnvironment::apply(task, variables);
+    return task;
+}
+
+/**
+ * Reports an invalid configuration of a plugin
+ *
+ * \param[in] message   The message to report
+ * \throws std::runtime_error   Always
+ */
+[[noreturn]] void inputError(const string& message) {
+    LOG(error) << message;
+    throw runtime_error(message);
+}
+
+auto make(Task task, const VariablesMap& variables,
+          const ExecutionContext& context) -> Tasks {
+    task = prepare(std::move(task), variables);
+    task.append("make");
+    task.append({"--directory", one(variables, "build-dir").value_or(".")});
+    task.append(getVerbose(variables, context, "--debug"));
+    task.append({"--jobs", getJobs(variables, context)});
+    task.append(getCommandLine(variables));
+    return {std::move(task)};
+}
+
+auto ninja(Task task, const VariablesMap& variables,
+           const ExecutionContext& context) -> Tasks {
+    task = prepare(std::move(task), variables);
+    task.append("ninja");
+    task.append({"-C", one(variables, "build-dir").value_or(".")});
+    task.append(getVerbose(variables, context, "--verbose"));
+    task.append({"-j", getJobs(variables, context)});
+    task.append(getCommandLine(variables));
+    return {std::move(task)};
+}
+
+auto cmake(Task task, const VariablesMap& variables,
+           const ExecutionContext& context) -> Tasks {
+    task = prepare(std::move(task), variables);
+    task.append("cmake");
+
+    const auto mode = one(variables, "mode").value_or("generate");
+    const auto buildDir = one(variables, "build-dir").value_or(".");
+    if(mode == "generate") {
+        task.append({"-S", one(variables, "source-dir").value_or(".")});
+        task.append({"-B", buildDir});
+        if(auto generator = one(variables, "generator")) {
+            task.append({"-G", std::move(*generator)});
+        }
+        for(const auto& [name, value] : pairs(variables, "defines")) {
+            task.append({"-D", "\"" + name + "=" + value + "\""});
+        }
+        task.append(getVerbose(variables, context, "--log-level=VERBOSE"));
+    } else if(mode == "build") {
+        task.append({"--build", buildDir});
+        if(auto target = one(variables, "target")) {
+            task.append({"--target", std::move(*target)});
+        }
+        if(auto configuration = one(variables, "configuration")) {
+            task.append({"--config", std::move(*configuration)});
+        }
+        task.append({"--parallel", getJobs(variables, context)});
+        task.append(getVerbose(variables, context, "--verbose"));
+    } else if(mode == "install") {
+        task.append({"--install", buildDir});
+        if(auto configuration = one(variables, "configuration")) {
+            task.append({"--config", std::move(*configuration)});
+        }
+        if(auto prefix = one(variables, "prefix")) {
+            task.append({"--prefix", std::move(*prefix)});
+        }
+        if(auto component = one(variables, "component")) {
+            task.append({"--component", std::move(*component)});
+        }
+        task.append(getVerbose(variables, context, "--verbose"));
+    } else {
+        user_feedback_error("You must define a valid mode! Options are: "
+                            "generate, build or install.");
+        inputError("You must define a valid mode!");
+    }
+
+    task.append(getCommandLine(variables));
+    return {std::move(task)};
+}
+
+auto meson(Task task, const VariablesMap& variables,
+           const ExecutionContext& context) -> Tasks {
+    task = prepare(std::move(task), variables);
+    task.append("meson");
+
+    const auto mode = one(variables, "mode").value_or("setup");
+    if(mode != "setup" && mode != "compile" && mode != "install" &&
+       mode != "test") {
+        inputError("You must define a valid mode! Options are: setup, "
+                   "compile, install or test.");
+    }
+    task.append(mode);
+
+    const auto buildDir = one(variables, "build-dir").value_or(".");
+    if(mode == "setup") {
+        if(auto buildType = one(variables, "build-type")) {
+            task.append({"--buildtype", std::move(*buildType)});
+        }
+        if(auto crossFile = one(variables, "cross-file")) {
+            task.append({"--cross-file", std::move(*crossFile)});
+        }
+        if(auto prefix = one(variables, "prefix")) {
+            task.append({"--prefix", std::move(*prefix)});
+        }
+        for(const auto& [name, value] : pairs(variables, "options")) {
+            task.append({"-D", name + "=" + value});
+        }
+    } else if(mode == "compile") {
+        task.append({"--jobs", getJobs(variables, context)});
+        task.append({"-C", buildDir});
+    } else if(mode == "install") {
+        task.append({"-C", buildDir});
+    } else {
+        for(const auto& suite : list(variables, "suites").value_or(
+                vector<string>())) {
+            task.append({"--suite", suite});
+        }
+        task.append({"-C", buildDir});
+    }
+
+    task.append(getCommandLine(variables));
+
+    if(mode == "test") {
+        task.append(list(variables, "targets").value_or(TaskCollection()));
+    } else if(mode == "setup") {
+        task.append({buildDir, one(variables, "source-dir").value_or(".")});
+    }
+    return {std::move(task)};
+}
+
+auto selector(Task task, const VariablesMap& variables,
+              const ExecutionContext& context) -> Tasks {
+    task = prepare(std::move(task), variables);
+
+    const auto targets = list(variables, "targets");
+    if(!targets) {
+        inputError("Undefined selector target: you must define at least one "
+                   "target to select using the \"targets\" keyword.");
+    }
+    return execHelper::plugins::runTargets(task, *targets, context);
+}
+
+/**
+ * Returns the plugin that runs the command of its configuration in the given
+ * shell
+ *
+ * \param[in] shell The shell to run the command in
+ * \param[in] name  The name of the shell in error messages
+ * \returns The plugin
+ */
+auto shellPlugin(string shell, string name)
+    -> execHelper::plugins::ApplyFunction {
+    return [shell = std::move(shell), name = std::move(name)](
+               Task task, const VariablesMap& variables,
+               [[maybe_unused]] const ExecutionContext& context) -> Tasks {
+        task = prepare(std::move(task), variables);
+
+        auto command = one(variables, "command");
+        if(!command) {
+            inputError(name + ": error: you must define a command!");
+        }
+        task.append({shell, "-c", std::move(*command)});
+        task.append(getCommandLine(variables));
+        return {std::move(task)};
+    };
+}
+} // namespace
+
+namespace execHelper::plugins {
+auto getNativePlugins() noexcept -> const Plugins& {
+    static const Plugins plugins{
+        {"make", &make},         {"ninja", &ninja},
+        {"cmake", &cmake},       {"meson", &meson},
+        {"selector", &selector}, {"sh", shellPlugin("sh", "Sh")},
+        {"bash", shellPlugin("bash", "Bash")},
+    };
+    return plugins;
+}
+} // namespace execHelper::plugins
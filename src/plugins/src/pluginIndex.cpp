@@ -0,0 +1,273 @@
+#include "pluginIndex.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include "config/settingsCache.h"
+
+#include "logger.h"
+#include "luaPlugin.h"
+#include "sharedLibraryPlugin.h"
+
+using std::error_code;
+using std::getline;
+using std::ifstream;
+using std::nullopt;
+using std::move;
+using std::optional;
+using std::string;
+using std::string_view;
+
+using execHelper::config::getSettingsCacheFileIn;
+using execHelper::config::Path;
+using execHelper::config::writeAtomically;
+using execHelper::plugins::PluginIndex;
+using execHelper::plugins::PluginIndexEntry;
+using execHelper::plugins::SHARED_LIBRARY_PLUGIN_EXTENSION;
+using execHelper::plugins::SHARED_LIBRARY_PLUGIN_SUMMARY_EXTENSION;
+
+namespace filesystem = std::filesystem;
+
+namespace {
+const string_view INDEX_HEADER("EHPI 1");
+const char SEPARATOR = '\t';
+
+/**
+ * Returns the modification time of the given path
+ *
+ * \param[in] path  The path
+ * \returns The modification time
+ *          std::nullopt if the path does not exist
+ */
+auto getModificationTime(const Path& path) noexcept -> optional<int64_t> {
+    error_code error;
+    const auto modified = filesystem::last_write_time(path, error);
+    if(error) {
+        return nullopt;
+    }
+    return static_cast<int64_t>(modified.time_since_epoch().count());
+}
+
+/**
+ * Returns the modification time of the files the index entry of the given
+ * plugin is derived from: the plugin itself and, for a shared library, the
+ * file that contains its summary
+ *
+ * \param[in] plugin    The plugin
+ * \returns The latest modification time of the files
+ *          std::nullopt if the plugin does not exist
+ */
+auto getPluginModificationTime(const Path& plugin) noexcept
+    -> optional<int64_t> {
+    auto modified = getModificationTime(plugin);
+    if(modified && plugin.extension() == SHARED_LIBRARY_PLUGIN_EXTENSION) {
+        auto summaryFile = plugin;
+        summaryFile.replace_extension(SHARED_LIBRARY_PLUGIN_SUMMARY_EXTENSION);
+        if(const auto summaryModified = getModificationTime(summaryFile)) {
+            modified = std::max(*modified, *summaryModified);
+        }
+    }
+    return modified;
+}
+
+/**
+ * Returns the line that identifies the directory an index belongs to: its
+ * modification time and its path
+ *
+ * \param[in] directory The plugin search directory
+ * \returns The line for the directory
+ *          std::nullopt if the directory does not exist
+ */
+auto getDirectoryLine(const Path& directory) noexcept -> optional<string> {
+    const auto modified = getModificationTime(directory);
+    error_code error;
+    const auto path = filesystem::weakly_canonical(directory, error);
+    if(!modified || error) {
+        return nullopt;
+    }
+    return std::to_string(*modified) + " " + path.string();
+}
+
+/**
+ * Returns the first line of a plugin index. It contains the version of the
+ * binary, as the summaries of the plugins depend on it.
+ *
+ * \param[in] version   The version of the binary
+ * \returns The header line
+ */
+auto getIndexHeader(string_view version) -> string {
+    return string(INDEX_HEADER).append(" ").append(version);
+}
+
+/**
+ * Parses a line of a plugin index
+ *
+ * \param[in] line  The line to parse
+ * \returns The plugin on the line
+ *          std::nullopt if the line is corrupt
+ */
+auto parseEntry(string_view line) noexcept -> optional<PluginIndexEntry> {
+    std::array<string_view, 4U> fields;
+    for(auto i = 0U; i < fields.size(); ++i) {
+        const auto end = line.find(SEPARATOR);
+        if((end == string_view::npos) != (i + 1U == fields.size())) {
+            return nullopt;
+        }
+        fields[i] = line.substr(0U, end);
+        line.remove_prefix(end == string_view::npos ? line.size() : end + 1U);
+    }
+
+    PluginIndexEntry entry;
+    try {
+        entry.modified = std::stoll(string(fields[0]));
+    } catch(const std::exception&) {
+        return nullopt;
+    }
+    entry.name = fields[1];
+    entry.path = fields[2];
+    entry.summary = fields[3];
+    return entry;
+}
+} // namespace
+
+namespace execHelper::plugins {
+auto scanPluginDirectory(const Path& directory) -> PluginIndex {
+    PluginIndex index;
+    for(const auto& entry : filesystem::directory_iterator(directory)) {
+        if(!entry.is_regular_file()) {
+            continue;
+        }
+
+        optional<string> summary;
+        if(entry.path().extension() == ".lua") {
+            summary = luaPluginSummary(entry.path());
+        } else if(entry.path().extension() ==
+                  SHARED_LIBRARY_PLUGIN_EXTENSION) {
+            // The library is not loaded: it is only checked when it is applied
+            summary = sharedLibraryPluginSummary(entry.path());
+        }
+
+        if(summary) {
+            LOG(trace) << "Module " << entry.path().stem() << " found at "
+                       << directory;
+            const auto modified = getPluginModificationTime(entry.path());
+            index.push_back({entry.path().stem().string(), entry.path(),
+                             move(*summary), modified.value_or(0)});
+        }
+    }
+    std::sort(index.begin(), index.end(),
+              [](const auto& lhs, const auto& rhs) {
+                  return lhs.name < rhs.name;
+              });
+    return index;
+}
+
+auto getPluginIndexFile(const Path& directory,
+                        const Path& cacheDirectory) noexcept -> optional<Path> {
+    auto indexFile = getSettingsCacheFileIn(directory, cacheDirectory);
+    if(indexFile) {
+        indexFile->replace_extension(".plugins");
+    }
+    return indexFile;
+}
+
+auto readPluginIndex(const Path& indexFile, const Path& directory,
+                     string_view version) noexcept -> optional<PluginIndex> {
+    try {
+        ifstream stream(indexFile);
+        string line;
+        if(!getline(stream, line) || line != getIndexHeader(version)) {
+            return nullopt;
+        }
+
+        const auto directoryLine = getDirectoryLine(directory);
+        if(!directoryLine || !getline(stream, line) || line != *directoryLine) {
+            LOG(debug) << "Plugin index " << indexFile << " is stale";
+            return nullopt;
+        }
+
+        PluginIndex index;
+        while(getline(stream, line)) {
+            auto entry = parseEntry(line);
+            if(!entry) {
+                return nullopt;
+            }
+            // Plugins that are changed in place do not change the directory
+            if(getPluginModificationTime(entry->path) != entry->modified) {
+                LOG(debug) << "Plugin index " << indexFile << " is stale";
+                return nullopt;
+            }
+            index.push_back(std::move(*entry));
+        }
+        if(!stream.eof()) {
+            return nullopt;
+        }
+        return index;
+    } catch(const std::exception& e) {
+        LOG(warning) << "Could not read plugin index " << indexFile << ": "
+                     << e.what();
+        return nullopt;
+    }
+}
+
+auto writePluginIndex(const Path& indexFile, const Path& directory,
+                      const PluginIndex& index, string_view version) noexcept
+    -> bool {
+    try {
+        const auto directoryLine = getDirectoryLine(directory);
+        if(!directoryLine) {
+            return false;
+        }
+
+        std::ostringstream content;
+        content << getIndexHeader(version) << "\n" << *directoryLine << "\n";
+        for(const auto& entry : index) {
+            const auto path = entry.path.string();
+            for(const string_view field : {string_view(entry.name),
+                                           string_view(path),
+                                           string_view(entry.summary)}) {
+                // These plugins can not be indexed and are always scanned
+                if(field.find_first_of("\t\n") != string_view::npos) {
+                    return false;
+                }
+            }
+            content << entry.modified << SEPARATOR << entry.name << SEPARATOR
+                    << path << SEPARATOR << entry.summary << "\n";
+        }
+        return writeAtomically(indexFile, content.str());
+    } catch(const std::exception& e) {
+        LOG(warning) << "Could not write plugin index " << indexFile << ": "
+                     << e.what();
+        return false;
+    }
+}
+
+auto getPlugins(const Path& directory, const optional<Path>& cacheDirectory,
+                string_view version) -> PluginIndex {
+    const auto indexFile =
+        cacheDirectory ? getPluginIndexFile(directory, *cacheDirectory)
+                       : nullopt;
+    if(indexFile) {
+        if(auto index = readPluginIndex(*indexFile, directory, version)) {
+            return *index;
+        }
+    }
+
+    const auto before = getDirectoryLine(directory);
+    auto index = scanPluginDirectory(directory);
+
+    // Do not index a directory that changed while it was listed
+    if(indexFile && before == getDirectoryLine(directory) &&
+       !writePluginIndex(*indexFile, directory, index, version)) {
+        LOG(debug) << "Could not write the plugin index of " << directory;
+    }
+    return index;
+}
+} // namespace execHelper::plugins
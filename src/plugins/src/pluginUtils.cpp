@@ -1,8 +1,11 @@
 #include "pluginUtils.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -17,7 +20,10 @@
 #include "logger.h"
 #include "luaPlugin.h"
 #include "memory.h"
+#include "nativePlugins.h"
+#include "pluginIndex.h"
 #include "plugin.h"
+#include "sharedLibraryPlugin.h"
 
 using namespace std;
 namespace filesystem = std::filesystem;
@@ -33,12 +39,10 @@ using execHelper::config::PatternKeys;
 using execHelper::config::Patterns;
 using execHelper::config::PatternValue;
 using execHelper::config::PatternValues;
-using execHelper::config::SettingsKeys;
 using execHelper::config::VariablesMap;
 using execHelper::core::replacePatterns;
 using execHelper::core::Task;
 using execHelper::core::TaskCollection;
-using execHelper::plugins::PatternPermutator;
 
 namespace execHelper::plugins {
 auto getPatternsKey() noexcept -> const PatternKey& {
@@ -46,17 +50,55 @@ auto getPatternsKey() noexcept -> const PatternKey& {
     return key;
 }
 
-auto makePatternPermutator(const Patterns& patterns) noexcept
-    -> PatternPermutator {
-    std::map<PatternKey, PatternValues> patternValuesMap;
-    if(patterns.empty()) {
-        // If no patterns were given, iterate once
-        patternValuesMap.emplace("NO-KEY", PatternValues({"NO-VALUE"}));
-    }
+PatternPermutator::PatternPermutator(const Patterns& patterns)
+    : m_permutations(core::Permutations::Radices()) {
+    std::map<PatternKey, const PatternValues*> sortedPatterns;
     for(const auto& pattern : patterns) {
-        patternValuesMap.emplace(pattern.getKey(), pattern.getValues());
+        sortedPatterns.emplace(pattern.getKey(), &pattern.getValues());
+    }
+
+    core::Permutations::Radices radices;
+    m_keys.reserve(sortedPatterns.size());
+    m_values.reserve(sortedPatterns.size());
+    radices.reserve(sortedPatterns.size());
+    for(const auto& [key, values] : sortedPatterns) {
+        m_keys.push_back(key);
+        m_values.push_back(*values);
+        radices.push_back(values->size());
+    }
+    m_permutations = core::Permutations(move(radices));
+}
+
+auto PatternPermutator::size() const noexcept -> Index {
+    return m_permutations.size();
+}
+
+auto PatternPermutator::combination(Index index) const -> PatternCombinations {
+    core::Permutations::Combination indexes;
+    m_permutations.combination(index, &indexes);
+
+    PatternCombinations result;
+    for(size_t pattern = 0U; pattern < indexes.size(); ++pattern) {
+        result.emplace_hint(result.end(), m_keys[pattern],
+                            m_values[pattern][indexes[pattern]]);
     }
-    return plugins::PatternPermutator(patternValuesMap);
+    return result;
+}
+
+auto PatternPermutator::split(size_t nbOfRanges) const -> vector<Range> {
+    return m_permutations.split(nbOfRanges);
+}
+
+auto PatternPermutator::begin() const noexcept -> const_iterator {
+    return const_iterator(*this, 0U);
+}
+
+auto PatternPermutator::end() const noexcept -> const_iterator {
+    return const_iterator(*this, m_permutations.size());
+}
+
+auto makePatternPermutator(const Patterns& patterns) -> PatternPermutator {
+    return PatternPermutator(patterns);
 }
 
 auto replacePatternsInEnvironment(
@@ -83,6 +125,8 @@ auto replacePatternCombinations(
     const Task& task, const PatternCombinations& patternCombinations) noexcept
     -> Task {
     Task replacedTask;
+    replacedTask.setInheritedEnvironment(
+        task.getInheritedEnvironment()); // Patterns are only replaced in the variables set for the task itself
     replacedTask.setEnvironment(replacePatternsInEnvironment(
         task.getEnvironment(), patternCombinations));
 
@@ -111,11 +155,10 @@ auto replacePatternCombinations(
 auto getEnvironment(const VariablesMap& variables) noexcept
     -> EnvironmentCollection {
     EnvironmentCollection result;
-    SettingsKeys key({string(ENVIRONMENT_KEY)});
-    auto environmentOpt = variables.get<vector<string>>(key);
+    auto environmentOpt = variables.get<vector<string>>(ENVIRONMENT_KEY);
     for(auto variableName : environmentOpt.value_or(vector<string>())) {
         auto variableValueOpt =
-            variables.get<string>({string(ENVIRONMENT_KEY), variableName});
+            variables.get<string>({ENVIRONMENT_KEY, variableName});
         if(!variableValueOpt) {
             LOG(warning) << "Environment variable '" << variableName
                          << "' does not have an associated value. Ignoring it.";
@@ -144,25 +187,21 @@ auto toString(const PatternKeys& values) noexcept -> string {
 }
 
 namespace detail {
-auto discoverLuaPlugins(
-    const Paths& searchPaths,
-    const std::function<void(const filesystem::path& plugin)>&
+auto discoverPluginFiles(
+    const Paths& searchPaths, const optional<Path>& cacheDirectory,
+    string_view version,
+    const std::function<void(const PluginIndexEntry& plugin)>&
         callback) noexcept {
     /**
      * We search the searchpaths in reverse and overwrite plugins with the same name in later search paths
      */
-    LOG(debug) << "Discovering lua plugins...";
+    LOG(debug) << "Discovering lua and shared library plugins...";
     for(const auto& path : searchPaths) {
         LOG(trace) << "Discovering plugins for path " << path;
         try {
-            for(const auto& entry : filesystem::directory_iterator(path)) {
-                if(entry.is_regular_file() &&
-                   entry.path().extension() == ".lua") {
-                    LOG(trace) << "Module " << entry.path().stem()
-                               << " found at " << path;
-                    auto newId = entry.path().stem().string();
-                    callback(entry.path());
-                }
+            for(const auto& plugin :
+                getPlugins(path, cacheDirectory, version)) {
+                callback(plugin);
             }
         } catch(const filesystem::filesystem_error& e) {
             user_feedback_error("Failed to discover plugins for path "
@@ -172,34 +211,133 @@ auto discoverLuaPlugins(
         }
     }
 }
+
+/**
+ * \brief A path that is resolved once, when it is needed for the first time
+ */
+struct LazyPath {
+    std::once_flag resolved; //!< brief Whether the path is resolved
+    optional<Path> path;     //!< brief The resolved path
+};
+
+/**
+ * Returns the function that applies the given lua plugin. The chunk cache
+ * file of the plugin is only resolved when it is applied for the first time,
+ * so plugins that are not used cost no file system accesses.
+ *
+ * \param[in] script    The script of the lua plugin
+ * \param[in] cacheDirectory    The directory to cache the compiled plugin in
+ * \returns The function that applies the plugin
+ */
+auto makeLuaPlugin(const Path& script, const optional<Path>& cacheDirectory)
+    -> ApplyFunction {
+    if(!cacheDirectory) {
+        return [script](Task task, const VariablesMap& variables,
+                        const ExecutionContext& context) {
+            return luaPlugin(move(task), variables, context, script);
+        };
+    }
+
+    auto chunkCacheFile = make_shared<LazyPath>();
+    return [script, cacheDirectory = *cacheDirectory, chunkCacheFile](
+               Task task, const VariablesMap& variables,
+               const ExecutionContext& context) {
+        std::call_once(chunkCacheFile->resolved, [&]() {
+            chunkCacheFile->path = getLuaChunkCacheFile(script, cacheDirectory);
+        });
+        return luaPlugin(move(task), variables, context, script,
+                         chunkCacheFile->path);
+    };
+}
+
+/**
+ * \brief A shared library plugin that is loaded once, when it is needed for
+ * the first time
+ */
+struct LazyLibrary {
+    std::once_flag loaded;      //!< brief Whether the plugin is loaded
+    SharedLibraryPlugin plugin; //!< brief The loaded plugin
+};
+
+/**
+ * Returns the function that applies the given shared library plugin. The
+ * library is only loaded when the plugin is applied for the first time.
+ *
+ * \param[in] library   The shared library that implements the plugin
+ * \returns The function that applies the plugin
+ */
+auto makeSharedLibraryPlugin(const Path& library) -> ApplyFunction {
+    auto lazy = make_shared<LazyLibrary>();
+    return [library, lazy](Task task, const VariablesMap& variables,
+                           const ExecutionContext& context) {
+        // A library that fails to load is tried again on the next invocation
+        std::call_once(lazy->loaded, [&]() {
+            lazy->plugin = loadSharedLibraryPlugin(library);
+        });
+        return applySharedLibraryPlugin(*lazy->plugin, move(task), variables,
+                                        context);
+    };
+}
+
+/**
+ * Discovers the plugins in the given search paths and the native plugins.
+ * The native plugins are added after the lua plugins of the first search path,
+ * so they replace the lua plugins shipped with exec-helper, but not the ones
+ * in the other search paths.
+ *
+ * \param[in] searchPaths   The search paths from the lowest priority to the hightest
+ * \param[in] cacheDirectory    The directory the plugin indices are stored in
+ * \param[in] version   The version of the binary that uses the plugin indices
+ * \param[in] addPlugin Called for every plugin in the search paths
+ * \param[in] addNativePlugins  Called once to add the native plugins
+ */
+void discoverPlugins(
+    const Paths& searchPaths, const optional<Path>& cacheDirectory,
+    string_view version,
+    const std::function<void(const PluginIndexEntry& plugin)>& addPlugin,
+    const std::function<void()>& addNativePlugins) noexcept {
+    const auto shipped =
+        searchPaths.begin() + std::min<size_t>(searchPaths.size(), 1U);
+    discoverPluginFiles(Paths(searchPaths.begin(), shipped), cacheDirectory,
+                        version, addPlugin);
+    addNativePlugins();
+    discoverPluginFiles(Paths(shipped, searchPaths.end()), cacheDirectory,
+                        version, addPlugin);
+}
 } // namespace detail
 
 /**
- * Discover all compatible plugins in the given search paths. This function does *not* recursively seek in these paths.
+ * Discover all compatible plugins in the given search paths. This function does *not* recursively seek in these paths. Shared library plugins are only loaded when they are applied for the first time.
  *
- * \param[in] searchPaths   The search paths from the lowest priority to the hightest (collisions of plugins in later paths overwrite the ones from earlier ones)
+ * \param[in] searchPaths   The search paths from the lowest priority to the hightest (collisions of plugins in later paths overwrite the ones from earlier ones). The first search path contains the plugins shipped with exec-helper: its lua plugins with a native implementation are replaced by the native one.
+ * \param[in] cacheDirectory    The directory to store the plugin index of every search path and the compiled lua plugins in. The search paths are listed and the plugins are only cached for the current run if it is not given.
+ * \param[in] version   The version of the binary. Plugin indices written by another version are not used.
  * \returns     A mapping of the discovered plugins
  */
-auto discoverPlugins(const Paths& searchPaths) noexcept -> Plugins {
+auto discoverPlugins(const Paths& searchPaths,
+                     const optional<Path>& cacheDirectory,
+                     string_view version) noexcept -> Plugins {
     Plugins plugins{{"command-line-command", &commandLineCommand}};
 
     /**
      * We search the searchpaths in reverse and overwrite plugins with the same name in later search paths
      */
     LOG(debug) << "Discovering plugins...";
-    detail::discoverLuaPlugins(
-        searchPaths, [&plugins](const filesystem::path& path) {
-            LOG(trace) << "Module " << path.stem() << " found at " << path;
-            auto newId = path.stem().string();
-            auto plugin = [path](Task task, const VariablesMap& variables,
-                                 const ExecutionContext& context) {
-                return luaPlugin(move(task), variables, context, path);
-            };
-
-            if(!plugins.contains(newId)) {
-                plugins.try_emplace(newId, plugin);
-            } else {
-                plugins[newId] = plugin;
+    detail::discoverPlugins(
+        searchPaths, cacheDirectory, version,
+        [&plugins, &cacheDirectory](const PluginIndexEntry& plugin) {
+            if(plugin.path.extension() == SHARED_LIBRARY_PLUGIN_EXTENSION) {
+                plugins.insert_or_assign(
+                    plugin.name, detail::makeSharedLibraryPlugin(plugin.path));
+                return;
+            }
+            plugins.insert_or_assign(
+                plugin.name,
+                detail::makeLuaPlugin(plugin.path, cacheDirectory));
+        },
+        [&plugins]() {
+            for(const auto& [name, plugin] : getNativePlugins()) {
+                plugins.insert_or_assign(name, plugin);
             }
         });
     return plugins;
@@ -208,25 +346,28 @@ auto discoverPlugins(const Paths& searchPaths) noexcept -> Plugins {
 /**
  * Discover all compatible plugins in the given search paths. This function does *not* recursively seek in these paths.
  *
- * \param[in] searchPaths   The search paths from the lowest priority to the hightest (collisions of plugins in later paths overwrite the ones from earlier ones)
+ * \param[in] searchPaths   The search paths from the lowest priority to the hightest (collisions of plugins in later paths overwrite the ones from earlier ones). The first search path contains the plugins shipped with exec-helper: its lua plugins with a native implementation are replaced by the native one.
+ * \param[in] cacheDirectory    The directory to store the plugin index of every search path in. The search paths are listed if it is not given.
+ * \param[in] version   The version of the binary. Plugin indices written by another version are not used.
  * \returns     A mapping of the discovered plugins to their summary
  */
-auto discoverPluginSummaries(const Paths& searchPaths) noexcept
-    -> PluginSummaries {
+auto discoverPluginSummaries(const Paths& searchPaths,
+                             const optional<Path>& cacheDirectory,
+                             string_view version) noexcept -> PluginSummaries {
     PluginSummaries plugins{
         {"command-line-command", string(commandLineCommandSummary())}};
 
-    detail::discoverLuaPlugins(searchPaths,
-                               [&plugins](const filesystem::path& path) {
-                                   auto newId = path.stem().string();
-                                   auto summary = luaPluginSummary(path);
-
-                                   if(!plugins.contains(newId)) {
-                                       plugins.try_emplace(newId, summary);
-                                   } else {
-                                       plugins[newId] = summary;
-                                   }
-                               });
+    detail::discoverPlugins(
+        searchPaths, cacheDirectory, version,
+        [&plugins](const PluginIndexEntry& plugin) {
+            plugins.insert_or_assign(plugin.name, plugin.summary);
+        },
+        [&plugins]() {
+            for(const auto& plugin : getNativePlugins()) {
+                plugins.insert_or_assign(plugin.first,
+                                         nativePluginSummary(plugin.first));
+            }
+        });
     return plugins;
 }
 } // namespace execHelper::plugins
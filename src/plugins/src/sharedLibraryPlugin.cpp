@@ -0,0 +1,365 @@
+#include "sharedLibraryPlugin.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+#include "config/commandLineOptions.h"
+#include "config/variablesMap.h"
+#include "core/task.h"
+
+#include "addEnvironment.h"
+#include "executePlugin.h"
+#include "executionContext.h"
+#include "logger.h"
+#include "workingDirectory.h"
+
+using std::ifstream;
+using std::list;
+using std::move;
+using std::runtime_error;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+using execHelper::config::CommandCollection;
+using execHelper::config::JOBS_KEY;
+using execHelper::config::Jobs_t;
+using execHelper::config::SettingsKeys;
+using execHelper::config::VariablesMap;
+using execHelper::config::VERBOSE_KEY;
+using execHelper::core::Task;
+using execHelper::core::Tasks;
+using execHelper::plugins::ExecutionContext;
+
+namespace filesystem = std::filesystem;
+
+/**
+ * \brief The state of an invocation of a shared library plugin
+ */
+struct exec_helper_invocation {
+    const VariablesMap& config;       //!< brief The plugin configuration
+    const ExecutionContext& context;  //!< brief The invocation context
+    vector<Task> tasks;               //!< brief The tasks of the plugin
+    Tasks registered;                 //!< brief The registered tasks
+    list<vector<string>> values;      //!< brief The values handed out
+    list<vector<const char*>> arrays; //!< brief The arrays handed out
+    string error;                     //!< brief Why the invocation failed
+};
+
+/*
+ * The functions offered to the plugins must not let exceptions escape into
+ * the plugin.
+ */
+namespace {
+const int SUCCESS = 0;
+const int FAILURE = 1;
+
+/**
+ * Returns the given task of the given invocation
+ *
+ * \param[in] invocation    The invocation
+ * \param[in] task  The task to return
+ * \returns The task
+ *          nullptr if the task does not exist
+ */
+auto getTask(exec_helper_invocation* invocation, exec_helper_task task) noexcept
+    -> Task* {
+    if(invocation == nullptr || task >= invocation->tasks.size()) {
+        return nullptr;
+    }
+    return &invocation->tasks[task];
+}
+
+auto getValues(exec_helper_invocation* invocation, const char* const* key,
+               size_t depth, size_t* count) noexcept -> const char* const* {
+    if(invocation == nullptr || count == nullptr ||
+       (key == nullptr && depth > 0U)) {
+        return nullptr;
+    }
+
+    try {
+        SettingsKeys keys;
+        keys.reserve(depth);
+        for(size_t i = 0U; i < depth; ++i) {
+            keys.emplace_back(key[i]);
+        }
+        auto values = invocation->config.get<vector<string>>(keys);
+        if(!values) {
+            return nullptr;
+        }
+
+        const auto& stored = invocation->values.emplace_back(move(*values));
+        auto& array = invocation->arrays.emplace_back();
+        array.reserve(stored.size() + 1U);
+        std::transform(stored.begin(), stored.end(), std::back_inserter(array),
+                       [](const auto& value) { return value.c_str(); });
+        array.push_back(nullptr);
+        *count = stored.size();
+        return array.data();
+    } catch(const std::exception& e) {
+        LOG(error) << "Could not get the values of a key: " << e.what();
+        return nullptr;
+    }
+}
+
+auto isVerbose(exec_helper_invocation* invocation) noexcept -> int {
+    if(invocation == nullptr) {
+        return 0;
+    }
+    return invocation->config.get<bool>(
+               VERBOSE_KEY, invocation->context.options().getVerbosity())
+               ? 1
+               : 0;
+}
+
+auto getJobs(exec_helper_invocation* invocation) noexcept -> uint32_t {
+    if(invocation == nullptr) {
+        return 1U;
+    }
+    return invocation->config.get<Jobs_t>(
+        JOBS_KEY, invocation->context.options().getJobs());
+}
+
+auto copyTask(exec_helper_invocation* invocation,
+              exec_helper_task task) noexcept -> exec_helper_task {
+    const auto* original = getTask(invocation, task);
+    if(original == nullptr) {
+        return EXEC_HELPER_INVALID_TASK;
+    }
+
+    try {
+        Task copy = *original;
+        invocation->tasks.push_back(move(copy));
+        return invocation->tasks.size() - 1U;
+    } catch(const std::exception& e) {
+        LOG(error) << "Could not copy a task: " << e.what();
+        return EXEC_HELPER_INVALID_TASK;
+    }
+}
+
+auto appendArgument(exec_helper_invocation* invocation, exec_helper_task task,
+                    const char* argument) noexcept -> int {
+    auto* toAppendTo = getTask(invocation, task);
+    if(toAppendTo == nullptr || argument == nullptr) {
+        return FAILURE;
+    }
+    return toAppendTo->append(string(argument)) ? SUCCESS : FAILURE;
+}
+
+auto setEnvironment(exec_helper_invocation* invocation, exec_helper_task task,
+                    const char* name, const char* value) noexcept -> int {
+    auto* toChange = getTask(invocation, task);
+    if(toChange == nullptr || name == nullptr || value == nullptr) {
+        return FAILURE;
+    }
+    return toChange->appendToEnvironment(std::make_pair(name, value))
+               ? SUCCESS
+               : FAILURE;
+}
+
+auto setWorkingDirectory(exec_helper_invocation* invocation,
+                         exec_helper_task task, const char* directory) noexcept
+    -> int {
+    auto* toChange = getTask(invocation, task);
+    if(toChange == nullptr || directory == nullptr) {
+        return FAILURE;
+    }
+    toChange->setWorkingDirectory(directory);
+    return SUCCESS;
+}
+
+auto registerTask(exec_helper_invocation* invocation,
+                  exec_helper_task task) noexcept -> int {
+    const auto* toRegister = getTask(invocation, task);
+    if(toRegister == nullptr) {
+        return FAILURE;
+    }
+
+    try {
+        const auto& sink = invocation->context.sink();
+        if(sink) {
+            sink(*toRegister);
+        } else {
+            invocation->registered.push_back(*toRegister);
+        }
+        return SUCCESS;
+    } catch(const std::exception& e) {
+        invocation->error = e.what();
+        return FAILURE;
+    }
+}
+
+auto resolveTargets(exec_helper_invocation* invocation, exec_helper_task task,
+                    const char* const* targets, size_t count) noexcept -> int {
+    const auto* base = getTask(invocation, task);
+    if(base == nullptr || (targets == nullptr && count > 0U)) {
+        return FAILURE;
+    }
+
+    try {
+        auto tasks = execHelper::plugins::runTargets(
+            *base, CommandCollection(targets, targets + count),
+            invocation->context);
+        std::move(tasks.begin(), tasks.end(),
+                  std::back_inserter(invocation->registered));
+        return SUCCESS;
+    } catch(const std::exception& e) {
+        invocation->error = e.what();
+        return FAILURE;
+    }
+}
+
+void reportError(exec_helper_invocation* invocation,
+                 const char* message) noexcept {
+    if(invocation == nullptr || message == nullptr) {
+        return;
+    }
+
+    try {
+        invocation->error = message;
+    } catch(const std::exception& e) {
+        LOG(error) << "Could not store the error of a plugin: " << e.what();
+    }
+}
+
+/**
+ * Returns the functions offered to the plugins
+ *
+ * \returns The functions
+ */
+auto getHost() noexcept -> const exec_helper_host& {
+    static const exec_helper_host host{
+        EXEC_HELPER_PLUGIN_ABI_VERSION, &getValues, &isVerbose, &getJobs,
+        &copyTask, &appendArgument, &setEnvironment, &setWorkingDirectory,
+        &registerTask, &resolveTargets, &reportError};
+    return host;
+}
+
+/**
+ * Loads the given shared library
+ *
+ * \param[in] library   The shared library to load
+ * \returns The handle of the library, which unloads the library when it is
+ * released
+ * \throws std::runtime_error   If the library can not be loaded
+ */
+auto openLibrary(const filesystem::path& library) -> shared_ptr<void> {
+#ifdef _WIN32
+    auto* handle = LoadLibraryW(library.c_str());
+    if(handle == nullptr) {
+        throw runtime_error("Could not load shared library plugin '" +
+                            library.string() + "'");
+    }
+    return shared_ptr<void>(handle, [](void* toClose) {
+        FreeLibrary(static_cast<HMODULE>(toClose));
+    });
+#else
+    auto* handle = dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if(handle == nullptr) {
+        const auto* reason = dlerror();
+        throw runtime_error("Could not load shared library plugin '" +
+                            library.string() +
+                            "': " + (reason != nullptr ? reason : "unknown"));
+    }
+    return shared_ptr<void>(handle, [](void* toClose) { dlclose(toClose); });
+#endif
+}
+
+/**
+ * Returns the entry point of the given shared library
+ *
+ * \param[in] library   The handle of the shared library
+ * \returns The entry point
+ *          nullptr if the library does not export it
+ */
+auto getEntryPoint(const shared_ptr<void>& library) noexcept
+    -> exec_helper_plugin_entry_point {
+#ifdef _WIN32
+    auto* symbol = GetProcAddress(static_cast<HMODULE>(library.get()),
+                                  EXEC_HELPER_PLUGIN_ENTRY_POINT);
+#else
+    auto* symbol = dlsym(library.get(), EXEC_HELPER_PLUGIN_ENTRY_POINT);
+#endif
+    exec_helper_plugin_entry_point entryPoint = nullptr;
+    static_assert(sizeof(entryPoint) == sizeof(symbol));
+    std::memcpy(&entryPoint, &symbol, sizeof(entryPoint));
+    return entryPoint;
+}
+} // namespace
+
+namespace execHelper::plugins {
+auto loadSharedLibraryPlugin(const filesystem::path& library)
+    -> SharedLibraryPlugin {
+    auto handle = openLibrary(library);
+    auto entryPoint = getEntryPoint(handle);
+    if(entryPoint == nullptr) {
+        throw runtime_error("Shared library plugin '" + library.string() +
+                            "' does not export " +
+                            EXEC_HELPER_PLUGIN_ENTRY_POINT);
+    }
+
+    const auto* plugin = entryPoint();
+    if(plugin == nullptr || plugin->apply == nullptr) {
+        throw runtime_error("Shared library plugin '" + library.string() +
+                            "' can not be used");
+    }
+    if(plugin->abi_version != EXEC_HELPER_PLUGIN_ABI_VERSION) {
+        throw runtime_error(
+            "Shared library plugin '" + library.string() +
+            "' is built for version " + std::to_string(plugin->abi_version) +
+            " of the plugin interface instead of version " +
+            std::to_string(EXEC_HELPER_PLUGIN_ABI_VERSION));
+    }
+
+    // The plugin keeps the library loaded
+    return SharedLibraryPlugin(move(handle), plugin);
+}
+
+auto sharedLibraryPluginSummary(const filesystem::path& library) noexcept
+    -> string {
+    try {
+        auto summaryFile = library;
+        summaryFile.replace_extension(SHARED_LIBRARY_PLUGIN_SUMMARY_EXTENSION);
+        ifstream stream(summaryFile);
+        string summary;
+        if(getline(stream, summary) && !summary.empty()) {
+            return summary;
+        }
+        return "Shared library plugin for module " + library.stem().string();
+    } catch(const std::exception& e) {
+        LOG(warning) << "Could not read the summary of " << library << ": "
+                     << e.what();
+        return {};
+    }
+}
+
+auto applySharedLibraryPlugin(const exec_helper_plugin& plugin, Task task,
+                              const VariablesMap& config,
+                              const ExecutionContext& context) -> Tasks {
+    WorkingDirectory::apply(task, config);
+    AddEnvironment::apply(task, config);
+
+    exec_helper_invocation invocation{config, context, {move(task)}, {},
+                                      {},     {},      {}};
+    if(plugin.apply(&getHost(), &invocation) != SUCCESS) {
+        if(invocation.error.empty()) {
+            invocation.error = "Shared library plugin failed";
+        }
+        LOG(error) << invocation.error;
+        throw runtime_error(invocation.error);
+    }
+    return move(invocation.registered);
+}
+} // namespace execHelper::plugins
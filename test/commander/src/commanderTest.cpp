@@ -1,8 +1,11 @@
 #include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string_view>
+#include <thread>
 #include <vector>
 
 #include "commander/commander.h"
@@ -11,6 +14,8 @@
 #include "config/pattern.h"
 #include "config/settingsNode.h"
 #include "config/variablesMap.h"
+#include "core/parallelExecutor.h"
+#include "core/shell.h"
 #include "log/log.h"
 #include "plugins/pluginUtils.h"
 
@@ -32,7 +37,11 @@ using execHelper::config::Patterns;
 using execHelper::config::SettingsKeys;
 using execHelper::config::SettingsNode;
 using execHelper::config::VariablesMap;
+using execHelper::core::CyclicDependencyError;
+using execHelper::core::ParallelExecutor;
+using execHelper::core::Shell;
 using execHelper::core::Task;
+using execHelper::core::TaskGraph;
 using execHelper::core::Tasks;
 using execHelper::plugins::getPatternsKey;
 using execHelper::plugins::Plugins;
@@ -51,6 +60,62 @@ using namespace std::literals;
 
 constexpr string_view COMMANDS_KEY = "commands"sv;
 constexpr string_view MEMORY_KEY = "memory"sv;
+constexpr string_view DEPENDS_ON_KEY = "depends-on"sv;
+
+/**
+ * Register the given values as plugins that each return a task containing their own name
+ */
+auto mapToNamedTasks(const vector<string>& values) noexcept -> Plugins {
+    Plugins plugins;
+    for(const auto& value : values) {
+        plugins.emplace(
+            value,
+            [value](Task task,
+                    [[maybe_unused]] const VariablesMap& variablesMap,
+                    [[maybe_unused]] const execHelper::plugins::ExecutionContext&
+                        context) noexcept -> Tasks {
+                task.append(value);
+                return {task};
+            });
+    }
+    return plugins;
+}
+
+/**
+ * \brief Shell that records the tasks in the order in which they finished.
+ * Earlier executed tasks take longer to finish.
+ */
+class FinishOrderShellStub final : public Shell {
+  public:
+    auto execute(const Task& task) const noexcept -> ShellReturnCode override {
+        size_t started = 0U;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            started = m_started++;
+        }
+        std::this_thread::sleep_for(
+            std::chrono::milliseconds(started < 5U ? 5U - started : 0U));
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_finishedTasks.push_back(task);
+        return 0U;
+    }
+
+    auto isExecutedSuccessfully(ShellReturnCode returnCode) const noexcept
+        -> bool override {
+        return returnCode == 0U;
+    }
+
+    auto getFinishedTasks() const noexcept -> Tasks {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_finishedTasks;
+    }
+
+  private:
+    mutable std::mutex m_mutex;
+    mutable size_t m_started{0U};
+    mutable Tasks m_finishedTasks;
+};
 } // namespace
 
 namespace execHelper::commander::test {
@@ -90,7 +155,7 @@ SCENARIO("Basic test the commander", "[commander]") {
                     Plugins{plugins}, rootDirectory);
 
                 THEN_CHECK("The expected tasks are executed") {
-                    REQUIRE(expectedTasks == actualTasks);
+                    REQUIRE(expectedTasks == actualTasks.getTasks());
                 }
             }
         });
@@ -128,6 +193,170 @@ SCENARIO(
     }
 }
 
+SCENARIO("Test the dependencies between commands", "[commander]") {
+    GIVEN("A configuration where some commands depend on another one") {
+        const string build("build");
+        const string test("test");
+        const string lint("lint");
+        const string docs("docs");
+
+        SettingsNode settings("test");
+        REQUIRE(settings.add(string(COMMANDS_KEY),
+                             vector<string>({build, test, lint, docs})));
+        REQUIRE(settings.add({string(DEPENDS_ON_KEY), test}, build));
+        REQUIRE(settings.add({string(DEPENDS_ON_KEY), lint}, build));
+
+        FleetingOptionsStub fleetingOptions;
+        Commander commander;
+
+        WHEN("We run the commander for the dependent commands only") {
+            fleetingOptions.m_commands = {test, docs, lint};
+
+            auto graph = commander.run(
+                fleetingOptions, settings, Patterns(),
+                filesystem::current_path(), EnvironmentCollection(),
+                mapToNamedTasks({build, test, lint, docs}),
+                filesystem::current_path());
+
+            THEN("The command they depend on is executed once and first") {
+                REQUIRE(graph.size() == 4U);
+
+                const auto stages = graph.getStages();
+                REQUIRE(stages.size() == 2U);
+
+                vector<string> firstStage;
+                for(const auto node : stages.front()) {
+                    firstStage.push_back(graph.getName(node));
+                }
+                REQUIRE(firstStage == vector<string>({build, docs}));
+
+                vector<string> secondStage;
+                for(const auto node : stages.back()) {
+                    secondStage.push_back(graph.getName(node));
+                }
+                REQUIRE(secondStage == vector<string>({test, lint}));
+            }
+
+            THEN("Every command resolved to its own tasks") {
+                REQUIRE(graph.getTasks() ==
+                        Tasks({Task({build}), Task({docs}), Task({test}),
+                               Task({lint})}));
+            }
+        }
+
+        WHEN("The dependencies form a cycle") {
+            REQUIRE(settings.add({string(DEPENDS_ON_KEY), build}, lint));
+            fleetingOptions.m_commands = {test};
+
+            THEN("It should fail before resolving any command") {
+                REQUIRE_THROWS_AS(
+                    commander.run(fleetingOptions, settings, Patterns(),
+                                  filesystem::current_path(),
+                                  EnvironmentCollection(), Plugins(),
+                                  filesystem::current_path()),
+                    CyclicDependencyError);
+            }
+        }
+    }
+}
+
+SCENARIO("Test streaming the resolved tasks to an executor", "[commander]") {
+    GIVEN("A commander and a configuration with multiple commands") {
+        const string first("first");
+        const string second("second");
+
+        SettingsNode settings("test");
+        REQUIRE(settings.add(string(COMMANDS_KEY),
+                             vector<string>({first, second})));
+
+        FleetingOptionsStub fleetingOptions;
+        fleetingOptions.m_commands = {first, second};
+
+        ExecutorStub executor;
+        size_t executedBeforeSecond = 0U;
+
+        auto plugins = mapToNamedTasks({first});
+        plugins.emplace(
+            second,
+            [&executor, &executedBeforeSecond, &second](
+                Task task, [[maybe_unused]] const VariablesMap& variablesMap,
+                [[maybe_unused]] const execHelper::plugins::ExecutionContext&
+                    context) noexcept -> Tasks {
+                executedBeforeSecond = executor.getExecutedTasks().size();
+                task.append(second);
+                return {task};
+            });
+
+        Commander commander;
+
+        WHEN("We execute the commands") {
+            commander.execute(fleetingOptions, settings, Patterns(),
+                              filesystem::current_path(),
+                              EnvironmentCollection(), move(plugins),
+                              filesystem::current_path(), executor);
+
+            THEN("The task of the first command is executed before the "
+                 "second command is resolved") {
+                REQUIRE(executedBeforeSecond == 1U);
+            }
+
+            THEN("All tasks are executed in order") {
+                REQUIRE(executor.getExecutedTasks() ==
+                        ExecutorStub::TaskQueue({Task({first}), Task({second})}));
+            }
+        }
+    }
+}
+
+SCENARIO("Test the order of the tasks of commands without dependencies",
+         "[commander]") {
+    GIVEN("A multi-step command and a command without depends-on relations") {
+        const string steps("steps");
+        const string last("last");
+        const Tasks expectedTasks({Task({steps, "1"}), Task({steps, "2"}),
+                                   Task({steps, "3"}), Task({last})});
+
+        SettingsNode settings("test");
+        REQUIRE(
+            settings.add(string(COMMANDS_KEY), vector<string>({steps, last})));
+
+        FleetingOptionsStub fleetingOptions;
+        fleetingOptions.m_commands = {steps, last};
+        fleetingOptions.m_jobs = 4U;
+
+        auto plugins = mapToNamedTasks({last});
+        plugins.emplace(
+            steps,
+            [&expectedTasks](
+                [[maybe_unused]] Task task,
+                [[maybe_unused]] const VariablesMap& variablesMap,
+                [[maybe_unused]] const execHelper::plugins::ExecutionContext&
+                    context) noexcept -> Tasks {
+                return Tasks(expectedTasks.begin(), expectedTasks.end() - 1);
+            });
+
+        FinishOrderShellStub shell;
+        Commander commander;
+
+        WHEN("We execute the commands with multiple jobs") {
+            {
+                ParallelExecutor executor(
+                    shell,
+                    []([[maybe_unused]] Shell::ShellReturnCode returnCode) {},
+                    fleetingOptions.m_jobs, false);
+                commander.execute(fleetingOptions, settings, Patterns(),
+                                  filesystem::current_path(),
+                                  EnvironmentCollection(), move(plugins),
+                                  filesystem::current_path(), executor);
+            }
+
+            THEN("The tasks are executed one after the other in order") {
+                REQUIRE(shell.getFinishedTasks() == expectedTasks);
+            }
+        }
+    }
+}
+
 SCENARIO("Test when no commands are passed", "[commander]") {
     GIVEN("A fully configured commander and no command set") {
         string command1("command1");
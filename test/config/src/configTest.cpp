@@ -1,10 +1,13 @@
 #include <algorithm>
+#include <filesystem>
 #include <string>
 
 #include "config/config.h"
 #include "config/pattern.h"
+#include "config/settingsCache.h"
 
 #include "base-utils/configFileWriter.h"
+#include "base-utils/tmpFile.h"
 #include "unittest/catch.h"
 #include "utils/utils.h"
 
@@ -12,9 +15,12 @@ using std::find;
 using std::string;
 using std::to_string;
 
+namespace filesystem = std::filesystem;
+
 using execHelper::config::SettingsNode;
 
 using execHelper::test::baseUtils::ConfigFileWriter;
+using execHelper::test::baseUtils::TmpFile;
 using execHelper::test::utils::writeSettingsFile;
 
 namespace execHelper::config::test {
@@ -120,4 +126,122 @@ SCENARIO("Parse properly written settings files", "[config][config-config]") {
         }
     }
 }
+
+SCENARIO("Include other settings files", "[config][config-config]") {
+    GIVEN("A settings file that includes two other settings files") {
+        TmpFile firstFile;
+        REQUIRE(firstFile.create("commands:\n"
+                                 "  build: Build it\n"
+                                 "build:\n"
+                                 "  - make\n"
+                                 "patterns:\n"
+                                 "  MODE:\n"
+                                 "    default-values: [debug]\n"));
+        TmpFile secondFile;
+        REQUIRE(secondFile.create("commands:\n"
+                                  "  run: Run it\n"
+                                  "run:\n"
+                                  "  - command-line-command\n"
+                                  "patterns:\n"
+                                  "  MODE:\n"
+                                  "    default-values: [release]\n"));
+        TmpFile settingsFile;
+        REQUIRE(settingsFile.create("include: [" + firstFile.getFilename() +
+                                    ", " + secondFile.getFilename() +
+                                    "]\n"
+                                    "commands:\n"
+                                    "  test: Test it\n"
+                                    "build:\n"
+                                    "  - ninja\n"));
+
+        SettingsNode expected("exec-helper");
+        REQUIRE(expected.add({"commands", "build"}, "Build it"));
+        REQUIRE(expected.add({"commands", "run"}, "Run it"));
+        REQUIRE(expected.add({"commands", "test"}, "Test it"));
+        REQUIRE(expected.add("build", "ninja"));
+        REQUIRE(expected.add("run", "command-line-command"));
+
+        WHEN("We parse the settings file") {
+            auto parsed = parseSettingsFile(settingsFile.getPath());
+
+            THEN("It must succeed") { REQUIRE(parsed); }
+
+            THEN("We must find the merged settings") {
+                REQUIRE(parsed->second == expected);
+            }
+
+            THEN("The patterns of later files must replace earlier ones") {
+                REQUIRE(parsed->first.size() == 1U);
+                REQUIRE(parsed->first.front().getKey() == "MODE");
+                REQUIRE(parsed->first.front().getValues() ==
+                        PatternValues({"release"}));
+            }
+        }
+
+        WHEN("We parse the settings file using the cache") {
+            TmpFile cacheDirectory;
+            REQUIRE(filesystem::create_directories(cacheDirectory.getPath()));
+            const auto cacheFile = cacheDirectory.getPath() / "settings.cache";
+
+            auto parsed =
+                parseSettingsFile(settingsFile.getPath(), cacheFile, "1.0.0");
+            REQUIRE(parsed);
+
+            THEN("Every included file must be cached separately") {
+                for(const auto& file : {firstFile.getPath(),
+                                        secondFile.getPath()}) {
+                    auto includeCacheFile =
+                        getSettingsCacheFileIn(file, cacheDirectory.getPath());
+                    REQUIRE(includeCacheFile);
+                    REQUIRE(filesystem::exists(*includeCacheFile));
+                }
+            }
+
+            THEN("Changes to an included file must be picked up") {
+                REQUIRE(secondFile.create("commands:\n"
+                                          "  run: Run it again\n"
+                                          "run:\n"
+                                          "  - command-line-command\n"));
+                auto reparsed = parseSettingsFile(settingsFile.getPath(),
+                                                  cacheFile, "1.0.0");
+                REQUIRE(reparsed);
+                REQUIRE(reparsed->second.get<SettingsValues>(
+                            {"commands", "run"}) ==
+                        SettingsValues({"Run it again"}));
+                REQUIRE(reparsed->first.size() == 1U);
+                REQUIRE(reparsed->first.front().getValues() ==
+                        PatternValues({"debug"}));
+            }
+
+            filesystem::remove_all(cacheDirectory.getPath());
+        }
+    }
+
+    GIVEN("Settings files that include each other") {
+        TmpFile firstFile;
+        TmpFile secondFile;
+        REQUIRE(firstFile.create("include: " + secondFile.getFilename() +
+                                 "\ncommands: [build]\n"));
+        REQUIRE(secondFile.create("include: " + firstFile.getFilename() +
+                                  "\ncommands: [run]\n"));
+
+        WHEN("We parse one of them") {
+            auto parsed = parseSettingsFile(firstFile.getPath());
+
+            THEN("It must fail") { REQUIRE_FALSE(parsed); }
+        }
+    }
+
+    GIVEN("A settings file that includes a file that does not exist") {
+        TmpFile settingsFile;
+        REQUIRE(settingsFile.create("include: [does-not-exist.yml]\n"
+                                    "commands: [build]\n"));
+
+        WHEN("We parse it") {
+            auto parsed = parseSettingsFile(settingsFile.getPath());
+
+            THEN("It must fail") { REQUIRE_FALSE(parsed); }
+        }
+    }
+}
 } // namespace execHelper::config::test
@@ -52,12 +52,14 @@ SCENARIO("Test the fleeting options defaults", "[config][fleeting-options]") {
         REQUIRE(expectedDefaults.add(JOBS_KEY, "auto"));
         REQUIRE(expectedDefaults.add(DRY_RUN_KEY, "no"));
         REQUIRE(expectedDefaults.add(KEEP_GOING_KEY, "no"));
+        REQUIRE(expectedDefaults.add(POSIX_SPAWN_KEY, "no"));
         REQUIRE(expectedDefaults.add(LOG_LEVEL_KEY, "none"));
         REQUIRE(expectedDefaults.add(LIST_PLUGINS_KEY, "no"));
         REQUIRE(expectedDefaults.add(APPEND_SEARCH_PATH_KEY,
                                      AppendSearchPathOption_t()));
         REQUIRE(expectedDefaults.add(COMMAND_KEY, CommandCollection()));
         REQUIRE(expectedDefaults.add(SETTINGS_FILE_KEY));
+        REQUIRE(expectedDefaults.add(NO_SETTINGS_CACHE_KEY, "no"));
 
         WHEN("We request the defaults") {
             VariablesMap defaults = FleetingOptions::getDefault();
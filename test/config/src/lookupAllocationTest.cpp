@@ -0,0 +1,124 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "config/pattern.h"
+#include "config/patternsHandler.h"
+#include "config/settingsNode.h"
+#include "config/variablesMap.h"
+
+#include "unittest/catch.h"
+
+using std::atomic;
+using std::optional;
+using std::size_t;
+using std::string;
+using std::string_view;
+
+namespace {
+atomic<size_t> // NOLINT(fuchsia-statically-constructed-objects)
+    allocations{0U};
+
+/**
+ * Returns the number of heap allocations made by calling the given function
+ */
+template <typename F> auto countAllocations(F function) -> size_t {
+    const auto before = allocations.load();
+    function();
+    return allocations.load() - before;
+}
+} // namespace
+
+// Count every allocation of the test executable. The array forms are
+// replaced as well, so every new and delete pair ends up in malloc and free.
+auto operator new(size_t size) -> void* {
+    ++allocations;
+    if(void* memory = std::malloc(size == 0U ? 1U : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+auto operator new[](size_t size) -> void* { return operator new(size); }
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+
+void operator delete(void* memory, size_t /*size*/) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept { std::free(memory); }
+
+void operator delete[](void* memory, size_t /*size*/) noexcept {
+    std::free(memory);
+}
+
+namespace execHelper::config::test {
+SCENARIO("Looking up existing keys does not allocate",
+         "[config][settingsNode][patternsHandler]") {
+    GIVEN("Settings and patterns with keys that do not fit in a small string") {
+        constexpr string_view commandKey("a-command-with-a-long-name");
+        constexpr string_view flagKey("a-flag-with-a-rather-long-name");
+        constexpr string_view jobsKey("the-number-of-jobs-to-use");
+        constexpr string_view patternKey("A_PATTERN_WITH_A_LONG_NAME");
+
+        VariablesMap variables("variables-map");
+        REQUIRE(variables.add({string(commandKey), string(flagKey)}, "yes"));
+        REQUIRE(variables.add({string(commandKey), string(jobsKey)}, "8"));
+        REQUIRE(variables.add(
+            string(patternKey),
+            "a value that is too long for the small string buffer"));
+        const auto& settings = variables;
+
+        const PatternsHandler patterns(
+            {Pattern(string(patternKey), {"value"})});
+
+        WHEN("We look up the keys") {
+            bool containsCommand = false;
+            bool containsFlag = false;
+            bool containsUnknown = true;
+            optional<bool> flag;
+            optional<uint32_t> jobs;
+            optional<string_view> value;
+            const SettingsNode* command = nullptr;
+            bool containsPattern = false;
+            const Pattern* pattern = nullptr;
+
+            // Values are converted on their first lookup only
+            REQUIRE(settings.get<bool>({commandKey, flagKey}));
+            REQUIRE(settings.get<uint32_t>({commandKey, jobsKey}));
+            REQUIRE(settings.get<string_view>(patternKey));
+
+            const auto count = countAllocations([&]() {
+                containsCommand = settings.contains(commandKey);
+                containsFlag = settings.contains({commandKey, flagKey});
+                containsUnknown = settings.contains({commandKey, patternKey});
+                command = &settings[commandKey];
+                flag = command->get<bool>(flagKey);
+                jobs = settings.get<uint32_t>({commandKey, jobsKey});
+                value = settings.get<string_view>(patternKey);
+                containsPattern = patterns.contains(patternKey);
+                pattern = &patterns.getPattern(patternKey);
+            });
+
+            THEN("No memory must have been allocated") { REQUIRE(count == 0U); }
+
+            THEN("We must find the values associated with the keys") {
+                REQUIRE(containsCommand);
+                REQUIRE(containsFlag);
+                REQUIRE_FALSE(containsUnknown);
+                REQUIRE(command->key() == commandKey);
+                REQUIRE(flag == true);
+                REQUIRE(jobs == 8U);
+                REQUIRE(value ==
+                        "a value that is too long for the small string buffer");
+                REQUIRE(containsPattern);
+                REQUIRE(pattern->getKey() == patternKey);
+            }
+        }
+    }
+}
+} // namespace execHelper::config::test
@@ -0,0 +1,157 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "config/commandLine.h"
+#include "config/optionDescriptions.h"
+#include "config/variablesMap.h"
+
+#include "unittest/catch.h"
+
+using std::string;
+using std::vector;
+
+namespace {
+/**
+ * Returns the command line for the given arguments, preceded by the name of
+ * the binary. The arguments must outlive the command line.
+ */
+auto toArgs(const vector<string>& arguments) -> vector<const char*> {
+    vector<const char*> args({"exec-helper"});
+    for(const auto& argument : arguments) {
+        args.push_back(argument.c_str());
+    }
+    return args;
+}
+
+/**
+ * Joins the given arguments using spaces
+ */
+auto join(const vector<string>& arguments) -> string {
+    string result;
+    for(const auto& argument : arguments) {
+        result.append(result.empty() ? "" : " ").append(argument);
+    }
+    return result;
+}
+} // namespace
+
+namespace execHelper::config::test {
+SCENARIO("Parse the command line using the option descriptions",
+         "[config][option-descriptions]") {
+    GIVEN("Option descriptions of every type and a positional option") {
+        const Option<bool> dryRun("dry-run", {"n"}, "Dry run");
+        const Option<bool> verbose("verbose", {"v"}, "Set verbosity");
+        const Option<string> jobs("jobs", {"j"}, "Set the number of jobs");
+        const Option<string> debug("debug", {"d"}, "Set the log level");
+        const Option<vector<string>> commands("command", {"z"}, "Commands");
+
+        OptionDescriptions options;
+        options.addOption(dryRun);
+        options.addOption(verbose);
+        options.addOption(jobs);
+        options.addOption(debug);
+        options.addOption(commands);
+        options.setPositionalArgument(commands);
+
+        const vector<vector<string>> commandLines = {
+            {"--dry-run", "--verbose", "--jobs", "4", "build", "run"},
+            {"-n", "-v", "-j", "4", "build", "run"},
+            {"-nvj4", "build", "run"},
+            {"--jobs=4", "-vn", "--command", "build", "run"},
+            {"build", "--dry", "--verb", "-j4", "--", "run"},
+        };
+
+        for(const auto& arguments : commandLines) {
+            const auto args = toArgs(arguments);
+
+            WHEN("We parse the command line: " + join(arguments)) {
+                VariablesMap variables("options");
+                const auto parsed = options.getOptionsMap(
+                    variables, CommandLine(Args(args)));
+
+                THEN("It must succeed") { REQUIRE(parsed); }
+
+                THEN("We must find the values of the options") {
+                    REQUIRE(variables.get<bool>("dry-run") == true);
+                    REQUIRE(variables.get<bool>("verbose") == true);
+                    REQUIRE(variables.get<string>("jobs") == "4");
+                    REQUIRE(variables.get<vector<string>>("command") ==
+                            vector<string>({"build", "run"}));
+                }
+            }
+        }
+
+        WHEN("We parse a command line with an unknown option") {
+            const vector<string> arguments({"--blaat", "blaat", "-n"});
+            const auto args = toArgs(arguments);
+            const CommandLine commandLine{Args(args)};
+
+            THEN("It must fail") {
+                VariablesMap variables("options");
+                REQUIRE_FALSE(options.getOptionsMap(variables, commandLine));
+            }
+
+            THEN("It must succeed when unregistered options are allowed") {
+                VariablesMap variables("options");
+                REQUIRE(options.getOptionsMap(variables, commandLine, true));
+                REQUIRE(variables.get<bool>("dry-run") == true);
+            }
+
+            THEN("It must succeed after the option is added") {
+                options.addOption(
+                    Option<vector<string>>("blaat", {"b"}, "Pattern values"));
+
+                VariablesMap variables("options");
+                REQUIRE(options.getOptionsMap(variables, commandLine));
+                REQUIRE(variables.get<vector<string>>("blaat") ==
+                        vector<string>({"blaat"}));
+                REQUIRE(variables.get<bool>("dry-run") == true);
+            }
+        }
+
+        WHEN("We parse a command line with invalid values") {
+            const vector<vector<string>> commandLines = {
+                {"--jobs"},
+                {"-n", "-j"},
+                {"--verbose=yes"},
+                {"--d"},
+                {"-j", "4", "--jobs", "8"},
+                {"--jobs=4", "-j8"},
+            };
+
+            for(const auto& arguments : commandLines) {
+                const auto args = toArgs(arguments);
+
+                THEN("It must fail: " + join(arguments)) {
+                    VariablesMap variables("options");
+                    REQUIRE_FALSE(options.getOptionsMap(
+                        variables, CommandLine(Args(args))));
+                }
+            }
+        }
+
+        WHEN("We parse a command line with a signed number") {
+            const vector<string> arguments({"--jobs", "+4"});
+            const auto args = toArgs(arguments);
+
+            THEN("We must find the number") {
+                VariablesMap variables("options");
+                REQUIRE(options.getOptionsMap(variables,
+                                              CommandLine(Args(args))));
+                REQUIRE(variables.get<uint32_t>("jobs") == 4U);
+            }
+        }
+
+        WHEN("We request the help text") {
+            const auto help = options.getHelp();
+
+            THEN("It must list every option") {
+                REQUIRE(help.find("-n [ --dry-run ]") != string::npos);
+                REQUIRE(help.find("-j [ --jobs ] arg") != string::npos);
+                REQUIRE(help.find("Set the number of jobs") != string::npos);
+            }
+        }
+    }
+}
+} // namespace execHelper::config::test
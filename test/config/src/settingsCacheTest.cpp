@@ -0,0 +1,256 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "config/config.h"
+#include "config/pattern.h"
+#include "config/settingsCache.h"
+
+#include "base-utils/configFileWriter.h"
+#include "base-utils/tmpFile.h"
+#include "unittest/catch.h"
+#include "utils/utils.h"
+
+using std::ifstream;
+using std::istreambuf_iterator;
+using std::ofstream;
+using std::string;
+using std::vector;
+
+using execHelper::test::baseUtils::ConfigFileWriter;
+using execHelper::test::baseUtils::TmpFile;
+using execHelper::test::utils::writeSettingsFile;
+
+namespace {
+auto readFile(const execHelper::config::Path& file) -> string {
+    ifstream stream(file, std::ios::binary);
+    return string((istreambuf_iterator<char>(stream)),
+                  istreambuf_iterator<char>());
+}
+
+void writeFile(const execHelper::config::Path& file, const string& content) {
+    ofstream stream(file, std::ios::binary | std::ios::trunc);
+    stream << content;
+}
+
+auto samePatterns(const execHelper::config::Patterns& actual,
+                  const execHelper::config::Patterns& expected) -> bool {
+    return actual.size() == expected.size() &&
+           std::all_of(expected.begin(), expected.end(),
+                       [&actual](const auto& pattern) {
+                           return std::find(actual.begin(), actual.end(),
+                                            pattern) != actual.end();
+                       });
+}
+} // namespace
+
+namespace execHelper::config::test {
+SCENARIO("Cache the parsed settings files", "[config][settings-cache]") {
+    GIVEN("A settings file and a cache file") {
+        SettingsNode settings("exec-helper");
+        REQUIRE(
+            settings.add("commands", SettingsValues({"build", "run"})));
+        REQUIRE(settings.add({"build", "command-line"}, {"make", "-j", "-j"}));
+        REQUIRE(settings.add({"run", "environment", "A"}, "a"));
+
+        const Patterns patterns(
+            {Pattern("TARGET", {"all", "test"}, 't', "target"),
+             Pattern("MODE", {"debug"})});
+
+        ConfigFileWriter configFile;
+        writeSettingsFile(configFile, settings, patterns);
+
+        TmpFile cacheFile;
+        const string version("1.0.0");
+
+        WHEN("We parse the settings file using the cache") {
+            auto parsed = parseSettingsFile(configFile.getPath(),
+                                            cacheFile.getPath(), version);
+
+            THEN("We must find the proper settings and patterns") {
+                REQUIRE(parsed);
+                REQUIRE(parsed->second == settings);
+                REQUIRE(samePatterns(parsed->first, patterns));
+            }
+
+            THEN("The cache must contain the same settings and patterns") {
+                auto cached =
+                    readSettingsCache(cacheFile.getPath(), configFile.getPath(),
+                                      readFile(configFile.getPath()), version);
+                REQUIRE(cached);
+                REQUIRE(cached->second == settings);
+                REQUIRE(cached->first == parsed->first);
+            }
+
+            THEN("The cache must not be used by another version") {
+                REQUIRE_FALSE(
+                    readSettingsCache(cacheFile.getPath(), configFile.getPath(),
+                                      readFile(configFile.getPath()), "2.0.0"));
+            }
+
+            THEN("Parsing it again must return the same settings and "
+                 "patterns") {
+                auto reparsed = parseSettingsFile(configFile.getPath(),
+                                                  cacheFile.getPath(), version);
+                REQUIRE(reparsed);
+                REQUIRE(reparsed->second == settings);
+                REQUIRE(reparsed->first == parsed->first);
+            }
+        }
+
+        WHEN("The settings file changes after it was cached") {
+            REQUIRE(parseSettingsFile(configFile.getPath(), cacheFile.getPath(),
+                                      version));
+
+            SettingsNode newSettings("exec-helper");
+            REQUIRE(newSettings.add("commands", "clean"));
+            writeSettingsFile(configFile, newSettings, {});
+
+            THEN("The cache must not be used") {
+                REQUIRE_FALSE(
+                    readSettingsCache(cacheFile.getPath(), configFile.getPath(),
+                                      readFile(configFile.getPath()), version));
+            }
+
+            THEN("We must find the new settings and patterns") {
+                auto parsed = parseSettingsFile(configFile.getPath(),
+                                                cacheFile.getPath(), version);
+                REQUIRE(parsed);
+                REQUIRE(parsed->second == newSettings);
+                REQUIRE(parsed->first.empty());
+            }
+        }
+
+        WHEN("The cache file is corrupt") {
+            REQUIRE(parseSettingsFile(configFile.getPath(), cacheFile.getPath(),
+                                      version));
+            const auto cache = readFile(cacheFile.getPath());
+            const auto content = readFile(configFile.getPath());
+
+            THEN("No truncated cache must be used") {
+                for(size_t size = 0U; size < cache.size(); ++size) {
+                    writeFile(cacheFile.getPath(), cache.substr(0U, size));
+                    REQUIRE_FALSE(readSettingsCache(cacheFile.getPath(),
+                                                    configFile.getPath(),
+                                                    content, version));
+                }
+            }
+
+            THEN("No cache with trailing data must be used") {
+                writeFile(cacheFile.getPath(), cache + '\0');
+                REQUIRE_FALSE(readSettingsCache(cacheFile.getPath(),
+                                                configFile.getPath(), content,
+                                                version));
+            }
+
+            THEN("We must still find the proper settings and patterns") {
+                writeFile(cacheFile.getPath(),
+                          cache.substr(0U, cache.size() / 2U));
+                auto parsed = parseSettingsFile(configFile.getPath(),
+                                                cacheFile.getPath(), version);
+                REQUIRE(parsed);
+                REQUIRE(parsed->second == settings);
+                REQUIRE(samePatterns(parsed->first, patterns));
+            }
+        }
+    }
+
+    GIVEN("An environment") {
+        const Path settingsFile("/settings/.exec-helper");
+
+        THEN("The cache file must be stored in XDG_CACHE_HOME if it is set") {
+            auto cacheFile = getSettingsCacheFile(
+                settingsFile, {{"XDG_CACHE_HOME", "/xdg"}, {"HOME", "/home"}});
+            REQUIRE(cacheFile);
+            REQUIRE(cacheFile->parent_path() == Path("/xdg/exec-helper"));
+        }
+
+        THEN("The cache file must be stored in the home directory otherwise") {
+            auto cacheFile =
+                getSettingsCacheFile(settingsFile, {{"HOME", "/home"}});
+            REQUIRE(cacheFile);
+            REQUIRE(cacheFile->parent_path() ==
+                    Path("/home/.cache/exec-helper"));
+        }
+
+        THEN("Different settings files must use different cache files") {
+            const EnvironmentCollection env({{"HOME", "/home"}});
+            REQUIRE(getSettingsCacheFile(settingsFile, env) !=
+                    getSettingsCacheFile("/other/.exec-helper", env));
+        }
+
+        THEN("There must be no cache file without a cache directory") {
+            REQUIRE_FALSE(getSettingsCacheFile(settingsFile, {}));
+        }
+    }
+}
+
+SCENARIO("Cache the completion words of the settings files",
+         "[config][settings-cache]") {
+    GIVEN("A settings file, an included settings file and a completion index") {
+        TmpFile settingsFile;
+        REQUIRE(settingsFile.create("commands: [build]\n"));
+        TmpFile includedFile;
+        REQUIRE(includedFile.create("commands: [run]\n"));
+        TmpFile indexFile;
+
+        const Paths paths({settingsFile.getPath(), includedFile.getPath()});
+        const vector<string> words({"--help", "-h", "build", "run"});
+        const string version("1.0.0");
+
+        WHEN("We write the completion words") {
+            REQUIRE(writeCompletionIndex(indexFile.getPath(), paths, words,
+                                         version));
+
+            THEN("We must read the same words") {
+                REQUIRE(readCompletionIndex(indexFile.getPath(), version) ==
+                        words);
+            }
+
+            THEN("The index must not be used after a settings file changed") {
+                REQUIRE(includedFile.create("commands: [run, test]\n"));
+                REQUIRE_FALSE(
+                    readCompletionIndex(indexFile.getPath(), version));
+            }
+
+            THEN("The index must not be used by another version") {
+                REQUIRE_FALSE(
+                    readCompletionIndex(indexFile.getPath(), "1.0.1"));
+            }
+
+            THEN("The index must not be used after a file is removed") {
+                REQUIRE(std::filesystem::remove(includedFile.getPath()));
+                REQUIRE_FALSE(
+                    readCompletionIndex(indexFile.getPath(), version));
+            }
+
+            THEN("No truncated index must be used") {
+                const auto index = readFile(indexFile.getPath());
+                const auto header = index.find('\n', index.find('\n') + 1U);
+                for(size_t size = 0U; size <= header; ++size) {
+                    writeFile(indexFile.getPath(), index.substr(0U, size));
+                    REQUIRE_FALSE(
+                    readCompletionIndex(indexFile.getPath(), version));
+                }
+            }
+        }
+    }
+
+    GIVEN("An environment") {
+        const EnvironmentCollection env({{"HOME", "/home"}});
+
+        THEN("The index must be stored next to the settings cache") {
+            const Path settingsFile("/settings/.exec-helper");
+            auto indexFile = getCompletionIndexFile(settingsFile, env);
+            auto cacheFile = getSettingsCacheFile(settingsFile, env);
+            REQUIRE(indexFile);
+            REQUIRE(cacheFile);
+            REQUIRE(indexFile->parent_path() == cacheFile->parent_path());
+            REQUIRE(*indexFile != *cacheFile);
+        }
+    }
+}
+} // namespace execHelper::config::test
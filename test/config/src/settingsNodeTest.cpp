@@ -803,4 +803,215 @@ SCENARIO("Test adding values", "[config][settingsNode]") {
         REQUIRE(settings.get<SettingsValues>(key, DEFAULT_VALUES) == values);
     });
 }
+
+SCENARIO("Test the order and lookup of many values", "[config][settingsNode]") {
+    GIVEN("A node with many values that are not added in sorted order") {
+        SettingsNode settings("root-key");
+        SettingsValues expected;
+        for(size_t i = 0U; i < 500U; ++i) {
+            expected.emplace_back(to_string((i * 7919U) % 500U));
+        }
+        REQUIRE(settings.add(expected));
+
+        WHEN("We get the values") {
+            const auto values = settings.values();
+
+            THEN("They should be in the order they were added") {
+                REQUIRE(values);
+                REQUIRE(SettingsValues(values->begin(), values->end()) ==
+                        expected);
+                REQUIRE(values->size() == expected.size());
+                REQUIRE(values->front() == expected.front());
+                REQUIRE(values->back() == expected.back());
+                REQUIRE(settings.get<SettingsValues>(SettingsKeys()) ==
+                        expected);
+            }
+
+            THEN("Every value should be found") {
+                for(const auto& value : expected) {
+                    REQUIRE(settings.contains(value));
+                    REQUIRE(settings[value].key() == value);
+                }
+                REQUIRE_FALSE(settings.contains("500"));
+            }
+        }
+
+        WHEN("We remove some of the values") {
+            SettingsValues remaining;
+            for(const auto& value : expected) {
+                if(std::stoul(value) % 3U == 0U) {
+                    REQUIRE(settings.clear(value));
+                } else {
+                    remaining.push_back(value);
+                }
+            }
+
+            THEN("Only the remaining values should be found in order") {
+                REQUIRE(settings.get<SettingsValues>(SettingsKeys()) ==
+                        remaining);
+                for(const auto& value : expected) {
+                    REQUIRE(settings.contains(value) ==
+                            (std::stoul(value) % 3U != 0U));
+                }
+            }
+        }
+    }
+
+    GIVEN("A node with duplicate values") {
+        SettingsNode settings("root-key");
+        REQUIRE(settings.add({"b", "a", "b"}));
+        REQUIRE(settings.add({"b"}, "first"));
+
+        WHEN("We look up the duplicate value") {
+            THEN("The value that was added first should be found") {
+                REQUIRE(settings.get<SettingsValues>(SettingsKeys()) ==
+                        SettingsValues({"b", "a", "b"}));
+                REQUIRE(settings.get<SettingsValues>(SettingsKeys({"b"})) ==
+                        SettingsValues({"first"}));
+            }
+        }
+    }
+}
+SCENARIO("Test the independence of copies", "[config][settingsNode]") {
+    GIVEN("A settings node with a hierarchy") {
+        SettingsNode original("root-key");
+        REQUIRE(original.add({"a", "b"}, {"c", "d"}));
+        REQUIRE(original.add({"e"}, "f"));
+        const SettingsNode expected = original;
+
+        WHEN("We modify a deep node of a copy") {
+            SettingsNode copy(original);
+            REQUIRE(copy.add({"a", "b", "c"}, "g"));
+            REQUIRE(copy.clear(SettingsKeys({"a", "b", "d"})));
+            copy["e"]["f"]["h"];
+
+            THEN("The original should not change") {
+                REQUIRE(original == expected);
+                REQUIRE(original.get<SettingsValues>(
+                            SettingsKeys({"a", "b"})) ==
+                        SettingsValues({"c", "d"}));
+                REQUIRE_FALSE(
+                    original.contains(SettingsKeys({"a", "b", "c", "g"})));
+                REQUIRE_FALSE(
+                    original.contains(SettingsKeys({"e", "f", "h"})));
+            }
+
+            THEN("The copy should contain the modifications") {
+                REQUIRE(copy.get<SettingsValues>(SettingsKeys({"a", "b"})) ==
+                        SettingsValues({"c"}));
+                REQUIRE(copy.get<SettingsValues>(
+                            SettingsKeys({"a", "b", "c"})) ==
+                        SettingsValues({"g"}));
+                REQUIRE(copy.contains(SettingsKeys({"e", "f", "h"})));
+            }
+        }
+
+        WHEN("We modify the original after copying it") {
+            SettingsNode copy("other-key");
+            copy = original;
+            REQUIRE(original.replace(SettingsKeys({"a", "b"}), "i"));
+
+            THEN("The copy should not change") {
+                REQUIRE(copy == expected);
+                REQUIRE(original.get<SettingsValues>(
+                            SettingsKeys({"a", "b"})) ==
+                        SettingsValues({"i"}));
+            }
+        }
+
+        WHEN("We modify a child of the original through a reference taken "
+             "before copying it") {
+            auto& a = original["a"];
+            SettingsNode copy = original;
+            REQUIRE(a.add("y"));
+
+            THEN("The copy should not change") {
+                REQUIRE(copy == expected);
+                REQUIRE_FALSE(copy["a"].contains("y"));
+            }
+
+            THEN("The original should contain the modification") {
+                REQUIRE(original["a"].contains("y"));
+            }
+        }
+
+        WHEN("We modify a deep node of the original through a reference taken "
+             "before copying it") {
+            auto& b = original["a"]["b"];
+            SettingsNode copy = original;
+            REQUIRE(b.add("y"));
+
+            THEN("The copy should not change") {
+                REQUIRE(copy == expected);
+                REQUIRE_FALSE(copy.contains(SettingsKeys({"a", "b", "y"})));
+            }
+
+            THEN("The original should contain the modification") {
+                REQUIRE(original.contains(SettingsKeys({"a", "b", "y"})));
+            }
+        }
+    }
+}
+
+SCENARIO("Test converting values to the requested types",
+         "[config][settingsNode]") {
+    GIVEN("Settings with values of different types") {
+        SettingsNode settings("root-key");
+        REQUIRE(settings.add("jobs", "8"));
+        REQUIRE(settings.add("flag", "yes"));
+        REQUIRE(settings.add("option", "j"));
+        REQUIRE(settings.add("list", SettingsValues({"a", "b"})));
+        REQUIRE(settings.add("invalid", "8x"));
+        REQUIRE(settings.add("negative", "-1"));
+
+        THEN("Repeated conversions should return the same values") {
+            for(size_t i = 0U; i < 2U; ++i) {
+                REQUIRE(settings.get<uint32_t>("jobs") == 8U);
+                REQUIRE(settings.get<bool>("flag") == true);
+                REQUIRE(settings.get<char>("option") == 'j');
+                REQUIRE(settings.get<string>("list") == "b");
+                REQUIRE(settings.get<SettingsValues>("list") ==
+                        SettingsValues({"a", "b"}));
+            }
+        }
+
+        THEN("Values that do not represent the type should not convert") {
+            REQUIRE(settings.get<uint32_t>("invalid") == std::nullopt);
+            REQUIRE(settings.get<uint32_t>("negative") == std::nullopt);
+            REQUIRE(settings.get<uint32_t>("list") == std::nullopt);
+            REQUIRE(settings.get<char>("flag", 'x') == 'x');
+        }
+
+        THEN("The values should be accessible without copying them") {
+            const auto* list = settings.getRef<SettingsValues>("list");
+            REQUIRE(list != nullptr);
+            REQUIRE(*list == SettingsValues({"a", "b"}));
+            REQUIRE(settings.getRef<SettingsValues>("list") == list);
+            REQUIRE(settings.getRef<uint32_t>("invalid") == nullptr);
+            REQUIRE(settings.getRef<string>("unknown") == nullptr);
+        }
+
+        WHEN("We modify the values after converting them") {
+            REQUIRE(settings.get<uint32_t>("jobs") == 8U);
+            REQUIRE(settings.get<SettingsValues>("list") ==
+                    SettingsValues({"a", "b"}));
+
+            SettingsNode copy = settings;
+            REQUIRE(settings.add("jobs", "16"));
+            REQUIRE(settings.replace("list", "c"));
+
+            THEN("We should get the conversions of the new values") {
+                REQUIRE(settings.get<uint32_t>("jobs") == 16U);
+                REQUIRE(settings.get<SettingsValues>("list") ==
+                        SettingsValues({"c"}));
+            }
+
+            THEN("The copy should keep the conversions of the old values") {
+                REQUIRE(copy.get<uint32_t>("jobs") == 8U);
+                REQUIRE(copy.get<SettingsValues>("list") ==
+                        SettingsValues({"a", "b"}));
+            }
+        }
+    }
+}
 } // namespace execHelper::config::test
@@ -0,0 +1,171 @@
+#include <string>
+#include <vector>
+
+#include "config/settingsNode.h"
+#include "config/yaml.h"
+#include "config/yamlParser.h"
+#include "config/yamlWrapper.h"
+
+#include "unittest/catch.h"
+
+using std::string;
+using std::to_string;
+using std::vector;
+
+using execHelper::config::SettingsNode;
+
+namespace {
+/**
+ * Generates a configuration with the given number of commands, in the style of
+ * the configurations exec-helper is used with
+ */
+auto generateConfig(size_t nbOfCommands) -> string {
+    string config = "patterns:\n";
+    config += "  MODE:\n    default-values: [debug, release]\n";
+    config += "    short-option: m\n    long-option: mode\n";
+    config += "commands:\n";
+    for(size_t i = 0U; i < nbOfCommands; ++i) {
+        config += "  command" + to_string(i) + ": Run command " +
+                  to_string(i) + "\n";
+    }
+    for(size_t i = 0U; i < nbOfCommands; ++i) {
+        const auto command = "command" + to_string(i);
+        config += command + ":\n";
+        config += "  - build" + to_string(i) + "\n";
+        config += "  - command-line-command\n";
+        config += "build" + to_string(i) + ":\n";
+        config += "  - make\n";
+        config += "command-line-command:\n";
+        config += "  " + command + ":\n";
+        config += "    command-line: [echo, \"" + command + " {MODE}\"]\n";
+        config += "    environment:\n";
+        config += "      COMMAND: '" + command + "' # The command\n";
+        config += "    patterns:\n      - MODE\n";
+    }
+    return config;
+}
+} // namespace
+
+namespace execHelper::yaml::test {
+SCENARIO("Parse the supported subset of yaml in place",
+         "[yaml][yamlparser]") {
+    GIVEN("Documents that only use the supported subset of yaml") {
+        const vector<string> documents = {
+            "commands: [build, run]\n",
+            "commands:\n  - build\n  - run\n",
+            "commands:\n- build\n- run\n",
+            "build:\n  make:\n    command-line: [make, -j4]\n",
+            "# A comment\n---\nkey: value # Another comment\n",
+            "key:\n  - - nested\n    - sequence\n  - value\n",
+            "a: 'single ''quoted'''\nb: \"double \\\"quoted\\\"\\t\"\n",
+            "a: ~\nb: null\nc:\nd: [x, ~]\n",
+            "a: http://example.com:80\nb: a -b #c\nc: -x\n",
+            "{a: {b: c}, d: [e, {f: g}], h}\n",
+            "[a, [b, c],\n  d]\n",
+            "base: &base\n  a: b\nderived: *base\n",
+            "values: &values [a, b]\nall:\n  - *values\n  - c\n",
+        };
+
+        for(const auto& document : documents) {
+            WHEN("We parse the document: " + document) {
+                YamlParser parser(document);
+
+                SettingsNode actual("root");
+                const auto parsed = parser.getTree(&actual);
+
+                THEN("It must be supported") {
+                    REQUIRE(parser.isSupported());
+                    REQUIRE(parsed);
+                }
+
+                THEN("We must get the same settings as with yaml-cpp") {
+                    SettingsNode expected("root");
+                    REQUIRE(YamlWrapper(document).getTree({}, &expected));
+                    REQUIRE(actual == expected);
+                }
+            }
+        }
+    }
+
+    GIVEN("Documents that use yaml that is not supported") {
+        const vector<string> documents = {
+            "a: |\n  literal\n  block\n",
+            "a: >\n  folded\n",
+            "a: !!str tagged\n",
+            "a:\tb\n",
+            "a: b\n---\nc: d\n",
+            "? complex key\n: value\n",
+            "a: multi\n  line\n",
+            "&anchor a: b\n",
+            "%YAML 1.2\n---\na: b\n",
+            "a: b\r\n",
+        };
+
+        for(const auto& document : documents) {
+            WHEN("We parse the document: " + document) {
+                YamlParser parser(document);
+
+                SettingsNode settings("root");
+                REQUIRE(settings.add("key", "value"));
+                const auto expected = settings;
+
+                THEN("It must not be supported") {
+                    REQUIRE_FALSE(parser.isSupported());
+                }
+
+                THEN("The settings must be left untouched") {
+                    REQUIRE_FALSE(parser.getTree(&settings));
+                    REQUIRE(settings == expected);
+                }
+            }
+        }
+    }
+
+    GIVEN("Documents that are not valid yaml") {
+        const vector<string> documents = {
+            "a: [b, c\n",
+            "a: 'unterminated\n",
+            "a: *unknown\n",
+            "a: b\n c: d\n",
+        };
+
+        for(const auto& document : documents) {
+            THEN("It must not be supported: " + document) {
+                REQUIRE_FALSE(YamlParser(document).isSupported());
+            }
+        }
+    }
+
+    GIVEN("A document that is not supported but valid yaml") {
+        const string document("commands:\n  build: |\n    Build it\n");
+
+        WHEN("We parse it using the yaml backend") {
+            Yaml yaml(document);
+
+            SettingsNode settings("root");
+            REQUIRE(yaml.getTree({}, &settings));
+
+            THEN("It must fall back to yaml-cpp") {
+                SettingsNode expected("root");
+                REQUIRE(expected.add({"commands", "build"}, "Build it\n"));
+                REQUIRE(settings == expected);
+            }
+        }
+    }
+}
+
+TEST_CASE("Benchmark the yaml backends", "[.][benchmark][yaml]") {
+    const auto config = generateConfig(2000U);
+    REQUIRE(YamlParser(config).isSupported());
+
+    BENCHMARK("yaml-cpp") {
+        SettingsNode settings("root");
+        return YamlWrapper(config).getTree({}, &settings);
+    };
+
+    BENCHMARK("In situ parser") {
+        SettingsNode settings("root");
+        return YamlParser(config).getTree(&settings);
+    };
+}
+} // namespace execHelper::yaml::test
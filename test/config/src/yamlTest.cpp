@@ -320,6 +320,17 @@ SCENARIO("Requesting invalid values", "[yaml][yamlwrapper]") {
                 REQUIRE(settings.get<SettingsValues>(SettingsKeys()) ==
                         std::nullopt);
             }
+            THEN("Requesting invalid values should not alter the "
+                 "configuration") {
+                REQUIRE(yaml.getValue({"invalid-key", "invalid-subkey"})
+                            .empty());
+                REQUIRE_FALSE(yaml.getTree({"invalid-key"}, nullptr));
+
+                SettingsNode settings("exec-helper");
+                REQUIRE(yaml.getTree({}, &settings));
+                REQUIRE(settings.get<SettingsValues>(SettingsKeys()) ==
+                        SettingsValues({key, key2}));
+            }
         }
     }
 }
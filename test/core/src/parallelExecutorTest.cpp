@@ -0,0 +1,259 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/parallelExecutor.h"
+#include "unittest/catch.h"
+
+#include "shellStub.h"
+
+using std::condition_variable;
+using std::lock_guard;
+using std::map;
+using std::max;
+using std::mutex;
+using std::string;
+using std::unique_lock;
+using std::vector;
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+
+namespace {
+/**
+ * \brief Shell that blocks each execution until the given number of executions are running concurrently
+ */
+class BlockingShellStub final : public execHelper::core::Shell {
+  public:
+    explicit BlockingShellStub(size_t expectedConcurrency) noexcept
+        : m_expectedConcurrency(expectedConcurrency) {
+        ;
+    }
+
+    ShellReturnCode
+    execute(const execHelper::core::Task& /*task*/) const noexcept override {
+        unique_lock<mutex> lock(m_mutex);
+        ++m_running;
+        m_maxRunning = max(m_maxRunning, m_running);
+        m_changed.notify_all();
+        m_changed.wait_for(lock, seconds(5), [this]() {
+            return m_maxRunning >= m_expectedConcurrency;
+        });
+        --m_running;
+        return 0U;
+    }
+
+    bool
+    isExecutedSuccessfully(ShellReturnCode returnCode) const noexcept override {
+        return returnCode == 0U;
+    }
+
+    size_t getMaxRunning() const noexcept {
+        lock_guard<mutex> lock(m_mutex);
+        return m_maxRunning;
+    }
+
+  private:
+    const size_t m_expectedConcurrency;
+    mutable mutex m_mutex;
+    mutable condition_variable m_changed;
+    mutable size_t m_running{0U};
+    mutable size_t m_maxRunning{0U};
+};
+
+/**
+ * \brief Shell that records, per first argument of the executed tasks, the
+ * order in which they finished and how many of them ran concurrently
+ */
+class SequenceShellStub final : public execHelper::core::Shell {
+  public:
+    ShellReturnCode
+    execute(const execHelper::core::Task& task) const noexcept override {
+        const auto& sequence = task.getTask().front();
+        {
+            lock_guard<mutex> lock(m_mutex);
+            auto& running = m_running[sequence];
+            ++running;
+            m_maxRunning[sequence] = max(m_maxRunning[sequence], running);
+        }
+        std::this_thread::sleep_for(milliseconds(1));
+
+        lock_guard<mutex> lock(m_mutex);
+        --m_running[sequence];
+        m_finished[sequence].push_back(task.getTask().back());
+        return 0U;
+    }
+
+    bool
+    isExecutedSuccessfully(ShellReturnCode returnCode) const noexcept override {
+        return returnCode == 0U;
+    }
+
+    auto getMaxRunning() const noexcept -> map<string, size_t> {
+        lock_guard<mutex> lock(m_mutex);
+        return m_maxRunning;
+    }
+
+    auto getFinished() const noexcept -> map<string, vector<string>> {
+        lock_guard<mutex> lock(m_mutex);
+        return m_finished;
+    }
+
+  private:
+    mutable mutex m_mutex;
+    mutable map<string, size_t> m_running;
+    mutable map<string, size_t> m_maxRunning;
+    mutable map<string, vector<string>> m_finished;
+};
+} // namespace
+
+namespace execHelper::core::test {
+SCENARIO("Test the execution of the parallelExecutor",
+         "[ExecutorInterface][ParallelExecutor]") {
+    GIVEN("Some tasks we want to execute and an executor") {
+        const size_t jobs = 4U;
+
+        ShellStub::TaskQueue actualTasks;
+        for(size_t i = 0U; i < 3U * jobs; ++i) {
+            Task task;
+            task.append("task" + std::to_string(i));
+            actualTasks.push_back(task);
+        }
+        ShellStub shell;
+
+        WHEN("We schedule each task and wait for the executor") {
+            ParallelExecutor executor(
+                shell,
+                []([[maybe_unused]] Shell::ShellReturnCode returnCode) {},
+                jobs, false);
+            for(const auto& task : actualTasks) {
+                executor.execute(task);
+            }
+            executor.wait();
+
+            THEN("We should get the same tasks again, in any order") {
+                auto executedTasks = shell.getExecutedTasks();
+                REQUIRE(executedTasks.size() == actualTasks.size());
+                REQUIRE(std::is_permutation(executedTasks.begin(),
+                                            executedTasks.end(),
+                                            actualTasks.begin()));
+            }
+        }
+    }
+}
+
+SCENARIO("Test the concurrency of the parallelExecutor",
+         "[ExecutorInterface][ParallelExecutor]") {
+    GIVEN("A shell that blocks until the number of jobs runs concurrently") {
+        const size_t jobs = 3U;
+        BlockingShellStub shell(jobs);
+
+        WHEN("We schedule more tasks than there are jobs") {
+            {
+                ParallelExecutor executor(
+                    shell,
+                    []([[maybe_unused]] Shell::ShellReturnCode returnCode) {},
+                    jobs, false);
+                for(size_t i = 0U; i < 2U * jobs; ++i) {
+                    executor.execute(Task({"task"}));
+                }
+            }
+
+            THEN("Exactly the number of jobs should have run concurrently") {
+                REQUIRE(shell.getMaxRunning() == jobs);
+            }
+        }
+    }
+}
+
+SCENARIO("Test the sequences of the parallelExecutor",
+         "[ExecutorInterface][ParallelExecutor]") {
+    GIVEN("An executor with multiple jobs") {
+        const size_t jobs = 4U;
+        const size_t tasksPerSequence = 10U;
+        SequenceShellStub shell;
+
+        WHEN("We schedule the tasks of two sequences interleaved") {
+            vector<string> expectedOrder;
+            {
+                ParallelExecutor executor(
+                    shell,
+                    []([[maybe_unused]] Shell::ShellReturnCode returnCode) {},
+                    jobs, false);
+                for(size_t i = 0U; i < tasksPerSequence; ++i) {
+                    expectedOrder.push_back(std::to_string(i));
+                    executor.executeInSequence(
+                        Task({"first", expectedOrder.back()}), 0U);
+                    executor.executeInSequence(
+                        Task({"second", expectedOrder.back()}), 1U);
+                }
+            }
+
+            THEN("The tasks of a sequence never ran concurrently") {
+                REQUIRE(shell.getMaxRunning() ==
+                        map<string, size_t>({{"first", 1U}, {"second", 1U}}));
+            }
+
+            THEN("The tasks of a sequence finished in the scheduled order") {
+                REQUIRE(shell.getFinished() ==
+                        map<string, vector<string>>(
+                            {{"first", expectedOrder},
+                             {"second", expectedOrder}}));
+            }
+        }
+    }
+}
+
+SCENARIO("Test the failing of the parallel execution",
+         "[ExecutorInterface][ParallelExecutor]") {
+    GIVEN("A shell that fails to execute and some tasks to execute") {
+        const Shell::ShellReturnCode actualReturnCode = 42U;
+        ShellStub shell(actualReturnCode);
+
+        ShellStub::TaskQueue tasks = {Task({"task1"}), Task({"task2"}),
+                                      Task({"task3"})};
+
+        Shell::ShellReturnCode realReturnCode = 0U;
+        size_t nbOfCallbacks = 0U;
+        ParallelExecutor::Callback callback =
+            [&realReturnCode, &nbOfCallbacks](Shell::ShellReturnCode returnCode) {
+                realReturnCode = returnCode;
+                ++nbOfCallbacks;
+            };
+
+        WHEN("We schedule the tasks for execution and keep going") {
+            ParallelExecutor executor(shell, callback, 2U, true);
+            for(const auto& task : tasks) {
+                executor.execute(task);
+            }
+            executor.wait();
+
+            THEN("We should receive the failed return code for every task") {
+                REQUIRE(realReturnCode == actualReturnCode);
+                REQUIRE(nbOfCallbacks == tasks.size());
+                REQUIRE(shell.getExecutedTasks().size() == tasks.size());
+            }
+        }
+
+        WHEN("We schedule the tasks for execution on a single job without "
+             "keeping going") {
+            ParallelExecutor executor(shell, callback, 1U, false);
+            for(const auto& task : tasks) {
+                executor.execute(task);
+            }
+            executor.wait();
+
+            THEN("Only the first task should have been executed") {
+                REQUIRE(realReturnCode == actualReturnCode);
+                REQUIRE(nbOfCallbacks == 1U);
+                REQUIRE(shell.getExecutedTasks() ==
+                        ShellStub::TaskQueue({tasks.front()}));
+            }
+        }
+    }
+}
+} // namespace execHelper::core::test
@@ -0,0 +1,93 @@
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "core/permutations.h"
+#include "unittest/catch.h"
+
+using std::numeric_limits;
+using std::overflow_error;
+using std::vector;
+
+namespace execHelper::core::test {
+SCENARIO("Enumerate the combinations of multiple dimensions",
+         "[permutations]") {
+    GIVEN("Dimensions with a different number of values") {
+        const Permutations::Radices radices({2U, 3U, 4U});
+        const Permutations permutations(radices);
+
+        WHEN("We enumerate all combinations") {
+            vector<Permutations::Combination> combinations;
+            for(Permutations::Index i = 0U; i < permutations.size(); ++i) {
+                combinations.emplace_back(permutations.combination(i));
+            }
+
+            THEN("They should be in the order of the equivalent nested loops") {
+                vector<Permutations::Combination> expected;
+                for(size_t first = 0U; first < radices[0]; ++first) {
+                    for(size_t second = 0U; second < radices[1]; ++second) {
+                        for(size_t third = 0U; third < radices[2]; ++third) {
+                            expected.push_back({first, second, third});
+                        }
+                    }
+                }
+                REQUIRE(permutations.dimensions() == radices.size());
+                REQUIRE(permutations.size() == expected.size());
+                REQUIRE(combinations == expected);
+            }
+        }
+    }
+
+    GIVEN("No dimensions") {
+        const Permutations permutations({});
+
+        THEN("There should be exactly one empty combination") {
+            REQUIRE(permutations.size() == 1U);
+            REQUIRE(permutations.combination(0U).empty());
+        }
+    }
+
+    GIVEN("A dimension without values") {
+        const Permutations permutations({3U, 0U, 2U});
+
+        THEN("There should be no combinations") {
+            REQUIRE(permutations.size() == 0U);
+        }
+    }
+
+    GIVEN("Dimensions with too many combinations") {
+        const auto max = numeric_limits<Permutations::Index>::max();
+
+        THEN("It should throw") {
+            REQUIRE_THROWS_AS(Permutations({max, 2U}), overflow_error);
+        }
+    }
+}
+
+SCENARIO("Split the combinations into ranges", "[permutations]") {
+    GIVEN("Combinations that can not be divided equally") {
+        const Permutations permutations({2U, 5U});
+
+        WHEN("We split them into ranges") {
+            auto ranges = permutations.split(3U);
+
+            THEN("The ranges should cover all combinations in order") {
+                const vector<Permutations::Range> expected(
+                    {{0U, 4U}, {4U, 7U}, {7U, 10U}});
+                REQUIRE(ranges == expected);
+            }
+        }
+
+        WHEN("We split them into more ranges than there are combinations") {
+            auto ranges = permutations.split(12U);
+
+            THEN("The surplus ranges should be empty") {
+                REQUIRE(ranges.size() == 12U);
+                REQUIRE(ranges[9U] == Permutations::Range(9U, 10U));
+                REQUIRE(ranges[10U] == Permutations::Range(10U, 10U));
+                REQUIRE(ranges[11U] == Permutations::Range(10U, 10U));
+            }
+        }
+    }
+}
+} // namespace execHelper::core::test
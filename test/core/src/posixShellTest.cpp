@@ -13,6 +13,7 @@
 #include "base-utils/tmpFile.h"
 #include "config/path.h"
 #include "core/posixShell.h"
+#include "core/spawnShell.h"
 #include "core/task.h"
 #include "unittest/catch.h"
 #include "unittest/rapidcheck.h"
@@ -69,12 +70,13 @@ auto searchBinary(const std::string& binary) -> optional<filesystem::path> {
 } // namespace
 
 namespace execHelper::core::test {
-SCENARIO("Test that the right return code is returned", "[shell][posixshell]") {
+TEMPLATE_TEST_CASE("Scenario: Test that the right return code is returned",
+                   "[shell][posixshell]", PosixShell, SpawnShell) {
     propertyTest("An execution engine and a shell",
                  [](PosixShell::ShellReturnCode expectedReturnCode) {
                      IoService ioService;
 
-                     PosixShell shell;
+                     TestType shell;
 
                      ExecutionContent::registerIoService(&ioService);
                      ExecutionContent executionEngine(expectedReturnCode);
@@ -95,12 +97,13 @@ SCENARIO("Test that the right return code is returned", "[shell][posixshell]") {
                  });
 }
 
-SCENARIO("Test that the command is executed the expected number of times",
-         "[shell][posixshell]") {
+TEMPLATE_TEST_CASE("Scenario: Test that the command is executed the expected "
+                   "number of times",
+                   "[shell][posixshell]", PosixShell, SpawnShell) {
     propertyTest("An execution engine and a shell", [](uint8_t nbOfRepeats) {
         IoService ioService;
 
-        PosixShell shell;
+        TestType shell;
 
         ExecutionContent::registerIoService(&ioService);
         ExecutionContent executionEngine(0);
@@ -139,9 +142,10 @@ SCENARIO("Test that the command is executed the expected number of times",
     });
 }
 
-SCENARIO("Test non-existing binaries", "[shell][posixshell]") {
+TEMPLATE_TEST_CASE("Scenario: Test non-existing binaries",
+                   "[shell][posixshell]", PosixShell, SpawnShell) {
     propertyTest("A non-existing file and a shell", [](const TmpFile& file) {
-        PosixShell shell;
+        TestType shell;
 
         THEN_WHEN("We try to execute the given file") {
             Task task({file.toString()});
@@ -154,12 +158,47 @@ SCENARIO("Test non-existing binaries", "[shell][posixshell]") {
     });
 }
 
-SCENARIO("Test the shell for shell expansion", "[shell][posixshell]") {
+TEMPLATE_TEST_CASE("Scenario: Test the resolution of binaries that appear "
+                   "during a run",
+                   "[shell][posixshell]", PosixShell, SpawnShell) {
+    GIVEN("A shell and a binary that does not exist yet") {
+        TestType shell;
+        TmpFile binary;
+
+        Task task({binary.getFilename()});
+        task.setEnvironment(EnvironmentCollection({{"PATH", ""}}));
+        task.setWorkingDirectory(binary.getParentDirectory());
+
+        REQUIRE_THROWS_AS(shell.execute(task),
+                          execHelper::core::PathNotFoundError);
+
+        WHEN("We create the binary and execute it multiple times") {
+            const PosixShell::ShellReturnCode expectedReturnCode = 3U;
+            REQUIRE(binary.create(string("#!/bin/sh\nexit ")
+                                      .append(std::to_string(
+                                          expectedReturnCode))
+                                      .append("\n")));
+            filesystem::permissions(binary.getPath(),
+                                    filesystem::perms::owner_all);
+
+            auto first = shell.execute(task);
+            auto second = shell.execute(task);
+
+            THEN("The binary should be found every time") {
+                REQUIRE(first == expectedReturnCode);
+                REQUIRE(second == expectedReturnCode);
+            }
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("Scenario: Test the shell for shell expansion",
+                   "[shell][posixshell]", PosixShell, SpawnShell) {
     propertyTest(
         "An execution engine and a shell", [](const uint32_t randomExpansion) {
             IoService ioService;
 
-            PosixShell shell;
+            TestType shell;
 
             ExecutionContent::registerIoService(&ioService);
             ExecutionContent executionEngine(0);
@@ -191,7 +230,8 @@ SCENARIO("Test the shell for shell expansion", "[shell][posixshell]") {
         });
 }
 
-SCENARIO("Test the shell for word expansion", "[shell][posixshell]") {
+TEMPLATE_TEST_CASE("Scenario: Test the shell for word expansion",
+                   "[shell][posixshell]", PosixShell, SpawnShell) {
     propertyTest(
         "An execution engine and a shell",
         [](const std::string& shellExpansion) {
@@ -199,7 +239,7 @@ SCENARIO("Test the shell for word expansion", "[shell][posixshell]") {
             IoService ioService;
 
             EnvironmentCollection env = {{"EXPANSION", shellExpansion}};
-            PosixShell shell;
+            TestType shell;
 
             ExecutionContent::registerIoService(&ioService);
             ExecutionContent executionEngine(0);
@@ -229,12 +269,13 @@ SCENARIO("Test the shell for word expansion", "[shell][posixshell]") {
         });
 }
 
-SCENARIO("Test the shell for binaries prefixed with an absolute path",
-         "[shell][posixshell]") {
+TEMPLATE_TEST_CASE("Scenario: Test the shell for binaries prefixed with an "
+                   "absolute path",
+                   "[shell][posixshell]", PosixShell, SpawnShell) {
     propertyTest("An execution engine and a shell", []() {
         IoService ioService;
 
-        PosixShell shell;
+        TestType shell;
 
         ExecutionContent::registerIoService(&ioService);
         ExecutionContent executionEngine(0);
@@ -268,12 +309,13 @@ SCENARIO("Test the shell for binaries prefixed with an absolute path",
     });
 }
 
-SCENARIO("Test the shell for binaries prefixed with a relative path",
-         "[shell][posixshell]") {
+TEMPLATE_TEST_CASE("Scenario: Test the shell for binaries prefixed with a "
+                   "relative path",
+                   "[shell][posixshell]", PosixShell, SpawnShell) {
     propertyTest("An execution engine and a shell", []() {
         IoService ioService;
 
-        PosixShell shell;
+        TestType shell;
 
         ExecutionContent::registerIoService(&ioService);
         ExecutionContent executionEngine(0);
@@ -308,12 +350,13 @@ SCENARIO("Test the shell for binaries prefixed with a relative path",
     });
 }
 
-SCENARIO("Test the shell for binaries found in the task environment path",
-         "[shell][posixshell]") {
+TEMPLATE_TEST_CASE("Scenario: Test the shell for binaries found in the task "
+                   "environment path",
+                   "[shell][posixshell]", PosixShell, SpawnShell) {
     propertyTest("An execution engine and a shell", []() {
         IoService ioService;
 
-        PosixShell shell;
+        TestType shell;
 
         ExecutionContent::registerIoService(&ioService);
         ExecutionContent executionEngine(0);
@@ -353,13 +396,13 @@ SCENARIO("Test the shell for binaries found in the task environment path",
     });
 }
 
-SCENARIO("Test the shell for binaries found in the working directory but not "
-         "in the path",
-         "[shell][posixshell]") {
+TEMPLATE_TEST_CASE("Scenario: Test the shell for binaries found in the working "
+                   "directory but not in the path",
+                   "[shell][posixshell]", PosixShell, SpawnShell) {
     propertyTest("An execution engine and a shell", []() {
         IoService ioService;
 
-        PosixShell shell;
+        TestType shell;
 
         ExecutionContent::registerIoService(&ioService);
         ExecutionContent executionEngine(0);
@@ -397,14 +440,15 @@ SCENARIO("Test the shell for binaries found in the working directory but not "
     });
 }
 
-SCENARIO("The shell should properly set the PWD environment variable",
-         "[shell][posixShell]") {
+TEMPLATE_TEST_CASE("Scenario: The shell should properly set the PWD "
+                   "environment variable",
+                   "[shell][posixShell]", PosixShell, SpawnShell) {
     propertyTest(
         "An execution engine, a shell, a working dir and an initial value",
         [](const Path& workingDir, std::string&& initialValue) {
             IoService ioService;
 
-            PosixShell shell;
+            TestType shell;
 
             ExecutionContent::registerIoService(&ioService);
             ExecutionContent executionEngine(0);
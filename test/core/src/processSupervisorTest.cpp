@@ -0,0 +1,129 @@
+#include <chrono>
+#include <optional>
+#include <string>
+
+#include "core/processSupervisor.h"
+#include "unittest/catch.h"
+
+using std::optional;
+using std::string;
+using std::string_view;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+using execHelper::config::EnvironmentCollection;
+using execHelper::config::Path;
+
+namespace {
+const Path SHELL("/bin/sh");
+} // namespace
+
+namespace execHelper::core::test {
+SCENARIO("Test the return codes of supervised processes",
+         "[ProcessSupervisor]") {
+    GIVEN("A process supervisor") {
+        ProcessSupervisor supervisor;
+        optional<Shell::ShellReturnCode> returnCode;
+        auto onExit = [&returnCode](Shell::ShellReturnCode code) {
+            returnCode = code;
+        };
+
+        WHEN("We spawn a process that exits with a specific return code") {
+            supervisor.spawn(SHELL, {"-c", "exit 3"}, Path("/"),
+                             EnvironmentCollection(), onExit);
+            REQUIRE(supervisor.size() == 1U);
+            supervisor.run();
+
+            THEN("The return code should be reported") {
+                REQUIRE(returnCode == 3U);
+                REQUIRE(supervisor.size() == 0U);
+            }
+        }
+
+        WHEN("We spawn a process that gets killed by a signal") {
+            supervisor.spawn(SHELL, {"-c", "kill -9 $$"}, Path("/"),
+                             EnvironmentCollection(), onExit);
+            supervisor.run();
+
+            THEN("The signal should be reported like a shell does") {
+                REQUIRE(returnCode == 128U + 9U);
+            }
+        }
+
+        WHEN("We spawn a binary that does not exist") {
+            supervisor.spawn(Path("/non/existing/binary"), {}, Path("/"),
+                             EnvironmentCollection(), onExit);
+            supervisor.run();
+
+            THEN("It should report that executing it failed") {
+                REQUIRE(returnCode == 127U);
+            }
+        }
+    }
+}
+
+SCENARIO("Test capturing the output of supervised processes",
+         "[ProcessSupervisor]") {
+    GIVEN("A process supervisor") {
+        ProcessSupervisor supervisor;
+        string out;
+        string err;
+        auto onOutput = [&out, &err](ProcessSupervisor::OutputStream stream,
+                                     string_view output) {
+            if(stream == ProcessSupervisor::OutputStream::out) {
+                out.append(output);
+            } else {
+                err.append(output);
+            }
+        };
+
+        WHEN("We spawn a process in a specific environment and directory") {
+            bool exited = false;
+            supervisor.spawn(
+                SHELL, {"-c", "echo \"$GREETING\"; pwd; echo oops >&2"},
+                Path("/"), EnvironmentCollection({{"GREETING", "hello"}}),
+                [&exited, &out](Shell::ShellReturnCode /*code*/) {
+                    exited = true;
+                    REQUIRE(out == "hello\n/\n"); // All output is delivered first
+                },
+                onOutput);
+            supervisor.run();
+
+            THEN("Its output should be captured per stream") {
+                REQUIRE(exited);
+                REQUIRE(out == "hello\n/\n");
+                REQUIRE(err == "oops\n");
+            }
+        }
+    }
+}
+
+SCENARIO("Test supervising concurrent processes", "[ProcessSupervisor]") {
+    GIVEN("A process supervisor") {
+        ProcessSupervisor supervisor;
+        const size_t nbOfProcesses = 8U;
+        size_t nbOfExited = 0U;
+
+        WHEN("We spawn multiple processes at once") {
+            auto start = steady_clock::now();
+            for(size_t i = 0U; i < nbOfProcesses; ++i) {
+                supervisor.spawn(
+                    SHELL, {"-c", "sleep 0.5"}, Path("/"),
+                    EnvironmentCollection(),
+                    [&nbOfExited](Shell::ShellReturnCode /*code*/) {
+                        ++nbOfExited;
+                    });
+            }
+            REQUIRE(supervisor.size() == nbOfProcesses);
+            REQUIRE(supervisor.poll(milliseconds(0)) == 0U);
+            supervisor.run();
+            auto duration = steady_clock::now() - start;
+
+            THEN("They should all be supervised at the same time") {
+                REQUIRE(nbOfExited == nbOfProcesses);
+                REQUIRE(duration < milliseconds(500U * nbOfProcesses / 2U));
+            }
+        }
+    }
+}
+} // namespace execHelper::core::test
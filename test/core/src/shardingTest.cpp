@@ -0,0 +1,156 @@
+#include <string>
+#include <vector>
+
+#include "base-utils/tmpFile.h"
+#include "config/path.h"
+#include "core/durations.h"
+#include "core/sharding.h"
+#include "core/task.h"
+#include "unittest/catch.h"
+
+#include "executorStub.h"
+
+using std::string;
+using std::to_string;
+using std::vector;
+
+using execHelper::config::Path;
+using execHelper::core::test::ExecutorStub;
+using execHelper::test::baseUtils::TmpFile;
+
+namespace {
+auto getTasks(size_t nbOfTasks) -> ExecutorStub::TaskQueue {
+    ExecutorStub::TaskQueue tasks;
+    for(size_t i = 0U; i < nbOfTasks; ++i) {
+        tasks.emplace_back(execHelper::core::Task({"task", to_string(i)}));
+    }
+    return tasks;
+}
+
+auto toString(const execHelper::core::Task& task) -> string {
+    return task.toString();
+}
+
+auto executeShards(const ExecutorStub::TaskQueue& tasks, size_t nbOfShards,
+                   const execHelper::core::Durations& durations)
+    -> vector<ExecutorStub::TaskQueue> {
+    vector<ExecutorStub::TaskQueue> shards;
+    for(size_t index = 0U; index < nbOfShards; ++index) {
+        ExecutorStub executor;
+        execHelper::core::ShardedExecutor sharded(
+            executor, execHelper::core::Shard{index, nbOfShards}, durations,
+            toString);
+        for(const auto& task : tasks) {
+            sharded.execute(task);
+        }
+        shards.push_back(executor.getExecutedTasks());
+    }
+    return shards;
+}
+} // namespace
+
+namespace execHelper::core::test {
+SCENARIO("Parse shard specifications", "[sharding]") {
+    GIVEN("Valid shard specifications") {
+        THEN("They should be parsed into a zero-based shard") {
+            auto shard = parseShard("1/1");
+            REQUIRE(shard.index == 0U);
+            REQUIRE(shard.count == 1U);
+
+            shard = parseShard("3/4");
+            REQUIRE(shard.index == 2U);
+            REQUIRE(shard.count == 4U);
+        }
+    }
+
+    GIVEN("Invalid shard specifications") {
+        THEN("Parsing them should throw") {
+            REQUIRE_THROWS_AS(parseShard("1"), InvalidShardError);
+            REQUIRE_THROWS_AS(parseShard("0/2"), InvalidShardError);
+            REQUIRE_THROWS_AS(parseShard("3/2"), InvalidShardError);
+            REQUIRE_THROWS_AS(parseShard("1/0"), InvalidShardError);
+            REQUIRE_THROWS_AS(parseShard("a/2"), InvalidShardError);
+            REQUIRE_THROWS_AS(parseShard("1/2x"), InvalidShardError);
+            REQUIRE_THROWS_AS(parseShard("/2"), InvalidShardError);
+        }
+    }
+
+    GIVEN("Shard specifications with a very large number of shards") {
+        THEN("Parsing them should throw") {
+            REQUIRE_THROWS_AS(
+                parseShard("1/" + to_string(MAX_SHARD_COUNT + 1U)),
+                InvalidShardError);
+            REQUIRE_THROWS_AS(parseShard("1/18446744073709551615"),
+                              InvalidShardError);
+            REQUIRE_THROWS_AS(parseShard("1/18446744073709551616"),
+                              InvalidShardError);
+        }
+
+        THEN("The maximum number of shards should be parsed") {
+            const auto shard = parseShard("1/" + to_string(MAX_SHARD_COUNT));
+            REQUIRE(shard.count == MAX_SHARD_COUNT);
+        }
+    }
+}
+
+SCENARIO("Split tasks over multiple shards", "[sharding]") {
+    GIVEN("A number of tasks and no recorded durations") {
+        const auto tasks = getTasks(10U);
+
+        WHEN("We execute every shard") {
+            auto shards = executeShards(tasks, 3U, {});
+
+            THEN("The tasks should be divided round robin") {
+                REQUIRE(shards[0].size() == 4U);
+                REQUIRE(shards[1].size() == 3U);
+                REQUIRE(shards[2].size() == 3U);
+                for(size_t i = 0U; i < tasks.size(); ++i) {
+                    REQUIRE(shards[i % 3U][i / 3U] == tasks[i]);
+                }
+            }
+        }
+    }
+
+    GIVEN("A number of tasks with recorded durations") {
+        const auto tasks = getTasks(4U);
+        const Durations durations(
+            {{"task 0", 10.0}, {"task 1", 1.0}, {"task 2", 1.0}});
+
+        WHEN("We execute every shard") {
+            auto shards = executeShards(tasks, 2U, durations);
+
+            THEN("The tasks should be divided by their durations") {
+                REQUIRE(shards[0] == ExecutorStub::TaskQueue({tasks[0]}));
+                REQUIRE(shards[1] == ExecutorStub::TaskQueue(
+                                         {tasks[1], tasks[2], tasks[3]}));
+            }
+        }
+    }
+}
+
+SCENARIO("Read and write task durations", "[sharding]") {
+    GIVEN("Durations with special characters in their keys") {
+        const Durations durations({{"task 0", 1.5},
+                                   {"sh -c 'echo a\nb'", 0.25},
+                                   {R"(back\slash)", 2.0}});
+        TmpFile file;
+
+        WHEN("We write and read them") {
+            REQUIRE(writeDurations(file.getPath(), durations));
+            auto read = readDurations(file.getPath());
+
+            THEN("We should get the same durations") {
+                REQUIRE(read == durations);
+            }
+        }
+    }
+
+    GIVEN("A file that does not exist") {
+        TmpFile file;
+
+        THEN("There should be no durations") {
+            REQUIRE(readDurations(file.getPath()).empty());
+        }
+    }
+}
+} // namespace execHelper::core::test
@@ -0,0 +1,90 @@
+#include <string>
+#include <vector>
+
+#include "core/taskGraph.h"
+#include "unittest/catch.h"
+
+using std::string;
+using std::vector;
+
+namespace execHelper::core::test {
+SCENARIO("Test the stages of a task graph", "[TaskGraph]") {
+    GIVEN("A task graph without dependencies") {
+        TaskGraph graph;
+        const auto first = graph.addNode("first", {Task({"task1"})});
+        const auto second =
+            graph.addNode("second", {Task({"task2"}), Task({"task3"})});
+
+        WHEN("We request the stages of the graph") {
+            const auto stages = graph.getStages();
+
+            THEN("All nodes are in a single stage in the order they were "
+                 "added") {
+                REQUIRE(stages == TaskGraph::Stages({{first, second}}));
+            }
+
+            THEN("The tasks keep the order in which they were added") {
+                REQUIRE(graph.getTasks() == Tasks({Task({"task1"}),
+                                                   Task({"task2"}),
+                                                   Task({"task3"})}));
+            }
+        }
+    }
+
+    GIVEN("A task graph with a diamond shaped dependency") {
+        TaskGraph graph;
+        const auto package = graph.addNode("package", {Task({"package"})});
+        const auto test = graph.addNode("test", {Task({"test"})});
+        const auto lint = graph.addNode("lint", {Task({"lint"})});
+        const auto build = graph.addNode("build", {Task({"build"})});
+
+        graph.addDependency(package, test);
+        graph.addDependency(package, lint);
+        graph.addDependency(test, build);
+        graph.addDependency(lint, build);
+        graph.addDependency(lint, build);
+
+        WHEN("We request the stages of the graph") {
+            const auto stages = graph.getStages();
+
+            THEN("Every node comes after the nodes it depends on") {
+                REQUIRE(stages ==
+                        TaskGraph::Stages({{build}, {test, lint}, {package}}));
+            }
+
+            THEN("The tasks are ordered accordingly") {
+                REQUIRE(graph.getTasks() ==
+                        Tasks({Task({"build"}), Task({"test"}), Task({"lint"}),
+                               Task({"package"})}));
+            }
+        }
+
+        WHEN("We replace the tasks of a node") {
+            graph.setTasks(build, {Task({"configure"}), Task({"compile"})});
+
+            THEN("The new tasks are returned for the node") {
+                REQUIRE(graph.getTasks(build) ==
+                        Tasks({Task({"configure"}), Task({"compile"})}));
+                REQUIRE(graph.getName(build) == "build");
+            }
+        }
+    }
+
+    GIVEN("A task graph with a cyclic dependency") {
+        TaskGraph graph;
+        const auto first = graph.addNode("first");
+        const auto second = graph.addNode("second");
+        const auto third = graph.addNode("third");
+        graph.addDependency(second, first);
+        graph.addDependency(second, third);
+        graph.addDependency(third, second);
+
+        WHEN("We request the stages of the graph") {
+            THEN("It should report the cycle") {
+                REQUIRE_THROWS_AS(graph.getStages(), CyclicDependencyError);
+                REQUIRE_THROWS_AS(graph.getTasks(), CyclicDependencyError);
+            }
+        }
+    }
+}
+} // namespace execHelper::core::test
@@ -1,4 +1,5 @@
 #include <filesystem>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -274,6 +275,57 @@ SCENARIO("Test the comparison operators", "[task]") {
         }
     }
 }
+SCENARIO("Test the inherited environment of a task", "[task]") {
+    GIVEN("A task that inherits an environment") {
+        const auto inherited = std::make_shared<const EnvironmentCollection>(
+            EnvironmentCollection({{"INHERITED", "inherited-value"},
+                                   {"OVERRIDDEN", "inherited-value"}}));
+        const Path workingDirectory("/tmp");
+
+        Task task({"task1"}, EnvironmentCollection(), workingDirectory);
+        task.setInheritedEnvironment(inherited);
+
+        WHEN("We set variables for the task and copy it") {
+            task.appendToEnvironment(
+                EnvironmentValue("OVERRIDDEN", "task-value"));
+            const Task copy(task); // NOLINT(performance-unnecessary-copy-initialization)
+
+            THEN("The inherited environment should be shared") {
+                REQUIRE(copy.getInheritedEnvironment() == inherited);
+                REQUIRE(*inherited ==
+                        EnvironmentCollection(
+                            {{"INHERITED", "inherited-value"},
+                             {"OVERRIDDEN", "inherited-value"}}));
+            }
+
+            THEN("Only the variables set for the task should be returned") {
+                REQUIRE(copy.getEnvironment() ==
+                        EnvironmentCollection(
+                            {{"OVERRIDDEN", "task-value"},
+                             {"PWD", filesystem::absolute(workingDirectory)
+                                         .string()}}));
+            }
+
+            THEN("The variables set for the task should override the "
+                 "inherited ones") {
+                REQUIRE(copy.getFullEnvironment() ==
+                        EnvironmentCollection(
+                            {{"INHERITED", "inherited-value"},
+                             {"OVERRIDDEN", "task-value"},
+                             {"PWD", filesystem::absolute(workingDirectory)
+                                         .string()}}));
+            }
+
+            THEN("It should equal a task with the same complete environment") {
+                Task flattened({"task1"}, copy.getFullEnvironment(),
+                               workingDirectory);
+                REQUIRE(copy == flattened);
+                REQUIRE_FALSE(copy != flattened);
+            }
+        }
+    }
+}
+
 SCENARIO("Test the streaming operator", "[task]") {
     GIVEN("An empty stream and a task") {
         stringstream stream;
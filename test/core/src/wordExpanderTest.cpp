@@ -0,0 +1,253 @@
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base-utils/tmpFile.h"
+#include "config/environment.h"
+#include "core/task.h"
+#include "core/wordExpander.h"
+#include "unittest/catch.h"
+
+using std::string;
+using std::thread;
+using std::vector;
+
+using execHelper::config::EnvironmentCollection;
+using execHelper::test::baseUtils::TmpFile;
+
+namespace filesystem = std::filesystem;
+
+namespace {
+auto expand(const string& word, const EnvironmentCollection& env = {})
+    -> execHelper::core::TaskCollection {
+    execHelper::core::TaskCollection expanded;
+    execHelper::core::expandWord(word, env, &expanded);
+    return expanded;
+}
+} // namespace
+
+namespace execHelper::core::test {
+SCENARIO("Expand words without special characters", "[word-expander]") {
+    GIVEN("A word without special characters") {
+        const string word("--some-option=value");
+
+        WHEN("We expand the word") {
+            auto expanded = expand(word);
+
+            THEN("It should be returned as is") {
+                REQUIRE(expanded == TaskCollection({word}));
+            }
+        }
+    }
+
+    GIVEN("An empty word") {
+        WHEN("We expand the word") {
+            auto expanded = expand("");
+
+            THEN("It should not result in any field") {
+                REQUIRE(expanded.empty());
+            }
+        }
+    }
+}
+
+SCENARIO("Expand quoted and unquoted words", "[word-expander]") {
+    GIVEN("Words with quotes, escapes and blanks") {
+        WHEN("We expand them") {
+            THEN("Quotes and escapes should be removed") {
+                REQUIRE(expand("'single quoted'") ==
+                        TaskCollection({"single quoted"}));
+                REQUIRE(expand(R"("double quoted")") ==
+                        TaskCollection({"double quoted"}));
+                REQUIRE(expand(R"(escaped\ blank)") ==
+                        TaskCollection({"escaped blank"}));
+                REQUIRE(expand(R"("")") == TaskCollection({""}));
+            }
+
+            THEN("Unquoted blanks should separate fields") {
+                REQUIRE(expand("exit  7") == TaskCollection({"exit", "7"}));
+            }
+        }
+    }
+}
+
+SCENARIO("Expand variables", "[word-expander]") {
+    GIVEN("An environment") {
+        const EnvironmentCollection env(
+            {{"NAME", "value"}, {"SPACED", " two  fields "}, {"EMPTY", ""}});
+
+        WHEN("We expand words referring to the environment") {
+            THEN("The variables should be replaced by their values") {
+                REQUIRE(expand("$NAME", env) == TaskCollection({"value"}));
+                REQUIRE(expand("${NAME}-suffix", env) ==
+                        TaskCollection({"value-suffix"}));
+                REQUIRE(expand(R"("$NAME is $EMPTY")", env) ==
+                        TaskCollection({"value is "}));
+            }
+
+            THEN("Unquoted values should be split into fields") {
+                REQUIRE(expand("$SPACED", env) ==
+                        TaskCollection({"two", "fields"}));
+                REQUIRE(expand(R"("$SPACED")", env) ==
+                        TaskCollection({" two  fields "}));
+                REQUIRE(expand("$EMPTY", env).empty());
+            }
+
+            THEN("Single quoted variables should not be expanded") {
+                REQUIRE(expand("'$NAME'", env) == TaskCollection({"$NAME"}));
+            }
+        }
+
+        WHEN("We use a custom field separator") {
+            EnvironmentCollection customEnv(env);
+            customEnv.emplace("IFS", ":");
+            customEnv.emplace("LIST", "a::b");
+
+            THEN("The values should be split on the custom separator") {
+                REQUIRE(expand("$LIST", customEnv) ==
+                        TaskCollection({"a", "", "b"}));
+            }
+        }
+    }
+}
+
+SCENARIO("Expand tildes and globs", "[word-expander]") {
+    GIVEN("A home directory and a file") {
+        const EnvironmentCollection env({{"HOME", "/home/exec-helper"}});
+        TmpFile file;
+        REQUIRE(file.create());
+        const auto directory = file.getParentDirectory();
+
+        WHEN("We expand a tilde") {
+            THEN("It should be replaced by the home directory") {
+                REQUIRE(expand("~/config", env) ==
+                        TaskCollection({"/home/exec-helper/config"}));
+                REQUIRE(expand("'~'/config", env) ==
+                        TaskCollection({"~/config"}));
+                REQUIRE(expand("first ~/config", env) ==
+                        TaskCollection({"first", "/home/exec-helper/config"}));
+            }
+
+            THEN("It should be expanded in the value of an assignment") {
+                REQUIRE(expand("a=~/x", env) ==
+                        TaskCollection({"a=/home/exec-helper/x"}));
+                REQUIRE(expand("a=b:~/x", env) ==
+                        TaskCollection({"a=b:/home/exec-helper/x"}));
+                REQUIRE(expand("~:x", env) ==
+                        TaskCollection({"/home/exec-helper:x"}));
+            }
+
+            THEN("It should be taken literally elsewhere") {
+                REQUIRE(expand("a~/x", env) == TaskCollection({"a~/x"}));
+                REQUIRE(expand("b:~/x", env) == TaskCollection({"b:~/x"}));
+                REQUIRE(expand("x a=~/y", env) ==
+                        TaskCollection({"x", "a=~/y"}));
+            }
+        }
+
+        WHEN("We expand a pattern") {
+            auto pattern = filesystem::path(directory) /
+                           (file.getFilename().substr(0U, 3U) + "*");
+
+            THEN("It should be replaced by the matching paths") {
+                auto expanded = expand(pattern.string());
+                REQUIRE(std::find(expanded.begin(), expanded.end(),
+                                  file.toString()) != expanded.end());
+            }
+
+            THEN("A quoted pattern should be taken literally") {
+                REQUIRE(expand("'" + pattern.string() + "'") ==
+                        TaskCollection({pattern.string()}));
+            }
+
+            THEN("A pattern without matches should be taken literally") {
+                REQUIRE(expand(directory + "/*.does-not-exist") ==
+                        TaskCollection({directory + "/*.does-not-exist"}));
+            }
+        }
+    }
+}
+
+SCENARIO("Expand substitutions", "[word-expander]") {
+    GIVEN("An environment") {
+        const EnvironmentCollection env({{"NAME", "value"}, {"EMPTY", ""}});
+
+        WHEN("We expand command substitutions and arithmetic expansions") {
+            THEN("They should be replaced by their results") {
+                REQUIRE(expand(R"word("$(echo "$NAME")")word", env) ==
+                        TaskCollection({"value"}));
+                REQUIRE(expand("`echo two fields`", env) ==
+                        TaskCollection({"two", "fields"}));
+                REQUIRE(expand("$((1 + 2))", env) == TaskCollection({"3"}));
+                REQUIRE(expand("${EMPTY:-default}", env) ==
+                        TaskCollection({"default"}));
+                REQUIRE(expand("${#NAME}", env) == TaskCollection({"5"}));
+            }
+        }
+
+        WHEN("We expand words with a '#' that starts a shell word") {
+            THEN("The '#' should be taken literally") {
+                REQUIRE(expand("#a$(echo hi)", env) ==
+                        TaskCollection({"#ahi"}));
+                REQUIRE(expand("$NAME #$((1 + 2))", env) ==
+                        TaskCollection({"value", "#3"}));
+                REQUIRE(expand("'#'$(echo hi)", env) ==
+                        TaskCollection({"#hi"}));
+            }
+        }
+    }
+}
+
+SCENARIO("Reject words that can not be expanded", "[word-expander]") {
+    GIVEN("Invalid words") {
+        WHEN("We expand them") {
+            THEN("It should throw") {
+                REQUIRE_THROWS_AS(expand("$UNDEFINED"), WordExpansionError);
+                REQUIRE_THROWS_AS(expand("${UNDEFINED:-default}"),
+                                  WordExpansionError);
+                REQUIRE_THROWS_AS(expand("${UNDEFINED-default}"),
+                                  WordExpansionError);
+                REQUIRE_THROWS_AS(expand("${#UNDEFINED}"), WordExpansionError);
+                REQUIRE_THROWS_AS(expand("a;b"), WordExpansionError);
+                REQUIRE_THROWS_AS(expand("a|b"), WordExpansionError);
+                REQUIRE_THROWS_AS(expand("'unterminated"),
+                                  WordExpansionError);
+                REQUIRE_THROWS_AS(expand("$(unterminated"),
+                                  WordExpansionError);
+            }
+        }
+    }
+}
+
+SCENARIO("Expand words concurrently", "[word-expander]") {
+    GIVEN("Multiple threads with a different environment") {
+        const size_t nbOfThreads = 8U;
+        vector<TaskCollection> results(nbOfThreads);
+
+        WHEN("Every thread expands the same word") {
+            vector<thread> threads;
+            for(size_t i = 0U; i < nbOfThreads; ++i) {
+                threads.emplace_back([i, &results]() {
+                    const EnvironmentCollection env(
+                        {{"VALUE", std::to_string(i)}});
+                    for(size_t j = 0U; j < 100U; ++j) {
+                        results[i] = expand("prefix-$VALUE", env);
+                    }
+                });
+            }
+            for(auto& worker : threads) {
+                worker.join();
+            }
+
+            THEN("Every thread should have used its own environment") {
+                for(size_t i = 0U; i < nbOfThreads; ++i) {
+                    REQUIRE(results[i] ==
+                            TaskCollection({"prefix-" + std::to_string(i)}));
+                }
+            }
+        }
+    }
+}
+} // namespace execHelper::core::test
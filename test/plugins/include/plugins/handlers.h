@@ -3,14 +3,20 @@
 
 #include <algorithm>
 #include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "config/environment.h"
 #include "config/settingsNode.h"
 #include "core/task.h"
 #include "plugins/commandLine.h"
+#include "plugins/luaPlugin.h"
+#include "plugins/nativePlugins.h"
 
 #include "plugins/plugin.h"
 #include "unittest/catch.h"
+#include "unittest/config.h"
 
 namespace execHelper::plugins::test {
 inline void handleEnvironment(const config::EnvironmentCollection& environment,
@@ -73,6 +79,31 @@ mapToMemories(const std::vector<std::string>& values) noexcept {
                    });
     return plugins;
 }
+
+/**
+ * Returns every implementation of the given plugin that is shipped with
+ * exec-helper: its lua script and, if it has one, its native implementation
+ *
+ * \param[in] name  The name of the plugin
+ * \returns The implementations of the plugin
+ */
+[[nodiscard]] inline auto getImplementations(const std::string& name)
+    -> std::vector<ApplyFunction> {
+    std::vector<ApplyFunction> implementations(
+        {[script = std::filesystem::path(PLUGINS_INSTALL_PATH) /
+                   (name + ".lua")](core::Task task,
+                                    const config::VariablesMap& variables,
+                                    const ExecutionContext& context) {
+            return luaPlugin(std::move(task), variables, context, script);
+        }});
+
+    const auto& nativePlugins = getNativePlugins();
+    auto native = nativePlugins.find(name);
+    if(native != nativePlugins.end()) {
+        implementations.push_back(native->second);
+    }
+    return implementations;
+}
 } // namespace execHelper::plugins::test
 
 #endif /* HANDLERS_INCLUDE */
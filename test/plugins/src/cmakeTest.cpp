@@ -10,7 +10,6 @@
 #include "config/patternsHandler.h"
 #include "config/settingsNode.h"
 #include "config/variablesMap.h"
-#include "plugins/luaPlugin.h"
 
 #include "unittest/catch.h"
 #include "unittest/config.h"
@@ -213,12 +212,12 @@ SCENARIO("Testing the configuration settings of the cmake plugin", "[cmake]") {
             }
 
             THEN_WHEN("We apply the plugin") {
-                auto actualTasks =
-                    luaPlugin(task, config, context,
-                              std::string(PLUGINS_INSTALL_PATH) + "/cmake.lua");
+                for(const auto& plugin : getImplementations("cmake")) {
+                    auto actualTasks = plugin(task, config, context);
 
-                THEN_CHECK("It generated the expected tasks") {
-                    REQUIRE(Tasks({expectedTask}) == actualTasks);
+                    THEN_CHECK("It generated the expected tasks") {
+                        REQUIRE(Tasks({expectedTask}) == actualTasks);
+                    }
                 }
             }
         });
@@ -244,10 +243,10 @@ SCENARIO("Set a wrong mode", "[cmake]") {
 
         THEN_WHEN("We apply the plugin") {
             THEN_CHECK("It throws a runtime error") {
-                REQUIRE_THROWS_AS(
-                    luaPlugin(task, config, context,
-                              std::string(PLUGINS_INSTALL_PATH) + "/cmake.lua"),
-                    runtime_error);
+                for(const auto& plugin : getImplementations("cmake")) {
+                    REQUIRE_THROWS_AS(plugin(task, config, context),
+                                      runtime_error);
+                }
             }
         }
     });
@@ -115,6 +115,36 @@ SCENARIO("Testing the default execute settings", "[execute-plugin]") {
     }
 }
 
+SCENARIO("Test streaming the resolved tasks to a sink", "[execute-plugin]") {
+    GIVEN("A context with a sink and a command resolving to multiple plugins") {
+        const Command command("a-command");
+        const CommandCollection memories({"memory1", "memory2"});
+
+        SettingsNode settings(PLUGIN_NAME);
+        REQUIRE(settings.add(command, memories));
+
+        const FleetingOptionsStub options;
+        const auto plugins = mapToMemories(memories);
+        const PatternsHandler patternsHandler;
+
+        vector<Task> sunkTasks;
+        const ExecutionContext context(
+            options, settings, patternsHandler, plugins,
+            [&sunkTasks](Task task) { sunkTasks.emplace_back(move(task)); });
+
+        WHEN("We resolve the command") {
+            Task task({"task"});
+            auto actualTasks = executeCommands({command}, task, context);
+
+            THEN("Every resolved task is handed over to the sink") {
+                REQUIRE(sunkTasks == vector<Task>({task, task}));
+            }
+
+            THEN("No tasks are returned") { REQUIRE(actualTasks.empty()); }
+        }
+    }
+}
+
 SCENARIO("Test the settings node to variables map mapping",
          "[execute-plugin]") {
     const auto plugins = mapToMemories({"memory"s});
@@ -0,0 +1,318 @@
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "config/patternsHandler.h"
+#include "config/settingsNode.h"
+#include "config/variablesMap.h"
+#include "core/task.h"
+#include "plugins/executionContext.h"
+#include "plugins/luaPlugin.h"
+
+#include "base-utils/tmpFile.h"
+#include "unittest/catch.h"
+
+#include "fleetingOptionsStub.h"
+
+using std::ifstream;
+using std::istreambuf_iterator;
+using std::runtime_error;
+using std::string;
+using std::thread;
+using std::vector;
+
+using execHelper::config::PatternsHandler;
+using execHelper::config::SettingsNode;
+using execHelper::config::VariablesMap;
+using execHelper::core::Task;
+using execHelper::core::Tasks;
+
+using execHelper::test::FleetingOptionsStub;
+using execHelper::test::baseUtils::TmpFile;
+
+namespace filesystem = std::filesystem;
+
+namespace {
+auto readFile(const filesystem::path& file) -> string {
+    ifstream stream(file, std::ios::binary);
+    return string((istreambuf_iterator<char>(stream)),
+                  istreambuf_iterator<char>());
+}
+} // namespace
+
+namespace execHelper::plugins::test {
+SCENARIO("Consecutive invocations of lua plugins do not influence each other",
+         "[lua-plugin]") {
+    GIVEN("A script that leaves globals behind and a script that uses them") {
+        FleetingOptionsStub options;
+        SettingsNode settings("lua-plugin-test");
+        PatternsHandler patterns;
+        Plugins plugins;
+        const ExecutionContext context(options, settings, patterns, plugins);
+
+        TmpFile polluting("polluting-%%%%.lua");
+        REQUIRE(polluting.create("leaked = 'leaked'\n"
+                                 "list = nil\n"
+                                 "task:add_args({'polluting'})\n"
+                                 "register_task(task)\n"));
+
+        TmpFile checking("checking-%%%%.lua");
+        REQUIRE(checking.create("task:add_args({leaked or 'clean'})\n"
+                                "task:add_args(list(config['args']) or {})\n"
+                                "register_task(task)\n"));
+
+        VariablesMap config("lua-plugin-test");
+        REQUIRE(config.add("args", vector<string>({"arg1", "arg2"})));
+
+        Task expectedTask({"clean", "arg1", "arg2"});
+
+        WHEN("We run the scripts after each other") {
+            for(auto i = 0U; i < 3U; ++i) {
+                REQUIRE(luaPlugin(Task(), config, context,
+                                  polluting.getPath()) ==
+                        Tasks({Task({"polluting"})}));
+                REQUIRE(luaPlugin(Task(), config, context,
+                                  checking.getPath()) == Tasks({expectedTask}));
+            }
+        }
+
+        WHEN("We run the scripts concurrently") {
+            const auto nbOfThreads = 4U;
+            vector<Tasks> actualTasks(nbOfThreads);
+            vector<thread> threads;
+            threads.reserve(nbOfThreads);
+            for(auto i = 0U; i < nbOfThreads; ++i) {
+                threads.emplace_back([&, i]() {
+                    for(auto j = 0U; j < 10U; ++j) {
+                        (void)luaPlugin(Task(), config, context,
+                                        polluting.getPath());
+                        actualTasks[i] = luaPlugin(Task(), config, context,
+                                                   checking.getPath());
+                    }
+                });
+            }
+            for(auto& runner : threads) {
+                runner.join();
+            }
+
+            THEN("Every invocation must see the pristine helper library") {
+                for(const auto& tasks : actualTasks) {
+                    REQUIRE(tasks == Tasks({expectedTask}));
+                }
+            }
+        }
+    }
+
+    GIVEN("A script that modifies the standard library and a script that uses "
+          "it") {
+        FleetingOptionsStub options;
+        SettingsNode settings("lua-plugin-test");
+        PatternsHandler patterns;
+        Plugins plugins;
+        const ExecutionContext context(options, settings, patterns, plugins);
+
+        TmpFile polluting("polluting-%%%%.lua");
+        REQUIRE(polluting.create(
+            "task:add_args({'polluting'})\n"
+            "register_task(task)\n"
+            "string.leaked = 'leaked'\n"
+            "string.upper = string.lower\n"
+            "table.insert = nil\n"
+            "getmetatable('').__index = {}\n"
+            "setmetatable(_G, {__index = function() return 'leaked' end})\n"));
+
+        TmpFile checking("checking-%%%%.lua");
+        REQUIRE(checking.create(
+            "task:add_args({string.leaked or 'clean'})\n"
+            "task:add_args({table.insert and 'insert' or 'no insert'})\n"
+            "task:add_args({undefined or 'clean'})\n"
+            "task:add_args({('upper'):upper()})\n"
+            "register_task(task)\n"));
+
+        const VariablesMap config("lua-plugin-test");
+
+        WHEN("We run the scripts after each other") {
+            for(auto i = 0U; i < 3U; ++i) {
+                REQUIRE(luaPlugin(Task(), config, context,
+                                  polluting.getPath()) ==
+                        Tasks({Task({"polluting"})}));
+                REQUIRE(luaPlugin(Task(), config, context,
+                                  checking.getPath()) ==
+                        Tasks({Task({"clean", "insert", "clean", "UPPER"})}));
+            }
+        }
+    }
+
+    GIVEN("A script and a chunk cache file") {
+        FleetingOptionsStub options;
+        SettingsNode settings("lua-plugin-test");
+        PatternsHandler patterns;
+        Plugins plugins;
+        const ExecutionContext context(options, settings, patterns, plugins);
+
+        TmpFile script("cached-%%%%.lua");
+        REQUIRE(script.create("task:add_args({'first'})\n"
+                              "register_task(task)\n"));
+        TmpFile cacheFile("cached-%%%%.luac");
+
+        const VariablesMap config("lua-plugin-test");
+
+        // Runs another version of the script, so that the next run of the
+        // script reads its chunk from the chunk cache file again
+        const auto forgetChunk = [&]() {
+            const auto content = readFile(script.getPath());
+            REQUIRE(script.create("register_task(task)\n"));
+            REQUIRE(luaPlugin(Task(), config, context, script.getPath()) ==
+                    Tasks({Task()}));
+            REQUIRE(script.create(content));
+        };
+
+        WHEN("We run the script") {
+            const auto actualTasks =
+                luaPlugin(Task(), config, context, script.getPath(),
+                          cacheFile.getPath());
+
+            THEN("It must run the script") {
+                REQUIRE(actualTasks == Tasks({Task({"first"})}));
+            }
+
+            THEN("It must cache the compiled script") {
+                REQUIRE(cacheFile.exists());
+            }
+        }
+
+        WHEN("We change the script after running it") {
+            REQUIRE(luaPlugin(Task(), config, context, script.getPath(),
+                              cacheFile.getPath()) ==
+                    Tasks({Task({"first"})}));
+            const auto cached = readFile(cacheFile.getPath());
+
+            REQUIRE(script.create("task:add_args({'second', 'run'})\n"
+                                  "register_task(task)\n"));
+
+            THEN("It must run the changed script") {
+                REQUIRE(luaPlugin(Task(), config, context, script.getPath(),
+                                  cacheFile.getPath()) ==
+                        Tasks({Task({"second", "run"})}));
+                REQUIRE(readFile(cacheFile.getPath()) != cached);
+            }
+        }
+
+        WHEN("The chunk cache file is corrupt") {
+            REQUIRE(cacheFile.create("corrupt"));
+
+            THEN("It must compile the script again") {
+                REQUIRE(luaPlugin(Task(), config, context, script.getPath(),
+                                  cacheFile.getPath()) ==
+                        Tasks({Task({"first"})}));
+                REQUIRE(readFile(cacheFile.getPath()) != "corrupt");
+            }
+        }
+
+        WHEN("The compiled chunk in the chunk cache file is garbage") {
+            REQUIRE(luaPlugin(Task(), config, context, script.getPath(),
+                              cacheFile.getPath()) ==
+                    Tasks({Task({"first"})}));
+
+            // Keep the header, so the garbage is taken for the compiled chunk
+            auto cached = readFile(cacheFile.getPath());
+            auto chunk = cached.find('\n');
+            for(auto i = 0U; i < 2U; ++i) {
+                chunk = cached.find('\n', chunk + 1U);
+            }
+            REQUIRE(chunk != string::npos);
+            cached.replace(chunk + 1U, string::npos,
+                           cached.size() - chunk - 1U, 'x');
+            forgetChunk();
+            REQUIRE(cacheFile.create(cached));
+
+            THEN("It must compile the script again") {
+                REQUIRE(luaPlugin(Task(), config, context, script.getPath(),
+                                  cacheFile.getPath()) ==
+                        Tasks({Task({"first"})}));
+                REQUIRE(readFile(cacheFile.getPath()) != cached);
+            }
+        }
+
+        WHEN("A bit of the compiled chunk in the chunk cache file is flipped") {
+            REQUIRE(luaPlugin(Task(), config, context, script.getPath(),
+                              cacheFile.getPath()) ==
+                    Tasks({Task({"first"})}));
+
+            const auto compiled = readFile(cacheFile.getPath());
+            auto cached = compiled;
+            cached.back() = static_cast<char>(cached.back() ^ 0x1);
+            forgetChunk();
+            REQUIRE(cacheFile.create(cached));
+
+            THEN("It must compile the script again") {
+                REQUIRE(luaPlugin(Task(), config, context, script.getPath(),
+                                  cacheFile.getPath()) ==
+                        Tasks({Task({"first"})}));
+                REQUIRE(readFile(cacheFile.getPath()).back() ==
+                        compiled.back());
+            }
+        }
+
+        WHEN("We change the script without changing its size or modification "
+             "time") {
+            REQUIRE(luaPlugin(Task(), config, context, script.getPath(),
+                              cacheFile.getPath()) ==
+                    Tasks({Task({"first"})}));
+
+            const auto modified = filesystem::last_write_time(script.getPath());
+            REQUIRE(script.create("task:add_args({'third'})\n"
+                                  "register_task(task)\n"));
+            filesystem::last_write_time(script.getPath(), modified);
+
+            THEN("It must run the changed script") {
+                REQUIRE(luaPlugin(Task(), config, context, script.getPath(),
+                                  cacheFile.getPath()) ==
+                        Tasks({Task({"third"})}));
+            }
+        }
+
+        WHEN("We request the chunk cache file in a cache directory") {
+            const auto file = getLuaChunkCacheFile(
+                script.getPath(), script.getPath().parent_path());
+
+            THEN("It must be a chunk cache file in the cache directory") {
+                REQUIRE(file);
+                REQUIRE(file->parent_path() == script.getPath().parent_path());
+                REQUIRE(file->extension() == ".luac");
+            }
+        }
+    }
+
+    GIVEN("A script with a syntax error") {
+        FleetingOptionsStub options;
+        SettingsNode settings("lua-plugin-test");
+        PatternsHandler patterns;
+        Plugins plugins;
+        const ExecutionContext context(options, settings, patterns, plugins);
+
+        TmpFile script("syntax-error-%%%%.lua");
+        REQUIRE(script.create("this is not lua\n"));
+
+        WHEN("We run it multiple times") {
+            THEN("It must report the script every time") {
+                for(auto i = 0U; i < 2U; ++i) {
+                    try {
+                        (void)luaPlugin(Task(), VariablesMap("test"), context,
+                                        script.getPath());
+                        FAIL("Running the script must fail");
+                    } catch(const runtime_error& e) {
+                        REQUIRE(string(e.what()).starts_with(
+                            "Syntax error detected in lua file '" +
+                            script.toString() + "': "));
+                    }
+                }
+            }
+        }
+    }
+}
+} // namespace execHelper::plugins::test
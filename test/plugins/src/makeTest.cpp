@@ -6,7 +6,6 @@
 #include "config/pattern.h"
 #include "config/patternsHandler.h"
 #include "config/variablesMap.h"
-#include "plugins/luaPlugin.h"
 
 #include "unittest/catch.h"
 #include "unittest/config.h"
@@ -88,12 +87,12 @@ SCENARIO("Testing the configuration settings of the make plugin", "[make]") {
         }
 
         THEN_WHEN("We apply the plugin") {
-            auto actualTasks =
-                luaPlugin(task, config, context,
-                          std::string(PLUGINS_INSTALL_PATH) + "/make.lua");
+            for(const auto& plugin : getImplementations("make")) {
+                auto actualTasks = plugin(task, config, context);
 
-            THEN_CHECK("It generated the expected tasks") {
-                REQUIRE(Tasks({expectedTask}) == actualTasks);
+                THEN_CHECK("It generated the expected tasks") {
+                    REQUIRE(Tasks({expectedTask}) == actualTasks);
+                }
             }
         }
     });
@@ -10,7 +10,6 @@
 #include "config/variablesMap.h"
 #include "core/task.h"
 #include "plugins/executionContext.h"
-#include "plugins/luaPlugin.h"
 
 #include "unittest/catch.h"
 #include "unittest/config.h"
@@ -244,12 +243,12 @@ SCENARIO("Testing the configuration settings of the meson plugin",
             }
 
             THEN_WHEN("We apply the plugin") {
-                auto actualTasks =
-                    luaPlugin(task, config, context,
-                              std::string(PLUGINS_INSTALL_PATH) + "/meson.lua");
+                for(const auto& plugin : getImplementations("meson")) {
+                    auto actualTasks = plugin(task, config, context);
 
-                THEN_CHECK("It generated the expected tasks") {
-                    REQUIRE(actualTasks == Tasks({expectedTask}));
+                    THEN_CHECK("It generated the expected tasks") {
+                        REQUIRE(actualTasks == Tasks({expectedTask}));
+                    }
                 }
             }
         });
@@ -273,10 +272,10 @@ SCENARIO("Pass an invalid mode to the meson plugin", "[meson][error]") {
 
         THEN_WHEN("We call the meson plugin with this configuration") {
             THEN_CHECK("It throws a runtime error") {
-                REQUIRE_THROWS_AS(
-                    luaPlugin(task, config, context,
-                              std::string(PLUGINS_INSTALL_PATH) + "/meson.lua"),
-                    runtime_error);
+                for(const auto& plugin : getImplementations("meson")) {
+                    REQUIRE_THROWS_AS(plugin(task, config, context),
+                                      runtime_error);
+                }
             }
         }
     });
@@ -9,7 +9,6 @@
 #include "config/variablesMap.h"
 #include "core/task.h"
 #include "fleetingOptionsStub.h"
-#include "plugins/luaPlugin.h"
 
 #include "unittest/catch.h"
 #include "unittest/config.h"
@@ -88,12 +87,12 @@ SCENARIO("Testing the configuration settings of the ninja plugin", "[ninja]") {
         }
 
         THEN_WHEN("We apply the plugin") {
-            auto actualTasks =
-                luaPlugin(task, config, context,
-                          std::string(PLUGINS_INSTALL_PATH) + "/ninja.lua");
+            for(const auto& plugin : getImplementations("ninja")) {
+                auto actualTasks = plugin(task, config, context);
 
-            THEN_CHECK("It called the right commands") {
-                REQUIRE(actualTasks == Tasks({expectedTask}));
+                THEN_CHECK("It called the right commands") {
+                    REQUIRE(actualTasks == Tasks({expectedTask}));
+                }
             }
         }
     });
@@ -0,0 +1,167 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "plugins/luaPlugin.h"
+#include "plugins/pluginIndex.h"
+#include "plugins/pluginUtils.h"
+#include "plugins/sharedLibraryPlugin.h"
+
+#include "base-utils/tmpFile.h"
+#include "unittest/catch.h"
+
+using std::string;
+
+using execHelper::test::baseUtils::TmpFile;
+
+namespace filesystem = std::filesystem;
+
+namespace execHelper::plugins::test {
+SCENARIO("Index the plugins of a plugin search directory",
+         "[plugins][plugin-index]") {
+    GIVEN("A plugin search directory and a cache directory") {
+        TmpFile searchDirectory;
+        REQUIRE(filesystem::create_directories(searchDirectory.getPath()));
+        TmpFile cacheDirectory;
+        REQUIRE(filesystem::create_directories(cacheDirectory.getPath()));
+
+        const auto directory = searchDirectory.getPath();
+        TmpFile first((directory / "first.lua").string());
+        REQUIRE(first.create("register_task(task)\n"));
+        TmpFile second((directory / "second.lua").string());
+        REQUIRE(second.create("register_task(task)\n"));
+        TmpFile other((directory / "other.txt").string());
+        REQUIRE(other.create());
+
+        const auto indexFile =
+            getPluginIndexFile(directory, cacheDirectory.getPath());
+        REQUIRE(indexFile);
+        const string version("1.0.0");
+
+        WHEN("We get the plugins of the directory") {
+            const auto plugins =
+                getPlugins(directory, cacheDirectory.getPath(), version);
+
+            THEN("We must find the lua plugins") {
+                REQUIRE(plugins == scanPluginDirectory(directory));
+                REQUIRE(plugins.size() == 2U);
+                REQUIRE(plugins[0].name == "first");
+                REQUIRE(plugins[0].path == first.getPath());
+                REQUIRE(plugins[0].summary ==
+                        luaPluginSummary(first.getPath()));
+                REQUIRE(plugins[1].name == "second");
+            }
+
+            THEN("The index of the directory must be written") {
+                REQUIRE(readPluginIndex(*indexFile, directory, version) ==
+                        plugins);
+            }
+
+            THEN("The index must not be used by another version") {
+                REQUIRE_FALSE(readPluginIndex(*indexFile, directory, "2.0.0"));
+            }
+        }
+
+        WHEN("The directory did not change since it was indexed") {
+            auto index = scanPluginDirectory(directory);
+            index[0].summary = "Summary from the index";
+            REQUIRE(writePluginIndex(*indexFile, directory, index, version));
+
+            THEN("The plugins must be taken from the index") {
+                const auto plugins =
+                    getPlugins(directory, cacheDirectory.getPath(), version);
+                REQUIRE(plugins == index);
+
+                const auto summaries = discoverPluginSummaries(
+                    {directory}, cacheDirectory.getPath(), version);
+                REQUIRE(summaries.at("first") == "Summary from the index");
+                REQUIRE(summaries.contains("command-line-command"));
+            }
+        }
+
+        WHEN("A plugin is added after the directory was indexed") {
+            REQUIRE(getPlugins(directory, cacheDirectory.getPath(), version)
+                        .size() == 2U);
+
+            TmpFile third((directory / "third.lua").string());
+            REQUIRE(third.create("register_task(task)\n"));
+
+            THEN("The index must be stale") {
+                REQUIRE_FALSE(readPluginIndex(*indexFile, directory, version));
+            }
+
+            THEN("The added plugin must be found") {
+                const auto plugins =
+                    getPlugins(directory, cacheDirectory.getPath(), version);
+                REQUIRE(plugins.size() == 3U);
+                REQUIRE(plugins[2].name == "third");
+
+                const auto discovered = discoverPlugins(
+                    {directory}, cacheDirectory.getPath(), version);
+                REQUIRE(discovered.contains("third"));
+            }
+        }
+
+        WHEN("A plugin is changed in place after the directory was indexed") {
+            REQUIRE(getPlugins(directory, cacheDirectory.getPath(), version)
+                        .size() == 2U);
+
+            // Changing a file in place does not change its directory
+            const auto directoryModified =
+                filesystem::last_write_time(directory);
+            filesystem::last_write_time(
+                first.getPath(),
+                filesystem::last_write_time(first.getPath()) +
+                    std::chrono::seconds(1));
+            filesystem::last_write_time(directory, directoryModified);
+
+            THEN("The index must be stale") {
+                REQUIRE_FALSE(readPluginIndex(*indexFile, directory, version));
+            }
+        }
+
+        WHEN("The summary of a shared library plugin is changed in place") {
+            auto library = directory / "library";
+            library.replace_extension(SHARED_LIBRARY_PLUGIN_EXTENSION);
+            auto summary = library;
+            summary.replace_extension(SHARED_LIBRARY_PLUGIN_SUMMARY_EXTENSION);
+
+            TmpFile libraryFile(library.string());
+            REQUIRE(libraryFile.create());
+            TmpFile summaryFile(summary.string());
+            REQUIRE(summaryFile.create("Old summary\n"));
+            REQUIRE(getPlugins(directory, cacheDirectory.getPath(), version)
+                        .size() == 3U);
+
+            const auto directoryModified =
+                filesystem::last_write_time(directory);
+            REQUIRE(summaryFile.create("New summary\n"));
+            filesystem::last_write_time(
+                summaryFile.getPath(),
+                filesystem::last_write_time(summaryFile.getPath()) +
+                    std::chrono::seconds(1));
+            filesystem::last_write_time(directory, directoryModified);
+
+            THEN("The new summary must be found") {
+                const auto summaries = discoverPluginSummaries(
+                    {directory}, cacheDirectory.getPath(), version);
+                REQUIRE(summaries.at("library") == "New summary");
+            }
+        }
+
+        WHEN("The index is corrupt") {
+            std::ofstream(*indexFile) << "EHPI 1 " << version << "\ncorrupt";
+
+            THEN("It must not be used") {
+                REQUIRE_FALSE(readPluginIndex(*indexFile, directory, version));
+                REQUIRE(getPlugins(directory, cacheDirectory.getPath(),
+                                   version) == scanPluginDirectory(directory));
+            }
+        }
+
+        filesystem::remove_all(cacheDirectory.getPath());
+        filesystem::remove_all(directory);
+    }
+}
+} // namespace execHelper::plugins::test
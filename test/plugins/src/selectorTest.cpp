@@ -12,7 +12,6 @@
 #include "config/variablesMap.h"
 #include "core/task.h"
 #include "plugins/logger.h"
-#include "plugins/luaPlugin.h"
 
 #include "base-utils/nonEmptyString.h"
 #include "config/generators.h"
@@ -51,12 +50,6 @@ using execHelper::test::propertyTest;
 
 namespace filesystem = std::filesystem;
 
-namespace {
-auto scriptPath() noexcept -> std::string {
-    return string(PLUGINS_INSTALL_PATH) + "/selector.lua";
-}
-} // namespace
-
 namespace execHelper::plugins::test {
 SCENARIO("Testing the configuration settings of the selector plugin",
          "[selector]") {
@@ -91,10 +84,12 @@ SCENARIO("Testing the configuration settings of the selector plugin",
         Tasks expectedTasks(pattern.getValues().size(), task);
 
         THEN_WHEN("We apply the plugin") {
-            auto actualTasks = luaPlugin(task, config, context, scriptPath());
+            for(const auto& plugin : getImplementations("selector")) {
+                auto actualTasks = plugin(task, config, context);
 
-            THEN_CHECK("It called the right commands") {
-                REQUIRE(actualTasks == expectedTasks);
+                THEN_CHECK("It called the right commands") {
+                    REQUIRE(actualTasks == expectedTasks);
+                }
             }
         }
     });
@@ -111,10 +106,11 @@ SCENARIO("Unconfigured target in selector", "[selector]") {
 
         WHEN("We call the plugin") {
             THEN("It should throw a runtime error") {
-                REQUIRE_THROWS_AS(luaPlugin(Task(),
-                                            VariablesMap("selector-test"),
-                                            context, scriptPath()),
-                                  runtime_error);
+                for(const auto& plugin : getImplementations("selector")) {
+                    REQUIRE_THROWS_AS(
+                        plugin(Task(), VariablesMap("selector-test"), context),
+                        runtime_error);
+                }
             }
         }
     }
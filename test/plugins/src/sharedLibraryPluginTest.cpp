@@ -0,0 +1,234 @@
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "config/pattern.h"
+#include "config/patternsHandler.h"
+#include "config/settingsNode.h"
+#include "config/variablesMap.h"
+#include "core/task.h"
+#include "plugins/executionContext.h"
+#include "plugins/pluginAbi.h"
+#include "plugins/pluginIndex.h"
+#include "plugins/pluginUtils.h"
+#include "plugins/sharedLibraryPlugin.h"
+
+#include "base-utils/tmpFile.h"
+#include "unittest/catch.h"
+
+#include "fleetingOptionsStub.h"
+#include "handlers.h"
+
+using std::runtime_error;
+using std::string;
+using std::vector;
+
+using execHelper::config::Pattern;
+using execHelper::config::PatternsHandler;
+using execHelper::config::SettingsNode;
+using execHelper::config::VariablesMap;
+using execHelper::core::Task;
+using execHelper::core::Tasks;
+
+using execHelper::test::FleetingOptionsStub;
+using execHelper::test::baseUtils::TmpFile;
+
+namespace filesystem = std::filesystem;
+
+namespace {
+/**
+ * Registers the given task with the configured arguments, a copy of it in
+ * another directory and the configured targets, or fails if configured to
+ */
+auto applyTestPlugin(const exec_helper_host* host,
+                     exec_helper_invocation* invocation) -> int {
+    const char* const failKey[] = {"fail"};
+    size_t count = 0U;
+    if(host->get_values(invocation, failKey, 1U, &count) != nullptr) {
+        host->error(invocation, "Test plugin failed");
+        return 1;
+    }
+
+    const char* const argsKey[] = {"args"};
+    const auto* args = host->get_values(invocation, argsKey, 1U, &count);
+    for(size_t i = 0U; args != nullptr && i < count; ++i) {
+        host->append(invocation, EXEC_HELPER_PLUGIN_TASK, args[i]);
+    }
+    if(host->verbose(invocation) != 0) {
+        host->append(invocation, EXEC_HELPER_PLUGIN_TASK, "--verbose");
+    }
+    host->append(invocation, EXEC_HELPER_PLUGIN_TASK,
+                 std::to_string(host->jobs(invocation)).c_str());
+
+    const auto copy = host->copy_task(invocation, EXEC_HELPER_PLUGIN_TASK);
+    host->append(invocation, copy, "copy");
+    host->set_working_directory(invocation, copy, "/copy");
+    host->set_environment(invocation, copy, "COPY", "yes");
+
+    host->register_task(invocation, EXEC_HELPER_PLUGIN_TASK);
+    host->register_task(invocation, copy);
+
+    const char* const targetsKey[] = {"targets"};
+    const auto* targets = host->get_values(invocation, targetsKey, 1U, &count);
+    if(targets != nullptr &&
+       host->run_targets(invocation, EXEC_HELPER_PLUGIN_TASK, targets, count) !=
+           0) {
+        return 1;
+    }
+    return host->copy_task(invocation, copy + 1U) == EXEC_HELPER_INVALID_TASK
+               ? 0
+               : 1;
+}
+
+const exec_helper_plugin TEST_PLUGIN{EXEC_HELPER_PLUGIN_ABI_VERSION,
+                                     &applyTestPlugin};
+} // namespace
+
+namespace execHelper::plugins::test {
+SCENARIO("Apply a plugin through the shared library plugin interface",
+         "[shared-library-plugin]") {
+    GIVEN("A plugin that uses every function of the interface") {
+        FleetingOptionsStub options;
+        options.m_verbose = false;
+        options.m_jobs = 3U;
+        SettingsNode settings("shared-library-plugin-test");
+        PatternsHandler patterns;
+        const Plugins plugins = mapToMemories({"first", "second"});
+        const ExecutionContext context(options, settings, patterns, plugins);
+
+        VariablesMap config("shared-library-plugin-test");
+        REQUIRE(config.add("args", vector<string>({"arg1", "arg2"})));
+        REQUIRE(config.add("working-dir", "/base"));
+
+        Task expectedTask({"base", "arg1", "arg2", "3"});
+        expectedTask.setWorkingDirectory("/base");
+        Task expectedCopy(expectedTask);
+        expectedCopy.append("copy");
+        expectedCopy.setWorkingDirectory("/copy");
+        expectedCopy.appendToEnvironment(std::make_pair("COPY", "yes"));
+
+        WHEN("We apply the plugin") {
+            const auto actualTasks = applySharedLibraryPlugin(
+                TEST_PLUGIN, Task({"base"}), config, context);
+
+            THEN("It must register the tasks of the plugin") {
+                REQUIRE(actualTasks == Tasks({expectedTask, expectedCopy}));
+            }
+        }
+
+        WHEN("We apply the plugin with verbosity and targets") {
+            REQUIRE(config.add("verbose", "yes"));
+            REQUIRE(config.add("targets", vector<string>({"first", "{X}"})));
+
+            Task task({"base"});
+            task.addPatterns({Pattern("X", {"first", "second"})});
+
+            const auto actualTasks =
+                applySharedLibraryPlugin(TEST_PLUGIN, task, config, context);
+
+            THEN("It must register the resolved targets as well") {
+                REQUIRE(actualTasks.size() == 6U);
+                REQUIRE(actualTasks[0].getTask() ==
+                        vector<string>({"base", "arg1", "arg2", "--verbose",
+                                        "3"}));
+            }
+        }
+
+        WHEN("The plugin fails") {
+            REQUIRE(config.add("fail", "yes"));
+
+            THEN("It must report the error of the plugin") {
+                REQUIRE_THROWS_WITH(applySharedLibraryPlugin(
+                                        TEST_PLUGIN, Task(), config, context),
+                                    "Test plugin failed");
+            }
+        }
+    }
+
+    GIVEN("A file with the extension of a shared library that is none") {
+        TmpFile directory;
+        REQUIRE(filesystem::create_directories(directory.getPath()));
+
+        const auto library =
+            directory.getPath() /
+            ("broken" + string(SHARED_LIBRARY_PLUGIN_EXTENSION));
+        TmpFile broken(library.string());
+        REQUIRE(broken.create("not a shared library"));
+
+        THEN("It must not load") {
+            REQUIRE_THROWS_AS(loadSharedLibraryPlugin(library), runtime_error);
+        }
+
+        THEN("It must be discovered without loading it") {
+            const auto index = scanPluginDirectory(directory.getPath());
+            REQUIRE(index.size() == 1U);
+            REQUIRE(index.front().name == "broken");
+            REQUIRE(index.front().summary ==
+                    "Shared library plugin for module broken");
+        }
+
+        THEN("It must fail when it is applied") {
+            FleetingOptionsStub options;
+            SettingsNode settings("shared-library-plugin-test");
+            PatternsHandler patterns;
+            const auto plugins = discoverPlugins({directory.getPath()});
+            const ExecutionContext context(options, settings, patterns,
+                                           plugins);
+
+            REQUIRE(plugins.count("broken") == 1U);
+            REQUIRE_THROWS_AS(plugins.at("broken")(
+                                  Task(), VariablesMap("broken"), context),
+                              runtime_error);
+        }
+
+        filesystem::remove_all(directory.getPath());
+    }
+
+    GIVEN("A plugin search path with a shared library plugin and its summary") {
+        TmpFile directory;
+        REQUIRE(filesystem::create_directories(directory.getPath()));
+
+        const auto library =
+            directory.getPath() /
+            ("test-plugin" + string(SHARED_LIBRARY_PLUGIN_EXTENSION));
+        filesystem::copy_file(SHARED_LIBRARY_TEST_PLUGIN, library);
+        TmpFile summary(
+            (directory.getPath() /
+             ("test-plugin" + string(SHARED_LIBRARY_PLUGIN_SUMMARY_EXTENSION)))
+                .string());
+        REQUIRE(summary.create("Test plugin library\n"));
+
+        WHEN("We discover the summaries of the plugins") {
+            const auto summaries =
+                discoverPluginSummaries({directory.getPath()});
+
+            THEN("It must contain the summary of the library") {
+                REQUIRE(summaries.at("test-plugin") == "Test plugin library");
+            }
+        }
+
+        WHEN("We discover the plugins and apply the library") {
+            FleetingOptionsStub options;
+            SettingsNode settings("shared-library-plugin-test");
+            PatternsHandler patterns;
+            const auto plugins = discoverPlugins({directory.getPath()});
+            const ExecutionContext context(options, settings, patterns,
+                                           plugins);
+
+            VariablesMap config("test-plugin");
+            REQUIRE(config.add("args", "arg1"));
+
+            THEN("It must register the tasks of the library") {
+                REQUIRE(plugins.count("test-plugin") == 1U);
+                REQUIRE(plugins.at("test-plugin")(Task({"base"}), config,
+                                                  context) ==
+                        Tasks({Task({"base", "arg1", "library"})}));
+            }
+        }
+
+        filesystem::remove_all(directory.getPath());
+    }
+}
+} // namespace execHelper::plugins::test
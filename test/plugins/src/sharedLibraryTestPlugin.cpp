@@ -0,0 +1,35 @@
+#include <cstddef>
+
+#include "plugins/pluginAbi.h"
+
+#ifdef _WIN32
+#define EXPORT __declspec(dllexport)
+#else
+#define EXPORT
+#endif
+
+/*
+ * The shared library plugin the tests discover and apply. It registers its
+ * task with the configured arguments and 'library' appended.
+ */
+namespace {
+auto apply(const exec_helper_host* host, exec_helper_invocation* invocation)
+    -> int {
+    const char* const argsKey[] = {"args"};
+    size_t count = 0U;
+    const auto* args = host->get_values(invocation, argsKey, 1U, &count);
+    for(size_t i = 0U; args != nullptr && i < count; ++i) {
+        host->append(invocation, EXEC_HELPER_PLUGIN_TASK, args[i]);
+    }
+    host->append(invocation, EXEC_HELPER_PLUGIN_TASK, "library");
+    return host->register_task(invocation, EXEC_HELPER_PLUGIN_TASK);
+}
+
+const exec_helper_plugin PLUGIN{EXEC_HELPER_PLUGIN_ABI_VERSION, &apply};
+} // namespace
+
+extern "C" {
+EXPORT auto exec_helper_get_plugin() -> const exec_helper_plugin* {
+    return &PLUGIN;
+}
+}
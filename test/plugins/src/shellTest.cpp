@@ -9,7 +9,6 @@
 #include "config/variablesMap.h"
 #include "core/task.h"
 #include "plugins/executionContext.h"
-#include "plugins/luaPlugin.h"
 
 #include "core/coreGenerators.h"
 #include "unittest/catch.h"
@@ -107,12 +106,12 @@ SCENARIO("Testing the configuration settings of the shell plugins",
         }
 
         THEN_WHEN("We apply the plugin") {
-            auto actualTasks = luaPlugin(task, config, context,
-                                         std::string(PLUGINS_INSTALL_PATH) +
-                                             "/" + shellName + ".lua");
+            for(const auto& plugin : getImplementations(shellName)) {
+                auto actualTasks = plugin(task, config, context);
 
-            THEN_CHECK("It generated the expected tasks") {
-                REQUIRE(actualTasks == Tasks({expectedTask}));
+                THEN_CHECK("It generated the expected tasks") {
+                    REQUIRE(actualTasks == Tasks({expectedTask}));
+                }
             }
         }
     });
@@ -132,10 +131,10 @@ SCENARIO("Pass no command to the shell plugin", "[shell][error]") {
 
         THEN_WHEN("We call the shell plugin with this configuration") {
             THEN_CHECK("It throws a runtime error") {
-                REQUIRE_THROWS_AS(luaPlugin(task, config, context,
-                                            std::string(PLUGINS_INSTALL_PATH) +
-                                                "/" + shellName + ".lua"),
-                                  runtime_error);
+                for(const auto& plugin : getImplementations(shellName)) {
+                    REQUIRE_THROWS_AS(plugin(task, config, context),
+                                      runtime_error);
+                }
             }
         }
     });
@@ -26,6 +26,11 @@ class FleetingOptionsStub : public config::FleetingOptionsInterface {
         return m_keepGoing;
     }
 
+    [[nodiscard]] auto getPosixSpawn() const noexcept
+        -> config::PosixSpawnOption_t override {
+        return m_posixSpawn;
+    }
+
     auto getLogLevel() const noexcept -> log::LogLevel override {
         return m_logLevel;
     }
@@ -51,17 +56,36 @@ class FleetingOptionsStub : public config::FleetingOptionsInterface {
         return m_autocomplete;
     }
 
+    [[nodiscard]] auto getShard() const noexcept
+        -> const std::optional<config::ShardOption_t>& override {
+        return m_shard;
+    }
+
+    [[nodiscard]] auto getShardDurations() const noexcept
+        -> const std::optional<config::ShardDurationsOption_t>& override {
+        return m_shardDurations;
+    }
+
+    [[nodiscard]] auto getShardDurationsOut() const noexcept
+        -> const std::optional<config::ShardDurationsOutOption_t>& override {
+        return m_shardDurationsOut;
+    }
+
     config::HelpOption_t m_help = {false};
     config::VersionOption_t m_version = {false};
     config::VerboseOption_t m_verbose = {true};
     config::DryRunOption_t m_dryRun = {false};
     config::KeepGoingOption_t m_keepGoing = {false};
+    config::PosixSpawnOption_t m_posixSpawn = {false};
     log::LogLevel m_logLevel = {log::warning};
     config::Jobs_t m_jobs = 1024U;
     config::ListPluginsOption_t m_listPlugins = {false};
     config::Paths m_appendSearchPaths = {};
     config::CommandCollection m_commands = {};
     std::optional<config::AutoCompleteOption_t> m_autocomplete;
+    std::optional<config::ShardOption_t> m_shard;
+    std::optional<config::ShardDurationsOption_t> m_shardDurations;
+    std::optional<config::ShardDurationsOutOption_t> m_shardDurationsOut;
 };
 } // namespace execHelper::test
 
@@ -1,6 +1,7 @@
 #ifndef __EXECUTOR_STUB_H__
 #define __EXECUTOR_STUB_H__
 
+#include <mutex>
 #include <vector>
 
 #include "core/shell.h"
@@ -21,6 +22,7 @@ class ShellStub final : public Shell {
     }
 
     ShellReturnCode execute(const Task& task) const noexcept override {
+        std::lock_guard<std::mutex> lock(m_mutex);
         m_executedTasks.push_back(task);
         return m_returnCode;
     }
@@ -35,6 +37,7 @@ class ShellStub final : public Shell {
     }
 
   private:
+    mutable std::mutex m_mutex;
     mutable TaskQueue m_executedTasks;
     ShellReturnCode m_returnCode;
 };
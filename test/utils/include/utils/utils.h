@@ -112,7 +112,7 @@ config::PatternCombinations
 createPatternCombination(const config::PatternKeys& keys,
                          const config::PatternValues& values) noexcept;
 plugins::PatternPermutator
-makePatternPermutator(const config::Patterns& patterns) noexcept;
+makePatternPermutator(const config::Patterns& patterns);
 core::test::ExecutorStub::TaskQueue
 getExpectedTasks(const core::Task& task,
                  const config::Patterns patterns) noexcept;
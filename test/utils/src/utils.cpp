@@ -16,7 +16,6 @@
 using std::endl;
 using std::initializer_list;
 using std::make_shared;
-using std::map;
 using std::pair;
 using std::reference_wrapper;
 using std::shared_ptr;
@@ -262,18 +261,8 @@ createPatternCombination(const PatternKeys& keys,
     return combination;
 }
 
-PatternPermutator makePatternPermutator(const Patterns& patterns) noexcept {
-    map<PatternKey, PatternValues> patternValuesMatrix;
-    if(patterns.empty()) {
-        patternValuesMatrix.emplace(
-            make_pair(string("BLAATBLAATBLAATBLAAT"), vector<string>({"b"})));
-    } else {
-        for(const auto& pattern : patterns) {
-            patternValuesMatrix.emplace(
-                make_pair(pattern.getKey(), pattern.getValues()));
-        }
-    }
-    return PatternPermutator(patternValuesMatrix);
+PatternPermutator makePatternPermutator(const Patterns& patterns) {
+    return PatternPermutator(patterns);
 }
 
 ExecutorStub::TaskQueue getExpectedTasks(const Task& task,